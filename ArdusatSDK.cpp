@@ -9,20 +9,30 @@
  * consistent interface to interact with each type of sensor.
  */
 
-#include <stdio.h>
+#include <limits.h>
 #include <string.h>
 #include "ArdusatSDK.h"
+#include <utility/crc.h>
+#include <utility/dataready.h>
+#include <utility/format.h>
 
 boolean MANUAL_CONFIG = false;
-boolean ARDUSAT_SPACEBOARD = false;
-int OUTPUT_BUF_SIZE = 256;
+boolean ARDUSAT_SPACEBOARD = (ARDUSAT_BOARD == ARDUSAT_BOARD_SPACEBOARD);
+#if ARDUSAT_STATIC_BUFFERS
+const int OUTPUT_BUF_SIZE = ARDUSAT_OUTPUT_BUF_SIZE;
+// + 1 so there is always room for the null terminator
+static char _output_buffer_storage[ARDUSAT_OUTPUT_BUF_SIZE + 1];
+char * _output_buffer = _output_buffer_storage;
+#else
+int OUTPUT_BUF_SIZE = ARDUSAT_OUTPUT_BUF_SIZE;
 char * _output_buffer;
+#endif
 static int _output_buf_len = 0;
 
 // TODO: Change these error messages to be JSON that can easily be caught by the Experiment Platform
-const char concat_string[] PROGMEM = "%s%s";
 const char begin_error_msg[] PROGMEM = "begin %s failed. Check wiring!";
 const char unavailable_on_hardware_error_msg[] PROGMEM = "%s is not available with %s";
+const char output_full_error_msg[] PROGMEM = "%s record doesn't fit in the output buffer, use writeJSON()";
 
 const char spacekit_hardware_name[] PROGMEM = "Space Kit";
 const char spaceboard_hardware_name[] PROGMEM = "SpaceBoard";
@@ -32,19 +42,82 @@ const char gyro_sensor_name[] PROGMEM = "Gyro";
 const char luminosity_sensor_name[] PROGMEM = "Luminosity";
 const char magnetic_sensor_name[] PROGMEM = "Magnetic";
 const char orientation_sensor_name[] PROGMEM = "Orientation";
+const char fused_orientation_sensor_name[] PROGMEM = "FusedOrientation";
 const char pressure_sensor_name[] PROGMEM = "BarometricPressure";
 const char temperature_sensor_name[] PROGMEM = "Temperature";
 const char irtemperature_sensor_name[] PROGMEM = "IRTemperature";
 const char rgblight_sensor_name[] PROGMEM = "RGBLight";
 const char uvlight_sensor_name[] PROGMEM = "UVLight";
+const char stats_sensor_name[] PROGMEM = "SensorStats";
 
 const char CSV_TIMESTAMP[] PROGMEM = "timestamp(seconds)";
 const char CSV_CHECKSUM[] PROGMEM = "checksum";
 
-static char CSV_SEPARATOR = ',';
-static char JSON_PREFIX = '~';
-static char JSON_SUFFIX = '|';
-const char json_format[] PROGMEM = "%c{\"sensorName\":\"%s\",\"unit\":\"%s\",\"value\":%s,\"cs\":%d}%c\n";
+static const char CSV_SEPARATOR = ',';
+static const char JSON_PREFIX = '~';
+static const char JSON_SUFFIX = '|';
+const char json_sensor_name[] PROGMEM = "{\"sensorName\":\"";
+const char json_unit[] PROGMEM = "\",\"unit\":\"";
+const char json_value[] PROGMEM = "\",\"value\":";
+const char json_checksum[] PROGMEM = ",\"cs\":";
+
+// Fixed part of a JSON record (the terminators count for the prefix, '}',
+// suffix and newline), plus room for the value and checksum
+#define JSON_RECORD_OVERHEAD (sizeof(json_sensor_name) + sizeof(json_unit) + sizeof(json_value) + \
+                              sizeof(json_checksum) + 10 + 5)
+
+const char json_label_x[] PROGMEM = "X";
+const char json_label_y[] PROGMEM = "Y";
+const char json_label_z[] PROGMEM = "Z";
+const char json_label_roll[] PROGMEM = "Roll";
+const char json_label_pitch[] PROGMEM = "Pitch";
+const char json_label_heading[] PROGMEM = "Heading";
+const char json_label_qw[] PROGMEM = "QW";
+const char json_label_qx[] PROGMEM = "QX";
+const char json_label_qy[] PROGMEM = "QY";
+const char json_label_qz[] PROGMEM = "QZ";
+const char json_label_red[] PROGMEM = "Red";
+const char json_label_green[] PROGMEM = "Green";
+const char json_label_blue[] PROGMEM = "Blue";
+const char json_label_count[] PROGMEM = "Count";
+const char json_label_mean[] PROGMEM = "Mean";
+const char json_label_min[] PROGMEM = "Min";
+const char json_label_max[] PROGMEM = "Max";
+const char json_label_stddev[] PROGMEM = "StdDev";
+
+const char unit_none[] PROGMEM = "";
+const char unit_meter_per_secondsquared[] PROGMEM = "m/s^2";
+const char unit_radian_per_second[] PROGMEM = "rad/s";
+const char unit_microtesla[] PROGMEM = "uT";
+const char unit_degrees_celsius[] PROGMEM = "C";
+const char unit_meter_per_second[] PROGMEM = "m/s";
+const char unit_lux[] PROGMEM = "lux";
+const char unit_milliwatt_per_cmsquared[] PROGMEM = "mW/cm^2";
+const char unit_degrees[] PROGMEM = "deg";
+const char unit_hectopascal[] PROGMEM = "hPa";
+
+/*
+ * Unit strings, indexed by data_unit_t
+ */
+const char * const unit_strings[] PROGMEM = {
+  unit_none,                     // DATA_UNIT_NONE
+  unit_meter_per_secondsquared,  // DATA_UNIT_METER_PER_SECONDSQUARED
+  unit_radian_per_second,        // DATA_UNIT_RADIAN_PER_SECOND
+  unit_microtesla,               // DATA_UNIT_MICROTESLA
+  unit_degrees_celsius,          // DATA_UNIT_DEGREES_CELSIUS
+  unit_none,                     // DATA_UNIT_DEGREES_FAHRENHEIT
+  unit_meter_per_second,         // DATA_UNIT_METER_PER_SECOND
+  unit_lux,                      // DATA_UNIT_LUX
+  unit_none,                     // DATA_UNIT_RADIAN
+  unit_milliwatt_per_cmsquared,  // DATA_UNIT_MILLIWATT_PER_CMSQUARED
+  unit_degrees,                  // DATA_UNIT_DEGREES
+  unit_hectopascal,              // DATA_UNIT_HECTOPASCAL
+};
+
+/*
+ * Longest unit string, "mW/cm^2", plus the null terminator
+ */
+#define UNIT_STR_MAX_LEN 8
 
 /*
  * Gets the output buffer used for storing sensor data, or initializes
@@ -53,9 +126,13 @@ const char json_format[] PROGMEM = "%c{\"sensorName\":\"%s\",\"unit\":\"%s\",\"v
  * @return the current output buffer
  */
 char * _getOutBuf() {
+#if !ARDUSAT_STATIC_BUFFERS
   if (_output_buffer == NULL) {
-    _output_buffer = new char[OUTPUT_BUF_SIZE];
+    // + 1 so there is always room for the null terminator
+    _output_buffer = new char[OUTPUT_BUF_SIZE + 1];
+    _output_buffer[0] = '\0';
   }
+#endif
   return _output_buffer;
 }
 
@@ -63,85 +140,176 @@ char * _getOutBuf() {
  * Resets the output buffer to be blank
  */
 void _resetOutBuf() {
-  memset(_getOutBuf(), 0, OUTPUT_BUF_SIZE);
+  _getOutBuf()[0] = '\0';
   _output_buf_len = 0;
 }
 
+/*
+ * Print that appends to the output buffer. The formatters that return the output
+ * buffer write through this, so they share their code with the OutputSink versions.
+ */
+class _OutputBufferPrint : public Print {
+  public:
+    size_t write(uint8_t c) {
+      char *buf = _getOutBuf();
+
+      if (_output_buf_len >= OUTPUT_BUF_SIZE) {
+        return 0;
+      }
+      buf[_output_buf_len++] = c;
+      buf[_output_buf_len] = '\0';
+      return 1;
+    }
+
+    using Print::write;
+};
+
+static _OutputBufferPrint _output_buffer_print;
+
+/*
+ * While a Sensor's write* function is running, formatters write straight into its
+ * sink instead of the output buffer
+ */
+static OutputSink * _output_sink = NULL;
+static size_t _output_sink_len = 0;
+
+/*
+ * Gets where formatted output currently goes
+ */
+static Print & _out() {
+  if (_output_sink != NULL) {
+    return *_output_sink;
+  }
+  return _output_buffer_print;
+}
+
+/*
+ * Gets how many more bytes the current output can take
+ */
+static int _outRoom() {
+  if (_output_sink != NULL) {
+    return INT_MAX;
+  }
+  return OUTPUT_BUF_SIZE - _output_buf_len;
+}
+
+/*
+ * Starts a new record in the output buffer, unless it is going to a sink
+ */
+static void _beginOutput() {
+  if (_output_sink == NULL) {
+    _resetOutBuf();
+  }
+}
+
+/*
+ * Finishes a text record
+ *
+ * @return the output buffer, or an empty string when writing to a sink
+ */
+static const char * _endOutput(size_t written) {
+  if (_output_sink != NULL) {
+    _output_sink_len += written;
+    return "";
+  }
+  return _getOutBuf();
+}
+
+/*
+ * Finishes a binary record
+ *
+ * @return the output buffer, or NULL when writing to a sink
+ */
+static const unsigned char * _endBinaryOutput(size_t written) {
+  if (_output_sink != NULL) {
+    _output_sink_len += written;
+    return NULL;
+  }
+  return (const unsigned char *) _getOutBuf();
+}
+
+/*
+ * Prints a string stored in PROGMEM
+ */
+static size_t _printP(Print &out, const char str[] PROGMEM) {
+  return out.print((const __FlashStringHelper *) str);
+}
+
+/**
+ * Convert an enumerated unit code to a string representation in PROGMEM.
+ *
+ * @param unit code (see data_unit_t)
+ *
+ * @return string representation of unit, in PROGMEM
+ */
+const char * unit_to_str_P(unsigned char unit) {
+  if (unit >= sizeof(unit_strings) / sizeof(unit_strings[0])) {
+    return unit_none;
+  }
+  return (const char *) pgm_read_ptr(&unit_strings[unit]);
+}
+
 /**
  * Convert an enumerated unit code to a string representation.
  *
- * @param unit code (see units.h defines)
+ * @param unit code (see data_unit_t)
  *
- * @return string representation of unit
+ * @return string representation of unit, valid until the next call
  */
 const char * unit_to_str(unsigned char unit) {
-  switch (unit) {
-    case (DATA_UNIT_NONE):
-      return "";
-    case (DATA_UNIT_METER_PER_SECONDSQUARED):
-      return "m/s^2";
-    case (DATA_UNIT_RADIAN_PER_SECOND):
-      return "rad/s";
-    case (DATA_UNIT_MICROTESLA):
-      return "uT";
-    case (DATA_UNIT_DEGREES_CELSIUS):
-      return "C";
-    case (DATA_UNIT_METER_PER_SECOND):
-      return "m/s";
-    case (DATA_UNIT_LUX):
-      return "lux";
-    case (DATA_UNIT_MILLIWATT_PER_CMSQUARED):
-      return "mW/cm^2";
-    case (DATA_UNIT_DEGREES):
-      return "deg";
-    case (DATA_UNIT_HECTOPASCAL):
-      return "hPa";
-    default:
-      return "";
-  };
+  static char str[UNIT_STR_MAX_LEN];
+
+  strncpy_P(str, unit_to_str_P(unit), sizeof(str) - 1);
+  return str;
+}
+
+/*
+ * Prints a PROGMEM message, replacing each "%s" in it with the next of up to two
+ * PROGMEM strings
+ */
+static size_t _printMessageP(Print &out, const char msg[] PROGMEM, const char arg1[] PROGMEM,
+                             const char arg2[] PROGMEM) {
+  size_t written = 0;
+  char c;
+
+  while ((c = pgm_read_byte(msg++)) != '\0') {
+    if (c == '%' && pgm_read_byte(msg) == 's') {
+      if (arg1 != NULL) {
+        written += _printP(out, arg1);
+      }
+      arg1 = arg2;
+      arg2 = NULL;
+      msg++;
+    } else {
+      written += out.write(c);
+    }
+  }
+
+  return written;
 }
 
 /*
- * Prints an error message that has exactly two "%s" format specifiers in error_msg
- * This relies on a 256 character output buffer. Make sure that sensorName isn't too long!
+ * Prints an error message that has exactly two "%s" format specifiers in error_msg.
+ * It goes straight to Serial, leaving the output buffer alone.
  *
  * @param error_msg the base error message
  * @param sensorName name of sensor that failed.
  * @param hardwareBuild empty string, space kit, or spaceboard
  */
 void _writeErrorMessage(const char error_msg[] PROGMEM, const char sensorName[] PROGMEM, const char hardwareBuild[] PROGMEM) {
-  char err_msg[30];
-  char sensor[50];
-  char hardware[15];
-
-  strcpy_P(err_msg, error_msg);
-  strcpy_P(sensor, sensorName);
-  strcpy_P(hardware, hardwareBuild);
-
-  // Make SURE sensorName isn't too long for the output buffer!!!
-  _resetOutBuf();
-  sprintf(_getOutBuf(), err_msg, sensor, hardware);
-  Serial.println(_getOutBuf());
+  _printMessageP(Serial, error_msg, sensorName, hardwareBuild);
+  Serial.println();
 }
 
 /*
  * Prints an error message that has exactly one "%s" format specifiers in error_msg
- * This relies on a 256 character output buffer. Make sure that sensorName isn't too long!
  *
  * @param error_msg the base error message
  * @param sensorName name of sensor that failed.
  */
 void _writeErrorMessage(const char error_msg[] PROGMEM, const char sensorName[] PROGMEM) {
-  char err_msg[30];
-  char sensor[50];
-
-  strcpy_P(err_msg, error_msg);
-  strcpy_P(sensor, sensorName);
-
-  // Make SURE sensorName isn't too long for the output buffer!!!
-  _resetOutBuf();
-  sprintf(_getOutBuf(), err_msg, sensor);
-  Serial.println(_getOutBuf());
+  _printMessageP(Serial, error_msg, sensorName, NULL);
+  Serial.println();
 }
 
 /*
@@ -179,63 +347,201 @@ int calculateCheckSum(const char *sensor_name, int num_vals, ...) {
   return cs;
 }
 
+static checksum_mode_t _checksum_mode = CHECKSUM_SUM;
+
 /**
- * Create a CSV string with a generic array of float values and a sensor name. Optional timestamp
- * argument allows passing in a timestamp; will use millis() otherwise.
- *
- * @param sensorName string sensor name
- * @param timestamp optional timestamp. If 0, millis() will be called.
- * @param numValues number of float values
- * @param variable float values
+ * Selects how the checksum at the end of each CSV and JSON record is calculated
  *
- * @return pointer to output buffer
+ * @param mode CHECKSUM_SUM (the default, used by experiments.ardusat.com),
+ *             CHECKSUM_CRC8 or CHECKSUM_CRC16
  */
-const char * valuesToCSV(const char *sensorName, unsigned long timestamp, int numValues, ...) {
-  int i, name_len;
-  va_list args;
+void setChecksumMode(checksum_mode_t mode) {
+  _checksum_mode = mode;
+}
+
+checksum_mode_t getChecksumMode() {
+  return _checksum_mode;
+}
+
+/*
+ * Sums the characters of a string for the CHECKSUM_SUM checksum
+ */
+static int _sumChars(const char *str) {
+  int cs = 0;
+
+  while (*str != 0) {
+    cs += *str++;
+  }
+  return cs;
+}
+
+static int _sumCharsP(const char str[] PROGMEM) {
+  int cs = 0;
+  char c;
+
+  while ((c = pgm_read_byte(str++)) != 0) {
+    cs += c;
+  }
+  return cs;
+}
+
+/*
+ * Print that passes everything through to the current output. In the CRC
+ * checksum modes it keeps a CRC of the bytes as they're written, so the record
+ * never has to be gone over a second time.
+ */
+class _ChecksumPrint : public Print {
+  public:
+    _ChecksumPrint(Print &out) :
+      _dest(out), _crc(_checksum_mode == CHECKSUM_CRC8 ? CRC8_INIT : CRC16_INIT)
+    {
+    }
+
+    size_t write(uint8_t c) {
+      size_t n = _dest.write(c);
+
+      if (n) {
+        _update(c);
+      }
+      return n;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) {
+      size_t n = _dest.write(buffer, size);
+
+      for (size_t i = 0; i < n; ++i) {
+        _update(buffer[i]);
+      }
+      return n;
+    }
+
+    using Print::write;
+
+    /*
+     * Prints the checksum of the mode in use. Not part of the CRC itself.
+     *
+     * @param sum the CHECKSUM_SUM value, unused in the CRC modes
+     */
+    size_t printChecksum(int sum) {
+      switch (_checksum_mode) {
+        case CHECKSUM_CRC8:
+        case CHECKSUM_CRC16:
+          return _dest.print((unsigned int) _crc);
+        default:
+          return _dest.print(sum);
+      }
+    }
+
+  private:
+    void _update(uint8_t c) {
+      if (_checksum_mode == CHECKSUM_CRC16) {
+        _crc = crc16_update(_crc, c);
+      } else if (_checksum_mode == CHECKSUM_CRC8) {
+        _crc = crc8_update((uint8_t) _crc, c);
+      }
+    }
+
+    Print &_dest;
+    uint16_t _crc;
+};
+
+/*
+ * Internal helpers to write a CSV record to the current output: the timestamp
+ * and sensor name, then each value, then the checksum. cs collects the
+ * CHECKSUM_SUM checksum, and full is set once the output has no more room.
+ */
+static size_t _writeCSVStart(_ChecksumPrint &out, int *cs, const char *sensorName, unsigned long timestamp) {
+  size_t written = 0;
+  int name_len;
 
   if (timestamp == 0) {
     timestamp = millis();
   }
 
-  _resetOutBuf();
-
-  ultoa(timestamp, _getOutBuf(), 10);
-  _output_buf_len = strlen(_getOutBuf());
+  written += out.print(timestamp);
 
   if (sensorName != NULL) {
     if ((name_len = strlen(sensorName)) > 50) {
       name_len = 50;
     }
-    _getOutBuf()[_output_buf_len++] = CSV_SEPARATOR;
-    memcpy(&(_getOutBuf()[_output_buf_len]), sensorName, name_len);
-    _output_buf_len += name_len;
+    written += out.write(CSV_SEPARATOR);
+    written += out.write((const uint8_t *) sensorName, name_len);
+
+    if (_checksum_mode == CHECKSUM_SUM) {
+      *cs += _sumChars(sensorName);
+    }
   }
 
-  va_start(args, numValues);
+  return written;
+}
+
+static size_t _writeCSVValue(_ChecksumPrint &out, int *cs, boolean *full, float value) {
+  // The sum covers every value, even ones that don't fit
+  if (_checksum_mode == CHECKSUM_SUM) {
+    *cs += lround(value);
+  }
+
+  // We don't know *exactly* how long the floating point value is
+  // going to be, so just take a guess here...
+  if (*full || _outRoom() < 10) {
+    *full = true;
+    return 0;
+  }
+  return out.write(CSV_SEPARATOR) + printFixed(out, value, 2, 3);
+}
+
+static size_t _writeCSVEnd(_ChecksumPrint &out, int cs) {
+  size_t written = 0;
+
+  if (_outRoom() > 10) {
+    written += out.write(CSV_SEPARATOR);
+    written += out.printChecksum(cs);
+  }
+  written += out.write('\n');
+
+  return written;
+}
+
+static size_t _writeCSV(const char *sensorName, unsigned long timestamp, int numValues, va_list values) {
+  _ChecksumPrint out(_out());
+  size_t written = 0;
+  int i;
+  int cs = 0;
+  boolean full = false;
+  va_list args;
+
+  written += _writeCSVStart(out, &cs, sensorName, timestamp);
+
+  va_copy(args, values);
   for (i = 0; i < numValues; ++i) {
-    // We don't know *exactly* how long the floating point value is
-    // going to be, so just take a guess here...
-    if (_output_buf_len > OUTPUT_BUF_SIZE - 10) {
-      break;
-    }
-    _getOutBuf()[_output_buf_len++] = CSV_SEPARATOR;
-    dtostrf(va_arg(args, double), 2, 3, _getOutBuf() + _output_buf_len);
-    _output_buf_len = strlen(_getOutBuf());
+    written += _writeCSVValue(out, &cs, &full, va_arg(args, double));
   }
   va_end(args);
 
-  if (_output_buf_len < OUTPUT_BUF_SIZE - 10) {
-    va_start(args, numValues);
-    int cs = _calculateCheckSumValue(sensorName, numValues, args);
-    va_end(args);
-    _getOutBuf()[_output_buf_len++] = CSV_SEPARATOR;
-    itoa(cs, _getOutBuf() + _output_buf_len, 10);
-    _output_buf_len = strlen(_getOutBuf());
-  }
-  _getOutBuf()[_output_buf_len++] = '\n';
+  return written + _writeCSVEnd(out, cs);
+}
 
-  return _getOutBuf();
+/**
+ * Create a CSV string with a generic array of float values and a sensor name. Optional timestamp
+ * argument allows passing in a timestamp; will use millis() otherwise.
+ *
+ * @param sensorName string sensor name
+ * @param timestamp optional timestamp. If 0, millis() will be called.
+ * @param numValues number of float values
+ * @param variable float values
+ *
+ * @return pointer to output buffer
+ */
+const char * valuesToCSV(const char *sensorName, unsigned long timestamp, int numValues, ...) {
+  size_t written;
+  va_list args;
+
+  _beginOutput();
+  va_start(args, numValues);
+  written = _writeCSV(sensorName, timestamp, numValues, args);
+  va_end(args);
+
+  return _endOutput(written);
 }
 
 /**
@@ -253,23 +559,44 @@ const char * valueToCSV(const char *sensorName, float value, unsigned long times
 }
 
 /*
- * Internal helper to build the JSON string at the proper point in the output buffer
- * with the correct values and labels
+ * Internal helper to write a JSON value to the current output with the correct
+ * values and labels. The label is appended to the sensor name.
+ *
+ * @param labelP true if the label is in PROGMEM
+ * @param unit unit string in PROGMEM
  */
-int _writeJSONValue(char *buf, const char *sensor_name, const char *unit, float value) {
-  char num [32];
-  char format_str[80];
-  // inexact estimate on the number of characters the value will take up...
-  if (strlen(sensor_name) + strlen(unit) + 10 + _output_buf_len > OUTPUT_BUF_SIZE) {
-    return -1;
+static size_t _writeJSONValue(const char *sensor_name, const char *label, boolean labelP,
+                              const char unit[] PROGMEM, float value) {
+  _ChecksumPrint out(_out());
+  size_t written = 0;
+  int label_len = labelP ? strlen_P(label) : strlen(label);
+  int cs = 0;
+
+  // inexact estimate on the number of characters the value will take up, so a
+  // record that doesn't fit is left out rather than cut off
+  if ((int) (strlen(sensor_name) + label_len + strlen_P(unit) + JSON_RECORD_OVERHEAD) > _outRoom()) {
+    return 0;
+  }
+
+  // same as calculateCheckSum on the sensor name and label concatenated
+  if (_checksum_mode == CHECKSUM_SUM) {
+    cs = _sumChars(sensor_name) + (labelP ? _sumCharsP(label) : _sumChars(label)) + lround(value);
   }
 
-  dtostrf(value, 4, 2, num);
-  strcpy_P(format_str, json_format);
-  _output_buf_len += sprintf(buf, format_str,
-                             JSON_PREFIX, sensor_name, unit, num,
-                             calculateCheckSum(sensor_name, 1, value), JSON_SUFFIX);
-  return _output_buf_len;
+  written += out.write(JSON_PREFIX);
+  written += _printP(out, json_sensor_name);
+  written += out.print(sensor_name);
+  written += labelP ? _printP(out, label) : out.print(label);
+  written += _printP(out, json_unit);
+  written += _printP(out, unit);
+  written += _printP(out, json_value);
+  written += printFixed(out, value, 4, 2);
+  written += _printP(out, json_checksum);
+  written += out.printChecksum(cs);
+  written += out.write('}');
+  written += out.write(JSON_SUFFIX);
+  written += out.write('\n');
+  return written;
 }
 
 /**
@@ -284,25 +611,49 @@ int _writeJSONValue(char *buf, const char *sensor_name, const char *unit, float
  */
 const char * valuesToJSON(const char *sensorName, unsigned char unit, int numValues, ...) {
   int i = 0;
-  size_t nameLength = strlen(sensorName) + 1; // For null terminator
+  size_t written = 0;
   va_list args;
 
-  char concatBuf[5];
-  strcpy_P(concatBuf, concat_string);
-
-  _resetOutBuf();
+  _beginOutput();
   va_start(args, numValues);
   for (i = 0; i < numValues; ++i) {
     char * label = va_arg(args, char *);
     float value = va_arg(args, double);
-    char nameBuf[nameLength + strlen(label) + 1];
 
-    sprintf(nameBuf, concatBuf, sensorName, label); // concatBuf = "%s%s";
-    _writeJSONValue(&_getOutBuf()[_output_buf_len], nameBuf, unit_to_str(unit), value);
+    written += _writeJSONValue(sensorName, label, false, unit_to_str_P(unit), value);
   }
   va_end(args);
 
-  return _getOutBuf();
+  return _endOutput(written);
+}
+
+/**
+ * Same as valuesToJSON, with the labels in PROGMEM (e.g. PSTR("X")) so they
+ * don't take up any RAM.
+ *
+ * @param sensorName string sensor name
+ * @param unit unit the sensor values are in
+ * @param numValues number of pairs of PROGMEM string labels and float values
+ * @param variable pairs of PROGMEM string labels and float values
+ *
+ * @return pointer to output buffer
+ */
+const char * valuesToJSON_P(const char *sensorName, unsigned char unit, int numValues, ...) {
+  int i = 0;
+  size_t written = 0;
+  va_list args;
+
+  _beginOutput();
+  va_start(args, numValues);
+  for (i = 0; i < numValues; ++i) {
+    const char * label = va_arg(args, const char *);
+    float value = va_arg(args, double);
+
+    written += _writeJSONValue(sensorName, label, true, unit_to_str_P(unit), value);
+  }
+  va_end(args);
+
+  return _endOutput(written);
 }
 
 /**
@@ -315,88 +666,1006 @@ const char * valuesToJSON(const char *sensorName, unsigned char unit, int numVal
  * @return the output buffer
  */
 const char * valueToJSON(const char *sensorName, unsigned char unit, float value) {
-  _resetOutBuf();
-  _writeJSONValue(_getOutBuf(), sensorName, unit_to_str(unit), value);
-  return _getOutBuf();
+  _beginOutput();
+  return _endOutput(_writeJSONValue(sensorName, "", false, unit_to_str_P(unit), value));
 }
 
 
-/**************************************************************************//**
- * @brief   Initializes the sensor with any set configurations
- * @ingroup sensor
- *
- * @retval true  Successfully initialized
- * @retval false Failed to initialize
- *****************************************************************************/
-boolean Sensor::begin(void) {
-  catchSpaceboard();
-  this->initialized = this->initialize();
+/*
+ * Internal helper to write one byte of a binary frame and add it to the CRC
+ */
+static size_t _writeBinaryByte(Print &out, uint16_t *crc, unsigned char value) {
+  *crc = crc16_update(*crc, value);
+  return out.write(value);
+}
 
-  if (!this->initialized) {
-    _writeErrorMessage(begin_error_msg, this->name);
-  }
+/*
+ * Internal helper to write a little endian float into a binary frame
+ */
+static size_t _writeBinaryFloat(Print &out, uint16_t *crc, float value) {
+  uint32_t bits;
+  size_t written = 0;
 
-  return this->initialized;
+  memcpy(&bits, &value, sizeof(bits));
+  for (uint8_t i = 0; i < sizeof(bits); ++i, bits >>= 8) {
+    written += _writeBinaryByte(out, crc, bits & 0xFF);
+  }
+  return written;
 }
 
-/**
- * @brief   Makes sure the sensor was initialized then calls the sensor specific read
- * @ingroup sensor
- * @retval  true  A sensor reading was attempted
- * @retval  false No sensor reading was attempted. Must `begin()` first
+/*
+ * Internal helper to write the header of a binary frame. The CRC starts with the
+ * header; the payload bytes and then the CRC itself must follow.
  */
-boolean Sensor::read(void) {
-  if (this->initialized) {
-    this->header.timestamp = millis();
-    return this->readSensor();
+static size_t _writeBinaryHeader(Print &out, uint16_t *crc, unsigned char type, unsigned char sensorId,
+                                 unsigned char unit, unsigned long timestamp, size_t payloadLength) {
+  size_t written = 0;
+
+  if (timestamp == 0) {
+    timestamp = millis();
   }
 
-  return this->initialized;
+  *crc = CRC16_INIT;
+  written += out.write(BINARY_FRAME_SYNC);
+  written += _writeBinaryByte(out, crc, type);
+  written += _writeBinaryByte(out, crc, payloadLength);
+  written += _writeBinaryByte(out, crc, unit);
+  written += _writeBinaryByte(out, crc, sensorId);
+  for (uint8_t i = 0; i < 4; ++i, timestamp >>= 8) {
+    written += _writeBinaryByte(out, crc, timestamp & 0xFF);
+  }
+  return written;
 }
 
-/**
- * @brief   Takes a reading from the sensor and returns value in CSV format
- * @ingroup sensor
- * @param   sensorName The text to display next to the value
- * @return  sensor readings in CSV format or empty string if uninitialized
+/*
+ * Internal helper to finish a binary frame with its CRC
  */
-const char * Sensor::readToCSV(const char * sensorName) {
-  this->read();
-  return this->toCSV(sensorName);
+static size_t _writeBinaryCRC(Print &out, uint16_t crc) {
+  size_t written = out.write(crc & 0xFF);
+  return written + out.write(crc >> 8);
 }
 
-/**
- * @brief   Takes a reading from the sensor and returns value in JSON format
- * @ingroup sensor
- * @param   sensorName The text to display next to the value
- * @return  sensor readings in JSON format or empty string if uninitialized
+/*
+ * Largest payload that fits in both the current output and the frame's length byte
  */
-const char * Sensor::readToJSON(const char * sensorName) {
-  this->read();
-  return this->toJSON(sensorName);
+static size_t _maxBinaryPayload() {
+  int max_len = _outRoom() - BINARY_FRAME_OVERHEAD;
+
+  if (max_len < (int) sizeof(float)) {
+    return sizeof(float);
+  }
+  return max_len > 255 ? 255 : max_len;
 }
 
 /**
- * @brief   Initializes member variables for each sensor
- * @ingroup sensor
- * @param   sensor_id The type of sensor
- * @param   unit The unit the sensor values use
- * @param   name The default name the sensor uses
+ * Create a binary frame with a generic array of float values. Optional timestamp
+ * argument allows passing in a timestamp; will use millis() otherwise.
  *
- * @note    These values are not initialized as member variables in child class
- *          constructors because they are inherited from the base Sensor class
- *          and need a Sensor Constructor they can be passed to. However, this
- *          constructor causes more memory overhead than it was decided to be
- *          worth. Which is why they're explicitly set instead of initialized.
+ * @param sensorId sensor id the values came from (see sensor_id_t)
+ * @param unit unit the sensor values are in
+ * @param timestamp optional timestamp. If 0, millis() will be called.
+ * @param numValues number of float values
+ * @param variable float values
+ *
+ * @return pointer to output buffer, the frame is binaryFrameLength() bytes long
  */
-void Sensor::initializeHeader(sensor_id_t sensor_id, data_unit_t unit, const char name[] PROGMEM) {
-  this->name = name;
-  this->header.sensor_id = sensor_id;
-  this->header.unit = unit;
-  this->header.timestamp = 0;
-  this->initialized = false;
-}
+const unsigned char * valuesToBinary(unsigned char sensorId, unsigned char unit, unsigned long timestamp,
+                                     int numValues, ...) {
+  size_t written;
+  uint16_t crc;
+  va_list args;
 
+  _beginOutput();
+  if (numValues > (int) (_maxBinaryPayload() / sizeof(float))) {
+    numValues = _maxBinaryPayload() / sizeof(float);
+  }
+
+  written = _writeBinaryHeader(_out(), &crc, BINARY_VALUES_FLOAT, sensorId, unit, timestamp,
+                               numValues * sizeof(float));
+  va_start(args, numValues);
+  for (int i = 0; i < numValues; ++i) {
+    written += _writeBinaryFloat(_out(), &crc, (float) va_arg(args, double));
+  }
+  va_end(args);
+  written += _writeBinaryCRC(_out(), crc);
+
+  return _endBinaryOutput(written);
+}
+
+/**
+ * Create a binary frame with raw int16 sensor counts and the scale that converts
+ * them to the given unit. Optional timestamp argument allows passing in a
+ * timestamp; will use millis() otherwise.
+ *
+ * @param sensorId sensor id the values came from (see sensor_id_t)
+ * @param unit unit the scaled values are in
+ * @param timestamp optional timestamp. If 0, millis() will be called.
+ * @param scale unit per count
+ * @param numValues number of raw values
+ * @param values raw values
+ *
+ * @return pointer to output buffer, the frame is binaryFrameLength() bytes long
+ */
+const unsigned char * rawValuesToBinary(unsigned char sensorId, unsigned char unit, unsigned long timestamp,
+                                        float scale, int numValues, const int16_t *values) {
+  size_t written;
+  uint16_t crc;
+
+  _beginOutput();
+  if (numValues > (int) ((_maxBinaryPayload() - sizeof(float)) / sizeof(int16_t))) {
+    numValues = (_maxBinaryPayload() - sizeof(float)) / sizeof(int16_t);
+  }
+
+  written = _writeBinaryHeader(_out(), &crc, BINARY_VALUES_INT16, sensorId, unit, timestamp,
+                               sizeof(float) + numValues * sizeof(int16_t));
+  written += _writeBinaryFloat(_out(), &crc, scale);
+  for (int i = 0; i < numValues; ++i) {
+    written += _writeBinaryByte(_out(), &crc, values[i] & 0xFF);
+    written += _writeBinaryByte(_out(), &crc, (values[i] >> 8) & 0xFF);
+  }
+  written += _writeBinaryCRC(_out(), crc);
+
+  return _endBinaryOutput(written);
+}
+
+/**
+ * Create the next frame of a delta stream from raw int16 sensor counts: a
+ * keyframe with the full timestamp, scale and values when the encoder asks for
+ * one, or else a delta frame with just the changes since the last sample.
+ * Optional timestamp argument allows passing in a timestamp; will use millis()
+ * otherwise.
+ *
+ * @param encoder the stream's encoder, which keeps the last sample
+ * @param sensorId sensor id the values came from (see sensor_id_t)
+ * @param unit unit the scaled values are in
+ * @param timestamp optional timestamp. If 0, millis() will be called.
+ * @param scale unit per count
+ * @param numValues number of raw values, at most DELTA_MAX_VALUES
+ * @param values raw values
+ *
+ * @return pointer to output buffer, the frame is binaryFrameLength() bytes long
+ */
+const unsigned char * rawValuesToDelta(DeltaEncoder & encoder, unsigned char sensorId, unsigned char unit,
+                                       unsigned long timestamp, float scale, int numValues,
+                                       const int16_t *values) {
+  int32_t deltas[DELTA_MAX_VALUES + 1];
+  uint8_t payload[(DELTA_MAX_VALUES + 1) * DELTA_VARINT_MAX_SIZE];
+  uint8_t len = 0;
+  size_t written = 0;
+  uint16_t crc = CRC16_INIT;
+
+  if (timestamp == 0) {
+    timestamp = millis();
+  }
+  if (numValues > DELTA_MAX_VALUES) {
+    numValues = DELTA_MAX_VALUES;
+  }
+
+  _beginOutput();
+  if (encoder.next(timestamp, scale, numValues, values, deltas)) {
+    written = _writeBinaryHeader(_out(), &crc, BINARY_VALUES_KEYFRAME, sensorId, unit, timestamp,
+                                 1 + sizeof(float) + numValues * sizeof(int16_t));
+    written += _writeBinaryByte(_out(), &crc, encoder.sequence());
+    written += _writeBinaryFloat(_out(), &crc, scale);
+    for (int i = 0; i < numValues; ++i) {
+      written += _writeBinaryByte(_out(), &crc, values[i] & 0xFF);
+      written += _writeBinaryByte(_out(), &crc, (values[i] >> 8) & 0xFF);
+    }
+  } else {
+    for (int i = 0; i <= numValues; ++i) {
+      len += deltaPutVarint(deltas[i], payload + len);
+    }
+
+    written += _out().write(BINARY_FRAME_SYNC);
+    written += _writeBinaryByte(_out(), &crc, BINARY_VALUES_DELTA);
+    written += _writeBinaryByte(_out(), &crc, len);
+    written += _writeBinaryByte(_out(), &crc, unit);
+    written += _writeBinaryByte(_out(), &crc, sensorId);
+    written += _writeBinaryByte(_out(), &crc, encoder.sequence());
+    for (uint8_t i = 0; i < len; ++i) {
+      written += _writeBinaryByte(_out(), &crc, payload[i]);
+    }
+  }
+  written += _writeBinaryCRC(_out(), crc);
+
+  return _endBinaryOutput(written);
+}
+
+/**
+ * Gets the total length of a binary frame, including its header and CRC
+ *
+ * @param frame frame returned by valuesToBinary, rawValuesToDelta or toBinary
+ *
+ * @return frame length in bytes, 0 if there is no frame
+ */
+size_t binaryFrameLength(const unsigned char *frame) {
+  if (frame == NULL || frame[0] != BINARY_FRAME_SYNC) {
+    return 0;
+  }
+  if (frame[1] == BINARY_VALUES_DELTA) {
+    return BINARY_DELTA_OVERHEAD + frame[2];
+  }
+  return BINARY_FRAME_OVERHEAD + frame[2];
+}
+
+
+/**************************************************************************//**
+ * @brief   Initializes the sensor with any set configurations
+ * @ingroup sensor
+ *
+ * @retval true  Successfully initialized
+ * @retval false Failed to initialize
+ *****************************************************************************/
+boolean Sensor::begin(void) {
+  catchSpaceboard();
+  this->initialized = this->selectBus() && this->initialize();
+
+#if ARDUSAT_DATA_READY
+  // Sensor registers were reset, so turn the data-ready pin back on
+  if (this->initialized && this->dataReadyAttached && !this->setDataReady(true)) {
+    this->detachDataReady();
+  }
+#endif
+
+  if (!this->initialized) {
+    _writeErrorMessage(begin_error_msg, this->name);
+  }
+
+  return this->initialized;
+}
+
+/**
+ * @brief   Starts several sensors, detecting the board and scanning the bus just
+ *          once for all of them
+ * @ingroup sensor
+ *
+ * Sensors whose device didn't answer the scan fail straight away, without
+ * being probed. With useCache, the detection result is saved in EEPROM and
+ * reused on later boots while it still matches the hardware. See detectBoard()
+ * and ArdusatBusClass::present().
+ *
+ * @code
+ *     Sensor * const sensors[] = {&accel, &gyro, &press};
+ *     beginAll(sensors, 3, true);
+ * @endcode
+ *
+ * @retval  true  Every sensor initialized
+ * @retval  false At least one sensor failed to initialize
+ */
+boolean beginAll(Sensor * const sensors[], uint8_t count, boolean useCache) {
+  boolean ok = true;
+
+  detectBoard(useCache);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    if (!sensors[i]->begin()) {
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+/**
+ * @brief   Makes sure the sensor was initialized then calls the sensor specific read
+ * @ingroup sensor
+ * @retval  true  A sensor reading was attempted
+ * @retval  false No sensor reading was attempted. Must `begin()` first. Also
+ *                false when the reading failed, or when a filter took the
+ *                sample but has no new output yet; `isPending()` tells the
+ *                last apart, and the values and timestamp are left as they were.
+ */
+boolean Sensor::read(void) {
+  if (this->initialized) {
+    uint16_t errors = ArdusatBus.errorCount();
+    uint16_t retries = ArdusatBus.retryCount();
+    unsigned long last = this->header.timestamp;
+    boolean ret;
+
+    TIMING_START(start);
+
+    this->pending = false;
+    this->stampReading();
+    ret = this->selectBus() && this->readSensor();
+    TIMING_END(this->timing.read, start);
+    this->countBusErrors(errors, retries);
+    if (ret) {
+      this->checkReport();
+    } else if (this->pending) {
+      this->header.timestamp = last;
+    }
+    return ret;
+  }
+
+  return this->initialized;
+}
+
+/*
+ * A read() that only updates the raw counts, for the readRaw() of sensors
+ * that keep them. It goes through the same timing, bus error counts and
+ * report policy as any other reading.
+ */
+boolean Sensor::readRawCounts(void) {
+  boolean ret;
+
+  this->rawOnly = true;
+  ret = this->read();
+  this->rawOnly = false;
+  return ret;
+}
+
+/**
+ * @brief   Starts a split-phase reading without waiting for the sensor
+ * @ingroup sensor
+ *
+ * Sensors with conversion or integration delays (Pressure, Luminosity,
+ * RGBLight) start their conversion and return right away. Call `poll()` until
+ * it returns true, then use the sensor values like after `read()`. All other
+ * sensors finish the reading the first time `poll()` is called.
+ *
+ * Example Usage:
+ * @code
+ *     press.startRead();
+ *     lum.startRead();
+ *     ...
+ *     if (press.poll()) {
+ *       Serial.println(press.toJSON("pressure"));
+ *     }
+ * @endcode
+ *
+ * @retval  true  A reading is in progress
+ * @retval  false No reading was started. Must `begin()` first
+ */
+boolean Sensor::startRead(void) {
+  if (!this->initialized) {
+    return false;
+  }
+
+  if (!this->isReading()) {
+    this->readStarted = millis();
+    this->readDeadline = this->readStarted;
+    this->readStage = 1;
+    this->pending = false;
+    this->continueRead();
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Advances a reading started with `startRead()`
+ * @ingroup sensor
+ * @retval  true  The reading finished and the sensor values were updated
+ * @retval  false The reading is still in progress, or none was started
+ */
+boolean Sensor::poll(void) {
+  this->continueRead();
+
+  if (this->readStage == 0xFF) {
+    this->readStage = 0;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Checks if a reading started with `startRead()` hasn't been picked up by `poll()` yet
+ * @ingroup sensor
+ * @retval  true  A reading is in progress
+ * @retval  false The sensor is idle
+ */
+boolean Sensor::isReading(void) {
+  return this->readStage != 0;
+}
+
+/*
+ * Runs as many steps of a split-phase reading as are due. readStage is kept
+ * one ahead of the step number so that 0 can mean idle; 0xFF marks a finished
+ * reading that hasn't been returned by poll() yet.
+ */
+void Sensor::continueRead(void) {
+  long wait;
+
+  while (this->readStage != 0 && this->readStage != 0xFF &&
+         (long) (millis() - this->readDeadline) >= 0) {
+    uint16_t errors = ArdusatBus.errorCount();
+    uint16_t retries = ArdusatBus.retryCount();
+
+#if ARDUSAT_DATA_READY
+    // With a data-ready pin, don't touch the bus until there's a new sample,
+    // and timestamp the reading with when the sample was ready
+    if (this->readStage == 1 && this->dataReadyAttached &&
+        !dataReadyTake(this->dataReadyIrq(), this->dataReadyPin, &(this->readStarted))) {
+      break;
+    }
+#endif
+
+    TIMING_START(start);
+    wait = this->selectBus() ? this->readSensorStep(this->readStage - 1) : SENSOR_READ_FAILED;
+    TIMING_END(this->timing.read, start);
+    this->countBusErrors(errors, retries);
+
+    if (wait == SENSOR_READ_COMPLETE) {
+      this->header.timestamp = this->readStarted;
+      this->readStage = 0xFF;
+      this->checkReport();
+    } else if (wait < 0) {
+      this->readStage = 0;
+    } else {
+      this->readDeadline = millis() + wait;
+      this->readStage++;
+    }
+  }
+}
+
+#if ARDUSAT_DATA_READY
+/**
+ * @brief   Flags new samples with the sensor's data-ready pin, so readings only
+ *          touch the bus once there's something to read
+ * @ingroup sensor
+ *
+ * Supported by Acceleration (LSM303 INT1), Gyro (L3GD20H DRDY/INT2) and
+ * Magnetic (LSM303D INT2, or the DLHC's DRDY). The pin must have an external
+ * interrupt (pins 2 and 3 on an Uno). Once attached, `startRead()`/`poll()`
+ * (and so SensorScheduler) wait for the pin without any bus traffic, and every
+ * reading is timestamped with the time the sample was ready. `read()` still
+ * reads straight away.
+ *
+ * Example Usage:
+ * @code
+ *     gyro.begin();
+ *     gyro.attachDataReady(2);
+ *     scheduler.add(gyro, 0, printSample); // every new sample
+ * @endcode
+ *
+ * @param   pin Arduino pin the data-ready output is wired to
+ * @retval  true  Data-ready pin in use
+ * @retval  false Not initialized, the sensor has no data-ready output, or the
+ *                pin has no free external interrupt
+ */
+boolean Sensor::attachDataReady(uint8_t pin) {
+  if (!this->initialized) {
+    return false;
+  }
+
+  this->detachDataReady();
+
+  if (dataReadyAttach(pin) < 0) {
+    return false;
+  }
+  this->dataReadyPin = pin;
+  this->dataReadyAttached = true;
+
+  if (!this->selectBus() || !this->setDataReady(true)) {
+    this->detachDataReady();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Goes back to polling the sensor and frees its interrupt
+ * @ingroup sensor
+ */
+void Sensor::detachDataReady(void) {
+  if (!this->dataReadyAttached) {
+    return;
+  }
+
+  dataReadyDetach(this->dataReadyIrq());
+  this->dataReadyAttached = false;
+
+  if (this->initialized && this->selectBus()) {
+    this->setDataReady(false);
+  }
+}
+
+/*
+ * Turns the sensor's data-ready output on or off. Sensors without one keep
+ * this default.
+ */
+boolean Sensor::setDataReady(boolean /* enable */) {
+  return false;
+}
+
+/*
+ * The external interrupt of the attached data-ready pin. Worked out from the
+ * pin rather than kept, to save a byte in every sensor.
+ */
+int8_t Sensor::dataReadyIrq(void) {
+  return digitalPinToInterrupt(this->dataReadyPin);
+}
+#endif
+
+/*
+ * Timestamps a blocking read: now, or when the sample was ready if the data-ready
+ * pin has flagged one
+ */
+void Sensor::stampReading(void) {
+  this->header.timestamp = millis();
+
+#if ARDUSAT_DATA_READY
+  if (this->dataReadyAttached) {
+    dataReadyTake(this->dataReadyIrq(), this->dataReadyPin, &(this->header.timestamp));
+  }
+#endif
+}
+
+#if ARDUSAT_REPORT_POLICY
+/**
+ * @brief   Only sends readings that have changed by more than a deadband
+ * @ingroup sensor
+ *
+ * After each `read()` or split-phase reading, the policy decides whether the
+ * reading should be sent (see ReportPolicy). The `write*` functions write
+ * nothing for readings it holds back, and SensorScheduler doesn't call back
+ * for them, so neither the formatting nor the sending is spent on them. The
+ * sensor values are still updated for the sketch's own use.
+ *
+ * Example Usage:
+ * @code
+ *     ReportPolicy pressPolicy(0, 0.0005, 30000); // 0.05%, or every 30 s
+ *
+ *     press.setReportPolicy(&pressPolicy);
+ *     scheduler.add(press, 1000, printPressure);   // only called on changes
+ * @endcode
+ *
+ * @param   policy Policy to use, or NULL to send every reading
+ */
+void Sensor::setReportPolicy(ReportPolicy * policy) {
+  this->reportPolicy = policy;
+  this->reportPending = true;
+
+  if (policy != NULL) {
+    policy->force();
+  }
+}
+#endif
+
+/**
+ * @brief   Checks if the last reading should be sent under the report policy
+ * @ingroup sensor
+ * @retval  true  The reading should be sent, or there is no policy
+ * @retval  false The reading hasn't changed enough to send
+ */
+boolean Sensor::reportDue(void) {
+#if ARDUSAT_REPORT_POLICY
+  return this->reportPending;
+#else
+  return true;
+#endif
+}
+
+/*
+ * Runs the report policy on a reading that just finished
+ */
+void Sensor::checkReport(void) {
+#if ARDUSAT_REPORT_POLICY
+  float values[REPORT_MAX_VALUES];
+  uint8_t count;
+
+  if (this->reportPolicy == NULL) {
+    this->reportPending = true;
+    return;
+  }
+
+  count = this->getValues(values);
+  this->reportPending = this->reportPolicy->check(values, count, this->header.timestamp);
+#endif
+}
+
+/**
+ * @brief   Puts the sensor behind a channel of a TCA9548A I2C mux
+ * @ingroup sensor
+ *
+ * Lets several identical sensors share an address, one per mux channel. The
+ * channel is selected (see ArdusatBusClass::selectChannel) before each of the
+ * sensor's transactions, so call this before `begin()`. SensorScheduler reads
+ * all of the sensors on one channel before switching to the next.
+ *
+ * Example Usage:
+ * @code
+ *     Luminosity lum0, lum1;
+ *
+ *     lum0.setBusChannel(0);
+ *     lum1.setBusChannel(1);
+ *     lum0.begin();
+ *     lum1.begin();
+ * @endcode
+ *
+ * @param   channel Mux channel, 0 to BUS_MUX_CHANNELS - 1, or BUS_NO_CHANNEL
+ *                  (the default) for a sensor on the main bus
+ */
+void Sensor::setBusChannel(uint8_t channel) {
+  this->busChannel = channel < BUS_MUX_CHANNELS ? channel : SENSOR_NO_CHANNEL;
+}
+
+/*
+ * Switches the mux to the sensor's channel, if it's behind one
+ */
+boolean Sensor::selectBus(void) {
+  return this->busChannel == SENSOR_NO_CHANNEL || ArdusatBus.selectChannel(this->busChannel);
+}
+
+/*
+ * Gets the last read values, for the report policy and SensorStats. Sensors
+ * without any send every reading.
+ */
+uint8_t Sensor::getValues(float * /* values */) {
+  return 0;
+}
+
+/*
+ * Adds the bus errors and retries since the given ArdusatBus counts to this
+ * sensor's counts, which stop at 65535 rather than wrapping.
+ */
+void Sensor::countBusErrors(uint16_t errors, uint16_t retries) {
+  errors = ArdusatBus.errorCount() - errors;
+  retries = ArdusatBus.retryCount() - retries;
+
+  this->busErrors = (this->busErrors > 0xFFFF - errors) ? 0xFFFF : this->busErrors + errors;
+  this->busRetries = (this->busRetries > 0xFFFF - retries) ? 0xFFFF : this->busRetries + retries;
+}
+
+/**
+ * @brief   Runs one step of a split-phase reading
+ * @ingroup sensor
+ *
+ * Sensors that have to wait on a conversion override this to start the
+ * conversion in one step and collect it in a later one. The default takes a
+ * blocking reading in the first step.
+ *
+ * @param   step Index of the step to run, starting at 0
+ * @return  ms to wait before the next step, SENSOR_READ_COMPLETE once the
+ *          values are updated, or SENSOR_READ_FAILED
+ */
+long Sensor::readSensorStep(uint8_t /* step */) {
+  return this->readSensor() ? SENSOR_READ_COMPLETE : SENSOR_READ_FAILED;
+}
+
+/**
+ * @brief   Takes a reading from the sensor and returns value in CSV format
+ * @ingroup sensor
+ * @param   sensorName The text to display next to the value
+ * @return  sensor readings in CSV format or empty string if uninitialized, or if
+ *          a filter has no new output yet
+ */
+const char * Sensor::readToCSV(const char * sensorName) {
+  const char * ret;
+
+  if (!this->read() && this->pending) {
+    return "";
+  }
+  TIMING_START(start);
+  ret = this->toCSV(sensorName);
+  TIMING_END(this->timing.format, start);
+  return ret;
+}
+
+/**
+ * @brief   Takes a reading from the sensor and returns value in JSON format
+ * @ingroup sensor
+ * @param   sensorName The text to display next to the value
+ * @return  sensor readings in JSON format or empty string if uninitialized, or if
+ *          a filter has no new output yet
+ */
+const char * Sensor::readToJSON(const char * sensorName) {
+  const char * ret;
+
+  if (!this->read() && this->pending) {
+    return "";
+  }
+  TIMING_START(start);
+  ret = this->toJSON(sensorName);
+  TIMING_END(this->timing.format, start);
+  return ret;
+}
+
+/**
+ * @brief   Takes a reading from the sensor and returns value as a binary frame
+ * @ingroup sensor
+ * @return  binary frame of sensor readings or NULL if uninitialized, or if a
+ *          filter has no new output yet
+ */
+const unsigned char * Sensor::readToBinary(void) {
+  const unsigned char * ret;
+
+  if (!this->read() && this->pending) {
+    return NULL;
+  }
+  TIMING_START(start);
+  ret = this->toBinary();
+  TIMING_END(this->timing.format, start);
+  return ret;
+}
+
+/**
+ * @brief   Writes the last read value in CSV format straight into a sink
+ * @ingroup sensor
+ *
+ * Same output as `toCSV()`, but written a piece at a time into the sink instead
+ * of the shared output buffer, so no buffer is needed and the result isn't
+ * overwritten by the next sensor.
+ *
+ * Example Usage:
+ * @code
+ *     accel.read();
+ *     accel.writeCSV(serialConnection, "accel");
+ * @endcode
+ *
+ * @param   out sink to write to (e.g. ArdusatSerial, an SD File, RingBufferSink)
+ * @param   sensorName The text to display next to the value
+ * @return  number of bytes written, 0 if uninitialized
+ */
+size_t Sensor::writeCSV(OutputSink & out, const char * sensorName) {
+  TIMING_START(start);
+
+  if (!this->reportDue()) {
+    return 0;
+  }
+
+  _output_sink = &out;
+  _output_sink_len = 0;
+  this->toCSV(sensorName);
+  _output_sink = NULL;
+  TIMING_END(this->timing.format, start);
+
+  return _output_sink_len;
+}
+
+/**
+ * @brief   Writes the last read value in JSON format straight into a sink
+ * @ingroup sensor
+ *
+ * @param   out sink to write to (e.g. ArdusatSerial, an SD File, RingBufferSink)
+ * @param   sensorName The text to display next to the value
+ * @return  number of bytes written, 0 if uninitialized
+ */
+size_t Sensor::writeJSON(OutputSink & out, const char * sensorName) {
+  TIMING_START(start);
+
+  if (!this->reportDue()) {
+    return 0;
+  }
+
+  _output_sink = &out;
+  _output_sink_len = 0;
+  this->toJSON(sensorName);
+  _output_sink = NULL;
+  TIMING_END(this->timing.format, start);
+
+  return _output_sink_len;
+}
+
+/**
+ * @brief   Writes the last read value as a binary frame straight into a sink
+ * @ingroup sensor
+ *
+ * @param   out sink to write to (e.g. ArdusatSerial, an SD File, RingBufferSink)
+ * @return  number of bytes written, 0 if uninitialized
+ */
+size_t Sensor::writeBinary(OutputSink & out) {
+  TIMING_START(start);
+
+  if (!this->reportDue()) {
+    return 0;
+  }
+
+  _output_sink = &out;
+  _output_sink_len = 0;
+  this->toBinary();
+  _output_sink = NULL;
+  TIMING_END(this->timing.format, start);
+
+  return _output_sink_len;
+}
+
+/**
+ * @brief   Returns last read value as the next frame of a delta stream
+ * @ingroup sensor
+ *
+ * Supported by Acceleration, Gyro, Magnetic and Temperature; see
+ * rawValuesToDelta(). Other sensors return NULL.
+ *
+ * @param   encoder the stream's encoder, one per sensor
+ * @return  keyframe or delta frame, or NULL if unsupported or uninitialized
+ */
+const unsigned char * Sensor::toDeltaBinary(DeltaEncoder & /* encoder */) {
+  return NULL;
+}
+
+/**
+ * @brief   Writes the last read value as the next frame of a delta stream
+ *          straight into a sink
+ * @ingroup sensor
+ *
+ * @param   out sink to write to (e.g. ArdusatSerial, an SD File, RingBufferSink)
+ * @param   encoder the stream's encoder, one per sensor
+ * @return  number of bytes written, 0 if unsupported or uninitialized
+ */
+size_t Sensor::writeDeltaBinary(OutputSink & out, DeltaEncoder & encoder) {
+  TIMING_START(start);
+
+  if (!this->reportDue()) {
+    return 0;
+  }
+
+  _output_sink = &out;
+  _output_sink_len = 0;
+  this->toDeltaBinary(encoder);
+  _output_sink = NULL;
+  TIMING_END(this->timing.format, start);
+
+  return _output_sink_len;
+}
+
+/**
+ * @brief   Initializes member variables for each sensor
+ * @ingroup sensor
+ * @param   sensor_id The type of sensor
+ * @param   unit The unit the sensor values use
+ * @param   name The default name the sensor uses
+ *
+ * @note    These values are not initialized as member variables in child class
+ *          constructors because they are inherited from the base Sensor class
+ *          and need a Sensor Constructor they can be passed to. However, this
+ *          constructor causes more memory overhead than it was decided to be
+ *          worth. Which is why they're explicitly set instead of initialized.
+ */
+void Sensor::initializeHeader(sensor_id_t sensor_id, data_unit_t unit, const char name[] PROGMEM) {
+  this->name = name;
+  this->header.sensor_id = sensor_id;
+  this->header.unit = unit;
+  this->header.timestamp = 0;
+  this->initialized = false;
+  this->readStage = 0;
+  this->pending = false;
+  this->rawOnly = false;
+#if ARDUSAT_DATA_READY
+  this->dataReadyPin = 0;
+  this->dataReadyAttached = false;
+#endif
+#if ARDUSAT_REPORT_POLICY
+  this->reportPolicy = NULL;
+  this->reportPending = true;
+#endif
+  this->busChannel = SENSOR_NO_CHANNEL;
+  this->busErrors = 0;
+  this->busRetries = 0;
+#if ARDUSAT_TIMING
+  this->resetTiming();
+#endif
+}
+
+#if ARDUSAT_TIMING
+/*
+ * Mean of a timing counter in us, 0 if nothing was timed
+ */
+static float _timingMean(const timing_stat_t & stat) {
+  return stat.count == 0 ? 0 : (float) stat.total / stat.count;
+}
+
+/**
+ * @brief   Clears the sensor's timing counters, e.g. after dumping them
+ * @ingroup sensor
+ */
+void Sensor::resetTiming(void) {
+  memset(&(this->timing), 0, sizeof(this->timing));
+}
+
+/**
+ * @brief   Creates a diagnostic record of the time spent reading and formatting
+ *          this sensor, in us
+ * @ingroup sensor
+ *
+ * The values are the number of reads (or split-phase steps), their mean and
+ * longest time, then the same for formatting. Only available when the SDK is
+ * built with ARDUSAT_TIMING.
+ *
+ * Example Usage:
+ * @code
+ *     serialConnection.print(accel.timingToCSV("accel_timing"));
+ *     accel.resetTiming();
+ * @endcode
+ *
+ * @param   sensorName The text to display next to the values
+ * @return  timing record in CSV format
+ */
+const char * Sensor::timingToCSV(const char * sensorName) {
+  return valuesToCSV(sensorName, millis(), 6,
+                     (float) this->timing.read.count, _timingMean(this->timing.read),
+                     (float) this->timing.read.max,
+                     (float) this->timing.format.count, _timingMean(this->timing.format),
+                     (float) this->timing.format.max);
+}
+
+/**
+ * @brief   Creates a diagnostic record of the time spent reading and formatting
+ *          this sensor, in us
+ * @ingroup sensor
+ * @param   sensorName The text to display next to the values
+ * @return  timing record in JSON format
+ */
+const char * Sensor::timingToJSON(const char * sensorName) {
+  return valuesToJSON_P(sensorName, DATA_UNIT_NONE, 6,
+                        PSTR("reads"), (float) this->timing.read.count,
+                        PSTR("readMean"), _timingMean(this->timing.read),
+                        PSTR("readMax"), (float) this->timing.read.max,
+                        PSTR("formats"), (float) this->timing.format.count,
+                        PSTR("formatMean"), _timingMean(this->timing.format),
+                        PSTR("formatMax"), (float) this->timing.format.max);
+}
+
+/**
+ * Creates a diagnostic record of the time spent on the bus and the serial port:
+ * the bus us, bytes and longest transaction, then the serial us, bytes and
+ * longest byte. Only available when the SDK is built with ARDUSAT_TIMING.
+ *
+ * @param name The text to display next to the values
+ *
+ * @return timing record in CSV format
+ */
+const char * sdkTimingToCSV(const char * name) {
+  return valuesToCSV(name, millis(), 6,
+                     (float) ArdusatTiming.bus.total, (float) ArdusatBus.byteCount(),
+                     (float) ArdusatTiming.bus.max,
+                     (float) ArdusatTiming.serial.total, (float) ArdusatTiming.serial.count,
+                     (float) ArdusatTiming.serial.max);
+}
+
+/**
+ * Creates a diagnostic record of the time spent on the bus and the serial port
+ *
+ * @param name The text to display next to the values
+ *
+ * @return timing record in JSON format
+ */
+const char * sdkTimingToJSON(const char * name) {
+  return valuesToJSON_P(name, DATA_UNIT_NONE, 6,
+                        PSTR("busTime"), (float) ArdusatTiming.bus.total,
+                        PSTR("busBytes"), (float) ArdusatBus.byteCount(),
+                        PSTR("busMax"), (float) ArdusatTiming.bus.max,
+                        PSTR("serialTime"), (float) ArdusatTiming.serial.total,
+                        PSTR("serialBytes"), (float) ArdusatTiming.serial.count,
+                        PSTR("serialMax"), (float) ArdusatTiming.serial.max);
+}
+#endif
+
+
+/*
+ * Runs a raw sample through a sensor's filter, replacing it with the filter
+ * output. Returns true if there is a new output, which is always the case
+ * without a filter; the sensor's own values must only be updated then.
+ */
+static boolean _filterRaw(DecimationFilter * filter, raw_xyz_t *sample) {
+  if (filter == NULL) {
+    return true;
+  }
+
+  if (!filter->add(sample->x, sample->y, sample->z)) {
+    return false;
+  }
+
+  *sample = filter->output;
+  return true;
+}
+
+/*
+ * Rounds a value to the nearest whole number of counts of scale, for the
+ * delta streams of sensors that only keep the scaled value
+ */
+static int16_t _toCounts(float value, float scale) {
+  float counts = value / scale;
+
+  if (counts >= INT16_MAX) {
+    return INT16_MAX;
+  } else if (counts <= INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t) (counts < 0 ? counts - 0.5f : counts + 0.5f);
+}
 
 /**************************************************************************//**
  * @brief   Constructs Acceleration sensor object
@@ -410,7 +1679,7 @@ void Sensor::initializeHeader(sensor_id_t sensor_id, data_unit_t unit, const cha
  * @endcode
  *****************************************************************************/
 Acceleration::Acceleration(void) :
-  gGain(LSM303_ACCEL_GAIN8G)
+  gGain(LSM303_ACCEL_GAIN8G), batchMode(false), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_METER_PER_SECONDSQUARED, acceleration_sensor_name);
 }
@@ -434,7 +1703,7 @@ Acceleration::Acceleration(void) :
  * @endcode
  */
 Acceleration::Acceleration(lsm303_accel_gain_e gain) :
-  gGain(gain)
+  gGain(gain), batchMode(false), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_METER_PER_SECONDSQUARED, acceleration_sensor_name);
 }
@@ -447,7 +1716,8 @@ Acceleration::Acceleration(lsm303_accel_gain_e gain) :
  * @retval false Failed to initialize
  */
 boolean Acceleration::initialize(void) {
-  return lsm303_accel_init(this->gGain);
+  return lsm303_accel_init(this->gGain) &&
+    (!this->batchMode || lsm303_accel_setFifo(true));
 }
 
 /**
@@ -458,7 +1728,23 @@ boolean Acceleration::initialize(void) {
  * @retval false Failed to read
  */
 boolean Acceleration::readSensor(void) {
-  lsm303_getAccel(&(this->x), &(this->y), &(this->z));
+  float scale = this->rawScale();
+  raw_xyz_t sample;
+
+  lsm303_getRawAcceleration(&(sample.x), &(sample.y), &(sample.z));
+  if (!_filterRaw(this->filter, &sample)) {
+    this->pending = true;
+    return false;
+  }
+  this->rawX = sample.x;
+  this->rawY = sample.y;
+  this->rawZ = sample.z;
+  if (this->rawOnly) {
+    return true;
+  }
+  this->x = this->rawX * scale;
+  this->y = this->rawY * scale;
+  this->z = this->rawZ * scale;
   return true;
 }
 
@@ -485,13 +1771,193 @@ const char * Acceleration::toCSV(const char * sensorName) {
  */
 const char * Acceleration::toJSON(const char * sensorName) {
   if (this->header.timestamp != 0) {
-    return valuesToJSON(sensorName, this->header.unit, 3, "X", this->x,
-                        "Y", this->y, "Z", this->z);
+    return valuesToJSON_P(sensorName, this->header.unit, 3, json_label_x, this->x,
+                          json_label_y, this->y, json_label_z, this->z);
   } else {
     return "";
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup acceleration
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Acceleration::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          3, this->x, this->y, this->z);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Acceleration::getValues(float * values) {
+  float scale = this->rawScale();
+
+  // From the raw counts, which readRaw() updates too
+  values[0] = this->rawX * scale;
+  values[1] = this->rawY * scale;
+  values[2] = this->rawZ * scale;
+  return 3;
+}
+
+/**
+ * @brief   Takes a reading of raw sensor counts without converting them
+ * @ingroup acceleration
+ *
+ * Only rawX, rawY and rawZ are updated; x, y and z keep their last values.
+ * Multiply the raw counts by `rawScale()` to get m/s^2, or send them with
+ * `toRawBinary()` and let the ground station do the conversion. Like `read()`,
+ * it's counted in `busErrors` and the timing, and checked by the report policy.
+ *
+ * @retval true  Successfully read raw values
+ * @retval false Sensor isn't initialized, failed to read, or a filter has no
+ *               new output yet (see `isPending()`)
+ */
+boolean Acceleration::readRaw(void) {
+  return this->readRawCounts();
+}
+
+/**
+ * @brief   Filters and decimates readings before they're stored and printed
+ * @ingroup acceleration
+ *
+ * With a filter, `read()` and `readRaw()` feed each sample through it and only
+ * return true when it has a new output, which replaces the raw and scaled
+ * values and the timestamp. For the other samples they return false with
+ * `isPending()` true, and leave the values alone. `poll()` (and so a SensorScheduler callback) likewise only finishes
+ * on outputs. Samples from `readBatch()` aren't filtered; pass them to the
+ * filter's `addBatch()`.
+ *
+ * @param   filter Filter to use, or NULL for none. It's reset when set.
+ */
+void Acceleration::setFilter(DecimationFilter * filter) {
+  this->filter = filter;
+
+  if (filter != NULL) {
+    filter->reset();
+  }
+}
+
+#if ARDUSAT_DATA_READY
+/*
+ * Turns the sensor's data-ready output on or off, for attachDataReady
+ */
+boolean Acceleration::setDataReady(boolean enable) {
+  return lsm303_accel_setDataReady(enable);
+}
+#endif
+
+/**
+ * @brief   Gets the scale that converts raw counts to m/s^2
+ * @ingroup acceleration
+ * @return  m/s^2 per raw count for the configured gain
+ */
+float Acceleration::rawScale(void) {
+  return lsm303_getAccelScale();
+}
+
+/**
+ * @brief   Returns last raw reading as a binary frame
+ * @ingroup acceleration
+ * @return  binary frame of raw counts and scale or NULL if uninitialized
+ */
+const unsigned char * Acceleration::toRawBinary(void) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                             this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Returns last reading as the next frame of a delta stream
+ * @ingroup acceleration
+ *
+ * Sends the raw counts (see `toRawBinary()`), so it works after both `read()`
+ * and `readRaw()`.
+ *
+ * @param   encoder the stream's encoder, see DeltaEncoder
+ * @return  keyframe or delta frame, or NULL if uninitialized
+ */
+const unsigned char * Acceleration::toDeltaBinary(DeltaEncoder & encoder) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToDelta(encoder, this->header.sensor_id, this->header.unit, this->header.timestamp,
+                            this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Enables or disables reading batches of samples from the sensor FIFO
+ * @ingroup acceleration
+ *
+ * In batch mode the LSM303 stores up to 32 samples in its FIFO, so no samples are
+ * lost while other sensors block `loop()`. Read them with `readBatch()`; `read()`
+ * returns the oldest stored sample while batch mode is enabled.
+ *
+ * Example Usage:
+ * @code
+ *     raw_xyz_t samples[DRIVER_FIFO_DEPTH];
+ *     accel.setBatchMode(true);
+ *     accel.begin();
+ *     uint8_t count = accel.readBatch(samples, DRIVER_FIFO_DEPTH);
+ * @endcode
+ *
+ * @param   enable true to store samples in the FIFO, false for single samples
+ * @retval  true  Successfully configured (or will be on `begin()`)
+ * @retval  false Failed to configure the sensor FIFO
+ */
+boolean Acceleration::setBatchMode(boolean enable) {
+  this->batchMode = enable;
+
+  if (this->initialized) {
+    return this->selectBus() && lsm303_accel_setFifo(enable);
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Reads all samples stored in the sensor FIFO in batch mode
+ * @ingroup acceleration
+ *
+ * Samples are raw counts, oldest first; multiply by `rawScale()` to get m/s^2.
+ * The newest sample is also stored in rawX, rawY and rawZ, and the timestamp is
+ * the time it was read.
+ *
+ * @param   samples array to store samples in
+ * @param   maxSamples size of the samples array
+ * @return  number of samples read, 0 if none or not in batch mode
+ */
+uint8_t Acceleration::readBatch(raw_xyz_t *samples, uint8_t maxSamples) {
+  uint8_t count;
+
+  if (!this->initialized || !this->batchMode || !this->selectBus()) {
+    return 0;
+  }
+
+  count = lsm303_accel_readFifo(samples, maxSamples);
+  if (count > 0) {
+    this->header.timestamp = millis();
+    this->rawX = samples[count - 1].x;
+    this->rawY = samples[count - 1].y;
+    this->rawZ = samples[count - 1].z;
+  }
+
+  return count;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs Gyro sensor object
@@ -505,7 +1971,7 @@ const char * Acceleration::toJSON(const char * sensorName) {
  * @endcode
  *****************************************************************************/
 Gyro::Gyro(void) :
-  range(0x20)
+  range(0x20), address(L3GD20_ADDRESS), batchMode(false), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_RADIAN_PER_SECOND, gyro_sensor_name);
 }
@@ -527,11 +1993,25 @@ Gyro::Gyro(void) :
  * @endcode
  */
 Gyro::Gyro(uint8_t range) :
-  range(range)
+  range(range), address(L3GD20_ADDRESS), batchMode(false), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_RADIAN_PER_SECOND, gyro_sensor_name);
 }
 
+/**
+ * @brief   Sets the I2C address of the L3GD20H, to read two on one bus
+ * @ingroup gyro
+ *
+ * Call before `begin()`.
+ *
+ * @param address
+ *     - 0x6B (L3GD20_ADDRESS) (Default)
+ *     - 0x6A (SA0 pulled low)
+ */
+void Gyro::setAddress(uint8_t address) {
+  this->address = address;
+}
+
 /**
  * @brief   Initializes the sensor with advanced configurations or defaults
  * @ingroup gyro
@@ -540,7 +2020,8 @@ Gyro::Gyro(uint8_t range) :
  * @retval false Failed to initialize
  */
 boolean Gyro::initialize(void) {
-  return l3gd20h_init(this->range);
+  return l3gd20h_init(this->address, this->range) &&
+    (!this->batchMode || l3gd20h_setFifo(this->address, true));
 }
 
 /**
@@ -551,7 +2032,23 @@ boolean Gyro::initialize(void) {
  * @retval false Failed to read
  */
 boolean Gyro::readSensor(void) {
-  l3gd20h_getOrientation(&(this->x), &(this->y), &(this->z));
+  float scale = this->rawScale();
+  raw_xyz_t sample;
+
+  l3gd20h_getRawAngularRates(this->address, &(sample.x), &(sample.y), &(sample.z));
+  if (!_filterRaw(this->filter, &sample)) {
+    this->pending = true;
+    return false;
+  }
+  this->rawX = sample.x;
+  this->rawY = sample.y;
+  this->rawZ = sample.z;
+  if (this->rawOnly) {
+    return true;
+  }
+  this->x = this->rawX * scale;
+  this->y = this->rawY * scale;
+  this->z = this->rawZ * scale;
   return true;
 }
 
@@ -578,13 +2075,193 @@ const char * Gyro::toCSV(const char * sensorName) {
  */
 const char * Gyro::toJSON(const char * sensorName) {
   if (this->header.timestamp != 0) {
-    return valuesToJSON(sensorName, this->header.unit, 3, "X", this->x,
-                        "Y", this->y, "Z", this->z);
+    return valuesToJSON_P(sensorName, this->header.unit, 3, json_label_x, this->x,
+                          json_label_y, this->y, json_label_z, this->z);
   } else {
     return "";
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup gyro
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Gyro::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          3, this->x, this->y, this->z);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Gyro::getValues(float * values) {
+  float scale = this->rawScale();
+
+  // From the raw counts, which readRaw() updates too
+  values[0] = this->rawX * scale;
+  values[1] = this->rawY * scale;
+  values[2] = this->rawZ * scale;
+  return 3;
+}
+
+/**
+ * @brief   Takes a reading of raw sensor counts without converting them
+ * @ingroup gyro
+ *
+ * Only rawX, rawY and rawZ are updated; x, y and z keep their last values.
+ * Multiply the raw counts by `rawScale()` to get rad/s, or send them with
+ * `toRawBinary()` and let the ground station do the conversion. Like `read()`,
+ * it's counted in `busErrors` and the timing, and checked by the report policy.
+ *
+ * @retval true  Successfully read raw values
+ * @retval false Sensor isn't initialized, failed to read, or a filter has no
+ *               new output yet (see `isPending()`)
+ */
+boolean Gyro::readRaw(void) {
+  return this->readRawCounts();
+}
+
+/**
+ * @brief   Filters and decimates readings before they're stored and printed
+ * @ingroup gyro
+ *
+ * With a filter, `read()` and `readRaw()` feed each sample through it and only
+ * return true when it has a new output, which replaces the raw and scaled
+ * values and the timestamp. For the other samples they return false with
+ * `isPending()` true, and leave the values alone. `poll()` (and so a SensorScheduler callback) likewise only finishes
+ * on outputs. Samples from `readBatch()` aren't filtered; pass them to the
+ * filter's `addBatch()`.
+ *
+ * @param   filter Filter to use, or NULL for none. It's reset when set.
+ */
+void Gyro::setFilter(DecimationFilter * filter) {
+  this->filter = filter;
+
+  if (filter != NULL) {
+    filter->reset();
+  }
+}
+
+#if ARDUSAT_DATA_READY
+/*
+ * Turns the sensor's data-ready output on or off, for attachDataReady
+ */
+boolean Gyro::setDataReady(boolean enable) {
+  return l3gd20h_setDataReady(this->address, enable);
+}
+#endif
+
+/**
+ * @brief   Gets the scale that converts raw counts to rad/s
+ * @ingroup gyro
+ * @return  rad/s per raw count for the configured range
+ */
+float Gyro::rawScale(void) {
+  return l3gd20h_getScale(this->range);
+}
+
+/**
+ * @brief   Returns last raw reading as a binary frame
+ * @ingroup gyro
+ * @return  binary frame of raw counts and scale or NULL if uninitialized
+ */
+const unsigned char * Gyro::toRawBinary(void) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                             this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Returns last reading as the next frame of a delta stream
+ * @ingroup gyro
+ *
+ * Sends the raw counts (see `toRawBinary()`), so it works after both `read()`
+ * and `readRaw()`.
+ *
+ * @param   encoder the stream's encoder, see DeltaEncoder
+ * @return  keyframe or delta frame, or NULL if uninitialized
+ */
+const unsigned char * Gyro::toDeltaBinary(DeltaEncoder & encoder) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToDelta(encoder, this->header.sensor_id, this->header.unit, this->header.timestamp,
+                            this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Enables or disables reading batches of samples from the sensor FIFO
+ * @ingroup gyro
+ *
+ * In batch mode the L3GD20H stores up to 32 samples in its FIFO, so no samples are
+ * lost while other sensors block `loop()`. Read them with `readBatch()`; `read()`
+ * returns the oldest stored sample while batch mode is enabled.
+ *
+ * Example Usage:
+ * @code
+ *     raw_xyz_t samples[DRIVER_FIFO_DEPTH];
+ *     gyro.setBatchMode(true);
+ *     gyro.begin();
+ *     uint8_t count = gyro.readBatch(samples, DRIVER_FIFO_DEPTH);
+ * @endcode
+ *
+ * @param   enable true to store samples in the FIFO, false for single samples
+ * @retval  true  Successfully configured (or will be on `begin()`)
+ * @retval  false Failed to configure the sensor FIFO
+ */
+boolean Gyro::setBatchMode(boolean enable) {
+  this->batchMode = enable;
+
+  if (this->initialized) {
+    return this->selectBus() && l3gd20h_setFifo(this->address, enable);
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Reads all samples stored in the sensor FIFO in batch mode
+ * @ingroup gyro
+ *
+ * Samples are raw counts, oldest first; multiply by `rawScale()` to get rad/s.
+ * The newest sample is also stored in rawX, rawY and rawZ, and the timestamp is
+ * the time it was read.
+ *
+ * @param   samples array to store samples in
+ * @param   maxSamples size of the samples array
+ * @return  number of samples read, 0 if none or not in batch mode
+ */
+uint8_t Gyro::readBatch(raw_xyz_t *samples, uint8_t maxSamples) {
+  uint8_t count;
+
+  if (!this->initialized || !this->batchMode || !this->selectBus()) {
+    return 0;
+  }
+
+  count = l3gd20h_readFifo(this->address, samples, maxSamples);
+  if (count > 0) {
+    this->header.timestamp = millis();
+    this->rawX = samples[count - 1].x;
+    this->rawY = samples[count - 1].y;
+    this->rawZ = samples[count - 1].z;
+  }
+
+  return count;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs Luminosity sensor object
@@ -599,7 +2276,9 @@ const char * Gyro::toJSON(const char * sensorName) {
  *****************************************************************************/
 Luminosity::Luminosity(void) :
   gain(TSL2561_GAIN_1X),
-  intTime(TSL2561_INTEGRATIONTIME_13MS)
+  intTime(TSL2561_INTEGRATIONTIME_13MS),
+  powerMode(POWER_MODE_LOW_POWER),
+  address(0)
 {
   this->initializeHeader(SENSORID_TSL2561, DATA_UNIT_LUX, luminosity_sensor_name);
 }
@@ -625,7 +2304,9 @@ Luminosity::Luminosity(void) :
  */
 Luminosity::Luminosity(tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain) :
   gain(gain),
-  intTime(intTime)
+  intTime(intTime),
+  powerMode(POWER_MODE_LOW_POWER),
+  address(0)
 {
   this->initializeHeader(SENSORID_TSL2561, DATA_UNIT_LUX, luminosity_sensor_name);
 }
@@ -651,7 +2332,9 @@ Luminosity::Luminosity(tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain) :
  */
 Luminosity::Luminosity(tsl2561Gain_t gain, tsl2561IntegrationTime_t intTime) :
   gain(gain),
-  intTime(intTime)
+  intTime(intTime),
+  powerMode(POWER_MODE_LOW_POWER),
+  address(0)
 {
   this->initializeHeader(SENSORID_TSL2561, DATA_UNIT_LUX, luminosity_sensor_name);
 }
@@ -674,7 +2357,9 @@ Luminosity::Luminosity(tsl2561Gain_t gain, tsl2561IntegrationTime_t intTime) :
  */
 Luminosity::Luminosity(tsl2561IntegrationTime_t intTime) :
   gain(TSL2561_GAIN_1X),
-  intTime(intTime)
+  intTime(intTime),
+  powerMode(POWER_MODE_LOW_POWER),
+  address(0)
 {
   this->initializeHeader(SENSORID_TSL2561, DATA_UNIT_LUX, luminosity_sensor_name);
 }
@@ -696,7 +2381,9 @@ Luminosity::Luminosity(tsl2561IntegrationTime_t intTime) :
  */
 Luminosity::Luminosity(tsl2561Gain_t gain) :
   gain(gain),
-  intTime(TSL2561_INTEGRATIONTIME_13MS)
+  intTime(TSL2561_INTEGRATIONTIME_13MS),
+  powerMode(POWER_MODE_LOW_POWER),
+  address(0)
 {
   this->initializeHeader(SENSORID_TSL2561, DATA_UNIT_LUX, luminosity_sensor_name);
 }
@@ -709,21 +2396,98 @@ Luminosity::Luminosity(tsl2561Gain_t gain) :
  * @retval false Failed to initialize
  */
 boolean Luminosity::initialize(void) {
-  return tsl2561_init(this->intTime, this->gain);
+  if (!tsl2561_init(this->device, this->address, this->intTime, this->gain)) {
+    return false;
+  }
+
+  this->rangeGain = this->gain;
+  this->rangeIntTime = this->intTime;
+  tsl2561_setContinuous(this->device, this->powerMode == POWER_MODE_CONTINUOUS);
+  return true;
+}
+
+/**
+ * @brief   Chooses between keeping the sensor integrating and powering it up
+ *          for each reading
+ * @ingroup luminosity
+ *
+ * In continuous mode, `read()` returns the last completed integration without
+ * waiting, at the cost of about 0.24 mA drawn by the sensor all the time.
+ *
+ * @param mode
+ *     - POWER_MODE_LOW_POWER (Default)
+ *     - POWER_MODE_CONTINUOUS
+ */
+void Luminosity::setPowerMode(power_mode_t mode) {
+  this->powerMode = mode;
+
+  if (this->initialized && this->selectBus()) {
+    tsl2561_setContinuous(this->device, mode == POWER_MODE_CONTINUOUS);
+  }
+}
+
+/**
+ * @brief   Sets the I2C address of the TSL2561, for a sensor that isn't at the
+ *          board's default address or to read several at once
+ * @ingroup luminosity
+ *
+ * Call before `begin()`.
+ *
+ * @param address
+ *     - 0 (Default) for the board's default address
+ *     - TSL2561_ADDR_LOW (0x29)
+ *     - TSL2561_ADDR_FLOAT (0x39)
+ *     - TSL2561_ADDR_HIGH (0x49)
+ */
+void Luminosity::setAddress(uint8_t address) {
+  this->address = address;
 }
 
 /**
  * @brief   Takes a reading from the sensor
  * @ingroup luminosity
  *
+ * Each reading takes a single integration. Auto-range uses it to pick the
+ * gain and integration time of the next one, never integrating for longer
+ * than the configured time; `rangeGain` and `rangeIntTime` hold the range
+ * this reading was taken at.
+ *
  * @retval true  Successfully read
  * @retval false Failed to read
  */
 boolean Luminosity::readSensor(void) {
-  this->lux = tsl2561_getLux();
+  this->lux = tsl2561_getLux(this->device);
+  tsl2561_getRange(this->device, &(this->rangeIntTime), &(this->rangeGain));
   return true;
 }
 
+/**
+ * @brief   Runs one step of a split-phase reading
+ * @ingroup luminosity
+ *
+ * Starts an integration cycle, then reads it once the integration time has
+ * passed. In continuous mode there is nothing to start, so the read happens
+ * at once.
+ *
+ * @param   step Index of the step to run
+ * @return  ms to wait before the next step or SENSOR_READ_COMPLETE
+ */
+long Luminosity::readSensorStep(uint8_t step) {
+  unsigned int wait;
+
+  if (step == 0) {
+    return tsl2561_startLux(this->device);
+  }
+
+  wait = tsl2561_finishLux(this->device, &(this->lux));
+  if (wait) {
+    return (long) wait;
+  }
+
+  tsl2561_getRange(this->device, &(this->rangeIntTime), &(this->rangeGain));
+  return SENSOR_READ_COMPLETE;
+}
+
 /**
  * @brief   Returns last read value in CSV format
  * @ingroup luminosity
@@ -744,14 +2508,36 @@ const char * Luminosity::toCSV(const char * sensorName) {
  * @param   sensorName The text to display next to the value
  * @return  sensor readings in JSON format or empty string if uninitialized
  */
-const char * Luminosity::toJSON(const char * sensorName) {
+const char * Luminosity::toJSON(const char * sensorName) {
+  if (this->header.timestamp != 0) {
+    return valueToJSON(sensorName, this->header.unit, this->lux);
+  } else {
+    return "";
+  }
+}
+
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup luminosity
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Luminosity::toBinary(void) {
   if (this->header.timestamp != 0) {
-    return valueToJSON(sensorName, this->header.unit, this->lux);
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          1, this->lux);
   } else {
-    return "";
+    return NULL;
   }
 }
 
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Luminosity::getValues(float * values) {
+  values[0] = this->lux;
+  return 1;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs Magnetic sensor object
@@ -765,7 +2551,7 @@ const char * Luminosity::toJSON(const char * sensorName) {
  * @endcode
  *****************************************************************************/
 Magnetic::Magnetic(void) :
-  gaussScale(LSM303_MAG_SCALE4GAUSS)
+  gaussScale(LSM303_MAG_SCALE4GAUSS), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_MICROTESLA, magnetic_sensor_name);
 }
@@ -792,7 +2578,7 @@ Magnetic::Magnetic(void) :
  * @endcode
  */
 Magnetic::Magnetic(lsm303_mag_scale_e gaussScale) :
-  gaussScale(gaussScale)
+  gaussScale(gaussScale), filter(NULL), rawX(0), rawY(0), rawZ(0)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_MICROTESLA, magnetic_sensor_name);
 }
@@ -816,7 +2602,23 @@ boolean Magnetic::initialize(void) {
  * @retval false Failed to read
  */
 boolean Magnetic::readSensor(void) {
-  lsm303_getMag(&(this->x), &(this->y), &(this->z));
+  float scale = this->rawScale();
+  raw_xyz_t sample;
+
+  lsm303_getRawMag(&(sample.x), &(sample.y), &(sample.z));
+  if (!_filterRaw(this->filter, &sample)) {
+    this->pending = true;
+    return false;
+  }
+  this->rawX = sample.x;
+  this->rawY = sample.y;
+  this->rawZ = sample.z;
+  if (this->rawOnly) {
+    return true;
+  }
+  this->x = this->rawX * scale;
+  this->y = this->rawY * scale;
+  this->z = this->rawZ * scale;
   return true;
 }
 
@@ -843,13 +2645,177 @@ const char * Magnetic::toCSV(const char * sensorName) {
  */
 const char * Magnetic::toJSON(const char * sensorName) {
   if (this->header.timestamp != 0) {
-    return valuesToJSON(sensorName, this->header.unit, 3, "X", this->x,
-                        "Y", this->y, "Z", this->z);
+    return valuesToJSON_P(sensorName, this->header.unit, 3, json_label_x, this->x,
+                          json_label_y, this->y, json_label_z, this->z);
   } else {
     return "";
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup magnetic
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Magnetic::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          3, this->x, this->y, this->z);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Magnetic::getValues(float * values) {
+  float scale = this->rawScale();
+
+  // From the raw counts, which readRaw() updates too
+  values[0] = this->rawX * scale;
+  values[1] = this->rawY * scale;
+  values[2] = this->rawZ * scale;
+  return 3;
+}
+
+/**
+ * @brief   Takes a reading of raw sensor counts without converting them
+ * @ingroup magnetic
+ *
+ * Only rawX, rawY and rawZ are updated; x, y and z keep their last values.
+ * Multiply the raw counts by `rawScale()` to get uT, or send them with
+ * `toRawBinary()` and let the ground station do the conversion. Like `read()`,
+ * it's counted in `busErrors` and the timing, and checked by the report policy.
+ *
+ * @retval true  Successfully read raw values
+ * @retval false Sensor isn't initialized, failed to read, or a filter has no
+ *               new output yet (see `isPending()`)
+ */
+boolean Magnetic::readRaw(void) {
+  return this->readRawCounts();
+}
+
+/**
+ * @brief   Filters and decimates readings before they're stored and printed
+ * @ingroup magnetic
+ *
+ * With a filter, `read()` and `readRaw()` feed each sample through it and only
+ * return true when it has a new output, which replaces the raw and scaled
+ * values and the timestamp. For the other samples they return false with
+ * `isPending()` true, and leave the values alone. `poll()` (and so a SensorScheduler callback) likewise only finishes
+ * on outputs. Samples from `readBatch()` aren't filtered; pass them to the
+ * filter's `addBatch()`.
+ *
+ * @param   filter Filter to use, or NULL for none. It's reset when set.
+ */
+void Magnetic::setFilter(DecimationFilter * filter) {
+  this->filter = filter;
+
+  if (filter != NULL) {
+    filter->reset();
+  }
+}
+
+#if ARDUSAT_DATA_READY
+/*
+ * Turns the sensor's data-ready output on or off, for attachDataReady
+ */
+boolean Magnetic::setDataReady(boolean enable) {
+  return lsm303_mag_setDataReady(enable);
+}
+#endif
+
+/**
+ * @brief   Gets the scale that converts raw counts to uT
+ * @ingroup magnetic
+ * @return  uT per raw count for the configured gauss scale
+ */
+float Magnetic::rawScale(void) {
+  return lsm303_getMagScale();
+}
+
+/**
+ * @brief   Returns last raw reading as a binary frame
+ * @ingroup magnetic
+ * @return  binary frame of raw counts and scale or NULL if uninitialized
+ */
+const unsigned char * Magnetic::toRawBinary(void) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                             this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+/**
+ * @brief   Returns last reading as the next frame of a delta stream
+ * @ingroup magnetic
+ *
+ * Sends the raw counts (see `toRawBinary()`), so it works after both `read()`
+ * and `readRaw()`.
+ *
+ * @param   encoder the stream's encoder, see DeltaEncoder
+ * @return  keyframe or delta frame, or NULL if uninitialized
+ */
+const unsigned char * Magnetic::toDeltaBinary(DeltaEncoder & encoder) {
+  int16_t raw[3] = {this->rawX, this->rawY, this->rawZ};
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToDelta(encoder, this->header.sensor_id, this->header.unit, this->header.timestamp,
+                            this->rawScale(), 3, raw);
+  } else {
+    return NULL;
+  }
+}
+
+
+/**
+ * Approximates atan2 to within 0.22 degrees, several times faster than the
+ * soft-float atan2 on AVR.
+ */
+static float _fastAtan2(float y, float x) {
+  const float PI_F = 3.141592653F;
+  float absX = fabs(x);
+  float absY = fabs(y);
+  float ratio;
+  float angle;
+
+  if (absX == 0 && absY == 0) {
+    return 0;
+  }
+
+  ratio = absX > absY ? absY / absX : absX / absY;
+  angle = ratio * (PI_F / 4 + 0.273F * (1 - ratio));
+
+  if (absY > absX) {
+    angle = PI_F / 2 - angle;
+  }
+  if (x < 0) {
+    angle = PI_F - angle;
+  }
+  if (y < 0) {
+    angle = -angle;
+  }
+
+  return angle;
+}
+
+static float _atan2(float y, float x) {
+  return (float) atan2(y, x);
+}
+
+/**
+ * Checks whether a sensor was read recently enough that its values can be reused.
+ */
+static boolean _isFresh(const Sensor *sensor, unsigned long maxAge) {
+  return maxAge > 0 && sensor->header.timestamp != 0 &&
+    (millis() - sensor->header.timestamp) <= maxAge;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs Orientation calculation object using provided Acceleration and Magnetic objects
@@ -866,7 +2832,9 @@ const char * Magnetic::toJSON(const char * sensorName) {
  *****************************************************************************/
 Orientation::Orientation(Acceleration & accel, Magnetic & mag) :
   accel(&accel),
-  mag(&mag)
+  mag(&mag),
+  maxSampleAge(0),
+  fastTrig(false)
 {
   this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_DEGREES, orientation_sensor_name);
 }
@@ -882,17 +2850,74 @@ boolean Orientation::initialize(void) {
   return accel->initialized && mag->initialized;
 }
 
+/**
+ * @brief   Reuses accelerometer and magnetometer readings that are recent enough
+ * @ingroup orientation
+ *
+ * By default every orientation reading reads both the Acceleration and Magnetic
+ * sensors. If the sketch reads them itself anyway, setting a maximum sample age
+ * lets orientation readings reuse those values instead of reading the LSM303
+ * again.
+ *
+ * Example Usage:
+ * @code
+ *     orient.setMaxSampleAge(500);                      // Reuse readings up to 500 ms old
+ *     Serial.println(accel.readToJSON("accel"));
+ *     Serial.println(mag.readToJSON("mag"));
+ *     Serial.println(orient.readToJSON("orientation")); // No extra I2C reads
+ * @endcode
+ *
+ * @param   maxAge maximum age of a reading in milliseconds, 0 to always read
+ */
+void Orientation::setMaxSampleAge(unsigned long maxAge) {
+  this->maxSampleAge = maxAge;
+}
+
+/**
+ * @brief   Uses a faster, approximate atan2 for the orientation calculation
+ * @ingroup orientation
+ *
+ * The approximation is accurate to within 0.22 degrees, which is well below the
+ * noise of the LSM303.
+ *
+ * @param   enable true to use the approximation, false for the math library atan2
+ */
+void Orientation::setFastTrig(boolean enable) {
+  this->fastTrig = enable;
+}
+
 /**
  * @brief   Takes a reading from the sensor
  * @ingroup orientation
  *
+ * The angles are calculated from the raw sensor counts, which works the same as
+ * using the scaled values because every axis of a sensor has the same scale. This
+ * also makes orientation readings work after `readRaw()` or `readBatch()`.
+ *
  * @retval true  Successfully read
  * @retval false Failed to read
  */
 boolean Orientation::readSensor(void) {
-  this->accel->read();
-  this->mag->read();
+  if (!_isFresh(this->accel, this->maxSampleAge)) {
+    this->accel->read();
+  }
+  if (!_isFresh(this->mag, this->maxSampleAge)) {
+    this->mag->read();
+  }
 
+  float (*arctan2)(float, float) = this->fastTrig ? _fastAtan2 : _atan2;
+  float ax = this->accel->rawX;
+  float ay = this->accel->rawY;
+  float az = this->accel->rawZ;
+  float mx = this->mag->rawX;
+  float my = this->mag->rawY;
+  float mz = this->mag->rawZ;
+  float yz;
+  float xyz;
+  float sinRoll;
+  float cosRoll;
+  float sinPitch;
+  float cosPitch;
   float roll;
   float pitch;
   float heading;
@@ -900,26 +2925,43 @@ boolean Orientation::readSensor(void) {
 
   // Roll is rotation around x-axis (-180 <= roll <= 180)
   // Positive roll is clockwise rotation wrt positive x axis
-  roll = (float) atan2(this->accel->y, this->accel->z);
+  //
+  // sin/cos of the roll come straight from the y and z acceleration, instead of
+  // calling sin() and cos() on the angle again
+  roll = arctan2(ay, az);
+  yz = sqrt(ay * ay + az * az);
+  if (yz == 0) {
+    sinRoll = 0;
+    cosRoll = 1;
+  } else {
+    sinRoll = ay / yz;
+    cosRoll = az / yz;
+  }
 
   // Pitch is rotation around y-axis (-180 <= pitch <= 180)
   // Positive pitch is clockwise rotation wrt positive y axis
-  if (this->accel->y * sin(roll) + this->accel->z * cos(roll) == 0) {
-    pitch = this->accel->x > 0 ? (PI_F / 2) : (-PI_F / 2);
+  //
+  // ay * sin(roll) + az * cos(roll) simplifies to yz
+  if (yz == 0) {
+    pitch = ax > 0 ? (PI_F / 2) : (-PI_F / 2);
+    sinPitch = ax > 0 ? 1 : -1;
+    cosPitch = 0;
   } else {
-    pitch = (float)atan(-this->accel->x / (this->accel->y * sin(roll) + this->accel->z * cos(roll)));
+    pitch = arctan2(-ax, yz);
+    xyz = sqrt(ax * ax + yz * yz);
+    sinPitch = -ax / xyz;
+    cosPitch = yz / xyz;
   }
 
   // Heading is rotation around z-axis
   // Positive heading is clockwise rotation wrt positive z axis
-  heading = (float)atan2(this->mag->z * sin(roll) - this->mag->y * cos(roll),
-                         this->mag->x * cos(pitch) + this->mag->y * sin(pitch) * sin(roll) +
-                         this->mag->z * sin(pitch) * cos(roll));
+  heading = arctan2(mz * sinRoll - my * cosRoll,
+                    mx * cosPitch + my * sinPitch * sinRoll + mz * sinPitch * cosRoll);
 
   // Convert radians to degrees
-  this->roll = roll * 180 / PI_F;
-  this->pitch = pitch * 180 / PI_F;
-  this->heading = heading * 180 / PI_F;
+  this->roll = roll * (180 / PI_F);
+  this->pitch = pitch * (180 / PI_F);
+  this->heading = heading * (180 / PI_F);
 
   this->header.timestamp = max(this->accel->header.timestamp, this->mag->header.timestamp);
   return true;
@@ -933,28 +2975,342 @@ boolean Orientation::readSensor(void) {
  */
 const char * Orientation::toCSV(const char * sensorName) {
   if (this->header.timestamp != 0) {
-    return valuesToCSV(sensorName, this->header.timestamp, 3,
-                       this->roll, this->pitch, this->heading);
+    return valuesToCSV(sensorName, this->header.timestamp, 3,
+                       this->roll, this->pitch, this->heading);
+  } else {
+    return "";
+  }
+}
+
+/**
+ * @brief   Returns last read value in JSON format
+ * @ingroup orientation
+ * @param   sensorName The text to display next to the value
+ * @return  sensor readings in JSON format or empty string if uninitialized
+ */
+const char * Orientation::toJSON(const char * sensorName) {
+  if (this->header.timestamp != 0) {
+    return valuesToJSON_P(sensorName, this->header.unit, 3, json_label_roll, this->roll,
+                          json_label_pitch, this->pitch, json_label_heading, this->heading);
+  } else {
+    return "";
+  }
+}
+
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup orientation
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Orientation::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          3, this->roll, this->pitch, this->heading);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Orientation::getValues(float * values) {
+  values[0] = this->roll;
+  values[1] = this->pitch;
+  values[2] = this->heading;
+  return 3;
+}
+
+
+/**************************************************************************//**
+ * @brief   Constructs FusedOrientation object using provided Gyro, Acceleration and Magnetic objects
+ * @ingroup fusedorientation
+ *
+ * Example Usage:
+ * @code
+ *     Gyro gyro;
+ *     Acceleration accel;
+ *     Magnetic mag;
+ *     FusedOrientation fused(gyro, accel, mag);     // Instantiate sensor object
+ *     fused.begin();                                // Initialize sensor
+ *     Serial.println(fused.readToJSON("attitude")); // Read and print values in JSON
+ * @endcode
+ *****************************************************************************/
+FusedOrientation::FusedOrientation(Gyro & gyro, Acceleration & accel, Magnetic & mag) :
+  gyro(&gyro),
+  accel(&accel),
+  mag(&mag),
+  magInterval(FUSION_MAG_INTERVAL_MS),
+  lastMag(0),
+  lastUpdate(0),
+  samplePeriod(FUSION_GYRO_PERIOD_US),
+  qw(1),
+  qx(0),
+  qy(0),
+  qz(0),
+  roll(0),
+  pitch(0),
+  heading(0)
+{
+  this->initializeHeader(SENSORID_ADAFRUIT9DOFIMU, DATA_UNIT_DEGREES, fused_orientation_sensor_name);
+}
+
+/**
+ * @brief   Initializes the sensor with any set configurations or defaults
+ * @ingroup fusedorientation
+ *
+ * The gyro and accelerometer have to be initialized first. Without the
+ * magnetometer the heading is only tracked by the gyro, and drifts.
+ *
+ * @retval true  Successfully initialized
+ * @retval false Failed to initialize
+ */
+boolean FusedOrientation::initialize(void) {
+  if (!this->gyro->initialized || !this->accel->initialized) {
+    return false;
+  }
+
+  this->filter.setGyroScale(this->gyro->rawScale());
+  this->reset();
+  return true;
+}
+
+/**
+ * @brief   Sets how hard the accelerometer and magnetometer correct the gyro
+ * @ingroup fusedorientation
+ *
+ * A higher kp follows the accelerometer and magnetometer more closely, noise
+ * and all; a lower one trusts the gyro for longer. ki > 0 also learns and takes
+ * out a constant gyro bias. The defaults are FUSION_DEFAULT_KP and
+ * FUSION_DEFAULT_KI.
+ *
+ * @param   kp proportional gain, rad/s per unit of error
+ * @param   ki integral gain, rad/s^2 per unit of error
+ */
+void FusedOrientation::setGains(float kp, float ki) {
+  this->filter.setGains(kp, ki);
+}
+
+/**
+ * @brief   Sets how often the magnetometer is read
+ * @ingroup fusedorientation
+ *
+ * The heading drifts slowly, so it only needs correcting a few times a second.
+ * A magnetometer reading the sketch takes itself within the interval is used
+ * instead of reading it again.
+ *
+ * @param   interval ms between magnetometer readings, 0 to read it every time
+ */
+void FusedOrientation::setMagInterval(unsigned long interval) {
+  this->magInterval = interval;
+}
+
+/**
+ * @brief   Starts tracking again from the current accelerometer and magnetometer
+ * @ingroup fusedorientation
+ */
+void FusedOrientation::reset(void) {
+  this->filter.reset();
+  this->lastMag = 0;
+  this->lastUpdate = 0;
+  this->samplePeriod = FUSION_GYRO_PERIOD_US;
+}
+
+/*
+ * Passes the filter the mean of the accelerometer samples since the last
+ * reading, or a single new sample outside batch mode
+ */
+void FusedOrientation::updateAccel(void) {
+  raw_xyz_t samples[FUSION_BATCH_SAMPLES];
+  int32_t sum[3] = {0, 0, 0};
+  uint8_t total = 0;
+  uint8_t count;
+
+  if (!this->accel->getBatchMode()) {
+    if (this->accel->readRaw()) {
+      this->filter.setAccel(this->accel->rawX, this->accel->rawY, this->accel->rawZ);
+    }
+    return;
+  }
+
+  do {
+    count = this->accel->readBatch(samples, FUSION_BATCH_SAMPLES);
+    for (uint8_t i = 0; i < count; ++i) {
+      sum[0] += samples[i].x;
+      sum[1] += samples[i].y;
+      sum[2] += samples[i].z;
+    }
+    total += count;
+  } while (count == FUSION_BATCH_SAMPLES && total < DRIVER_FIFO_DEPTH);
+
+  if (total > 0) {
+    this->filter.setAccel(sum[0] / total, sum[1] / total, sum[2] / total);
+  }
+}
+
+/*
+ * Passes the filter a magnetometer reading once every magInterval ms
+ */
+void FusedOrientation::updateMag(void) {
+  if (!this->mag->initialized) {
+    return;
+  }
+
+  if (!_isFresh(this->mag, this->magInterval) && !this->mag->readRaw()) {
+    this->filter.clearMag();
+    return;
+  }
+
+  if (this->mag->header.timestamp != this->lastMag) {
+    this->filter.setMag(this->mag->rawX, this->mag->rawY, this->mag->rawZ);
+    this->lastMag = this->mag->header.timestamp;
+  }
+}
+
+/*
+ * Runs a filter update for each gyro sample since the last reading
+ *
+ * In batch mode the sample period is measured from the time between readings,
+ * except when the FIFO overflowed and samples were lost.
+ *
+ * @param elapsed us since the last reading, 0 for the first
+ * @return number of gyro samples
+ */
+uint8_t FusedOrientation::updateGyro(unsigned long elapsed) {
+  raw_xyz_t samples[FUSION_BATCH_SAMPLES];
+  uint8_t total = 0;
+  uint8_t count;
+
+  if (!this->gyro->getBatchMode()) {
+    if (!this->gyro->readRaw()) {
+      return 0;
+    }
+    this->filter.update(this->gyro->rawX, this->gyro->rawY, this->gyro->rawZ, elapsed);
+    return 1;
+  }
+
+  do {
+    count = this->gyro->readBatch(samples, FUSION_BATCH_SAMPLES);
+    for (uint8_t i = 0; i < count; ++i) {
+      this->filter.update(samples[i].x, samples[i].y, samples[i].z, this->samplePeriod);
+    }
+    total += count;
+  } while (count == FUSION_BATCH_SAMPLES && total < DRIVER_FIFO_DEPTH);
+
+  if (elapsed > 0 && total > 0 && total < DRIVER_FIFO_DEPTH) {
+    long error = (long) (elapsed / total) - (long) this->samplePeriod;
+
+    this->samplePeriod += error / 8;
+  }
+
+  return total;
+}
+
+/**
+ * @brief   Takes a reading from the sensor
+ * @ingroup fusedorientation
+ *
+ * Reads the accelerometer, the magnetometer if it's due, then every new gyro
+ * sample, and runs the filter. Only the Euler angles of the result are worked
+ * out in float, once per reading.
+ *
+ * @retval true  Successfully read
+ * @retval false Failed to read, or no accelerometer reading to start from yet
+ */
+boolean FusedOrientation::readSensor(void) {
+  unsigned long now = micros();
+  unsigned long elapsed = this->lastUpdate != 0 ? now - this->lastUpdate : 0;
+  float roll;
+  float pitch;
+  float heading;
+  const float PI_F = 3.141592653F;
+
+  this->lastUpdate = now;
+
+  this->updateAccel();
+  this->updateMag();
+  this->updateGyro(elapsed);
+
+  if (!this->filter.aligned()) {
+    return false;
+  }
+
+  this->filter.getEuler(&roll, &pitch, &heading);
+  this->roll = roll * (180 / PI_F);
+  this->pitch = pitch * (180 / PI_F);
+  this->heading = heading * (180 / PI_F);
+
+  this->qw = this->filter.q[0] / (float) FUSION_ONE;
+  this->qx = this->filter.q[1] / (float) FUSION_ONE;
+  this->qy = this->filter.q[2] / (float) FUSION_ONE;
+  this->qz = this->filter.q[3] / (float) FUSION_ONE;
+
+  this->header.timestamp = this->gyro->header.timestamp;
+  return true;
+}
+
+/**
+ * @brief   Returns last read value in CSV format
+ * @ingroup fusedorientation
+ *
+ * The values are the quaternion w, x, y and z, then roll, pitch and heading.
+ *
+ * @param   sensorName The text to display next to the value
+ * @return  sensor readings in CSV format or empty string if uninitialized
+ */
+const char * FusedOrientation::toCSV(const char * sensorName) {
+  if (this->header.timestamp != 0) {
+    return valuesToCSV(sensorName, this->header.timestamp, 7,
+                       this->qw, this->qx, this->qy, this->qz,
+                       this->roll, this->pitch, this->heading);
+  } else {
+    return "";
+  }
+}
+
+/**
+ * @brief   Returns last read value in JSON format
+ * @ingroup fusedorientation
+ * @param   sensorName The text to display next to the value
+ * @return  sensor readings in JSON format or empty string if uninitialized
+ */
+const char * FusedOrientation::toJSON(const char * sensorName) {
+  if (this->header.timestamp != 0) {
+    return valuesToJSON_P(sensorName, this->header.unit, 7, json_label_qw, this->qw,
+                          json_label_qx, this->qx, json_label_qy, this->qy, json_label_qz, this->qz,
+                          json_label_roll, this->roll, json_label_pitch, this->pitch,
+                          json_label_heading, this->heading);
   } else {
     return "";
   }
 }
 
 /**
- * @brief   Returns last read value in JSON format
- * @ingroup orientation
- * @param   sensorName The text to display next to the value
- * @return  sensor readings in JSON format or empty string if uninitialized
+ * @brief   Returns last read value as a binary frame
+ * @ingroup fusedorientation
+ * @return  binary frame of sensor readings, in the same order as toCSV(), or
+ *          NULL if uninitialized
  */
-const char * Orientation::toJSON(const char * sensorName) {
+const unsigned char * FusedOrientation::toBinary(void) {
   if (this->header.timestamp != 0) {
-    return valuesToJSON(sensorName, this->header.unit, 3, "Roll", this->roll,
-                        "Pitch", this->pitch, "Heading", this->heading);
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          7, this->qw, this->qx, this->qy, this->qz,
+                          this->roll, this->pitch, this->heading);
   } else {
-    return "";
+    return NULL;
   }
 }
 
+/*
+ * Gets the last read angles, for the report policy
+ */
+uint8_t FusedOrientation::getValues(float * values) {
+  values[0] = this->roll;
+  values[1] = this->pitch;
+  values[2] = this->heading;
+  return 3;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs Pressure object
@@ -968,7 +3324,9 @@ const char * Orientation::toJSON(const char * sensorName) {
  * @endcode
  *****************************************************************************/
 Pressure::Pressure(void) :
-  bmp085_mode(BMP085_MODE_ULTRAHIGHRES)
+  bmp085_mode(BMP085_MODE_ULTRAHIGHRES),
+  tempSamples(1),
+  tempThreshold(0)
 {
   this->initializeHeader(SENSORID_BMP180, DATA_UNIT_HECTOPASCAL, pressure_sensor_name);
 }
@@ -991,7 +3349,9 @@ Pressure::Pressure(void) :
  * @endcode
  */
 Pressure::Pressure(bmp085_mode_t mode) :
-  bmp085_mode(mode)
+  bmp085_mode(mode),
+  tempSamples(1),
+  tempThreshold(0)
 {
   this->initializeHeader(SENSORID_BMP180, DATA_UNIT_HECTOPASCAL, pressure_sensor_name);
 }
@@ -1004,11 +3364,43 @@ Pressure::Pressure(bmp085_mode_t mode) :
  * @retval false Failed to initialize
  */
 boolean Pressure::initialize(void) {
-  if (ARDUSAT_SPACEBOARD) {
+  if (BOARD_IS_SPACEBOARD()) {
     _writeErrorMessage(unavailable_on_hardware_error_msg, pressure_sensor_name, spaceboard_hardware_name);
   }
 
-  return bmp180_init(this->bmp085_mode) && (!ARDUSAT_SPACEBOARD || MANUAL_CONFIG);
+  if (!bmp180_init(this->bmp085_mode)) {
+    return false;
+  }
+
+  bmp180_setTemperatureRefresh(this->tempSamples, this->tempThreshold);
+  return !BOARD_IS_SPACEBOARD() || MANUAL_CONFIG;
+}
+
+/**
+ * @brief   Reuses the temperature compensation for several pressure samples
+ * @ingroup pressure
+ *
+ * Every pressure reading normally starts with a 5 ms temperature conversion.
+ * Temperature changes much more slowly than pressure, so this only converts
+ * it every `samples` readings, and on the next reading as well whenever it
+ * has moved by more than `threshold` since the last conversion. In
+ * BMP085_MODE_STANDARD that takes a reading from 13 ms to 8 ms.
+ *
+ * Example Usage:
+ * @code
+ *     press.setTemperatureRefresh(10, 0.5); // every 10 samples, or sooner on 0.5 C changes
+ * @endcode
+ *
+ * @param samples Pressure readings per temperature conversion (Default 1, every reading)
+ * @param threshold Temperature change in degrees C that refreshes it sooner, 0 to never
+ */
+void Pressure::setTemperatureRefresh(uint8_t samples, float threshold) {
+  this->tempSamples = samples;
+  this->tempThreshold = threshold;
+
+  if (this->initialized) {
+    bmp180_setTemperatureRefresh(samples, threshold);
+  }
 }
 
 /**
@@ -1019,8 +3411,41 @@ boolean Pressure::initialize(void) {
  * @retval false Failed to read
  */
 boolean Pressure::readSensor(void) {
-  bmp180_getPressure(&(this->pressure));
-  return true;
+  return bmp180_getPressure(&(this->pressure));
+}
+
+/**
+ * @brief   Runs one step of a split-phase reading
+ * @ingroup pressure
+ *
+ * Starts a temperature conversion, then a pressure conversion, then reads
+ * the compensated pressure. The temperature conversion is skipped when the
+ * last one can be reused (see setTemperatureRefresh()).
+ *
+ * @param   step Index of the step to run
+ * @return  ms to wait before the next step, SENSOR_READ_COMPLETE or SENSOR_READ_FAILED
+ */
+long Pressure::readSensorStep(uint8_t step) {
+  unsigned int wait;
+
+  switch (step) {
+    case 0:
+      if (!bmp180_temperatureDue()) {
+        return 0;
+      }
+      wait = bmp180_startTemperature();
+      break;
+    case 1:
+      if (bmp180_temperatureDue() && !bmp180_finishTemperature()) {
+        return SENSOR_READ_FAILED;
+      }
+      wait = bmp180_startPressure();
+      break;
+    default:
+      return bmp180_finishPressure(&(this->pressure)) ? SENSOR_READ_COMPLETE : SENSOR_READ_FAILED;
+  }
+
+  return wait ? (long) wait : SENSOR_READ_FAILED;
 }
 
 /**
@@ -1087,6 +3512,28 @@ const char * Pressure::toJSON(const char * sensorName) {
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup pressure
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Pressure::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          1, this->pressure);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Pressure::getValues(float * values) {
+  values[0] = this->pressure;
+  return 1;
+}
+
 
 /**************************************************************************//**
  * @brief   Constructs RGBLight sensor object, default uses TCS34725 sensor
@@ -1101,7 +3548,9 @@ const char * Pressure::toJSON(const char * sensorName) {
  *****************************************************************************/
 RGBLight::RGBLight(void) :
   tcsIt(TCS34725_INTEGRATIONTIME_154MS),
-  tcsGain(TCS34725_GAIN_1X)
+  tcsGain(TCS34725_GAIN_1X),
+  powerMode(POWER_MODE_CONTINUOUS),
+  autoRange(false)
 {
   this->initializeHeader(SENSORID_TCS34725, DATA_UNIT_LUX, rgblight_sensor_name);
 }
@@ -1112,7 +3561,9 @@ RGBLight::RGBLight(void) :
  */
 RGBLight::RGBLight(tcs34725IntegrationTime_t tcsIt, tcs34725Gain_t tcsGain) :
   tcsIt(tcsIt),
-  tcsGain(tcsGain)
+  tcsGain(tcsGain),
+  powerMode(POWER_MODE_CONTINUOUS),
+  autoRange(false)
 {
   this->initializeHeader(SENSORID_TCS34725, DATA_UNIT_LUX, rgblight_sensor_name);
 }
@@ -1125,11 +3576,61 @@ RGBLight::RGBLight(tcs34725IntegrationTime_t tcsIt, tcs34725Gain_t tcsGain) :
  * @retval false Failed to initialize
  */
 boolean RGBLight::initialize(void) {
-  if (!ARDUSAT_SPACEBOARD) {
+  if (!BOARD_IS_SPACEBOARD()) {
     _writeErrorMessage(unavailable_on_hardware_error_msg, rgblight_sensor_name, spacekit_hardware_name);
   }
 
-  return tcs34725_init(tcsIt, tcsGain) && (ARDUSAT_SPACEBOARD || MANUAL_CONFIG);
+  if (!tcs34725_init(this->device, tcsIt, tcsGain)) {
+    return false;
+  }
+
+  this->rangeGain = this->tcsGain;
+  this->rangeIntTime = this->tcsIt;
+  tcs34725_setContinuous(this->device, this->powerMode == POWER_MODE_CONTINUOUS);
+  tcs34725_setAutoRange(this->device, this->autoRange);
+  return BOARD_IS_SPACEBOARD() || MANUAL_CONFIG;
+}
+
+/**
+ * @brief   Chooses between keeping the TCS34725 integrating and powering it
+ *          up for each reading
+ * @ingroup rgblight
+ *
+ * In continuous mode, `read()` returns the last completed integration without
+ * waiting. The ISL29125 always runs continuously, so this has no effect on
+ * RGBLightISL.
+ *
+ * @param mode
+ *     - POWER_MODE_CONTINUOUS (Default)
+ *     - POWER_MODE_LOW_POWER
+ */
+void RGBLight::setPowerMode(power_mode_t mode) {
+  this->powerMode = mode;
+
+  if (this->initialized && this->header.sensor_id == SENSORID_TCS34725 && this->selectBus()) {
+    tcs34725_setContinuous(this->device, mode == POWER_MODE_CONTINUOUS);
+  }
+}
+
+/**
+ * @brief   Has the TCS34725 pick the gain and integration time of each
+ *          reading from the one before it
+ * @ingroup rgblight
+ *
+ * Auto-range never integrates for longer than the configured integration
+ * time, so a short configured time still gives fast readings, and the
+ * readings are scaled to the configured gain and integration time so they
+ * keep the same units. `rangeGain` and `rangeIntTime` hold the range each
+ * reading was taken at. Has no effect on RGBLightISL.
+ *
+ * @param enable true to auto-range, false (the default) for a fixed range
+ */
+void RGBLight::setAutoRange(boolean enable) {
+  this->autoRange = enable;
+
+  if (this->initialized && this->header.sensor_id == SENSORID_TCS34725 && this->selectBus()) {
+    tcs34725_setAutoRange(this->device, enable);
+  }
 }
 
 /**
@@ -1140,10 +3641,43 @@ boolean RGBLight::initialize(void) {
  * @retval false Failed to read
  */
 boolean RGBLight::readSensor(void) {
-  tcs34725_getRGB(&(this->red), &(this->green), &(this->blue));
+  tcs34725_getRGB(this->device, &(this->red), &(this->green), &(this->blue));
+  tcs34725_getRange(this->device, &(this->rangeIntTime), &(this->rangeGain));
   return true;
 }
 
+/**
+ * @brief   Runs one step of a split-phase reading
+ * @ingroup rgblight
+ *
+ * In continuous mode this reads the last completed integration cycle at
+ * once. In low power mode it powers the sensor up, then reads it once the
+ * integration time has passed. The ISL29125 (RGBLightISL) doesn't need to wait
+ * on a conversion, so it's just read.
+ *
+ * @param   step Index of the step to run
+ * @return  ms to wait before the next step or SENSOR_READ_COMPLETE
+ */
+long RGBLight::readSensorStep(uint8_t step) {
+  unsigned int wait;
+
+  if (this->header.sensor_id != SENSORID_TCS34725) {
+    return Sensor::readSensorStep(step);
+  }
+
+  if (step == 0) {
+    return tcs34725_startRGB(this->device);
+  }
+
+  wait = tcs34725_finishRGB(this->device, &(this->red), &(this->green), &(this->blue));
+  if (wait) {
+    return (long) wait;
+  }
+
+  tcs34725_getRange(this->device, &(this->rangeIntTime), &(this->rangeGain));
+  return SENSOR_READ_COMPLETE;
+}
+
 /**
  * @brief   Returns last read value in CSV format
  * @ingroup rgblight
@@ -1167,13 +3701,37 @@ const char * RGBLight::toCSV(const char * sensorName) {
  */
 const char * RGBLight::toJSON(const char * sensorName) {
   if (this->header.timestamp != 0) {
-    return valuesToJSON(sensorName, this->header.unit, 3, "Red", this->red,
-                        "Green", this->green, "Blue", this->blue);
+    return valuesToJSON_P(sensorName, this->header.unit, 3, json_label_red, this->red,
+                          json_label_green, this->green, json_label_blue, this->blue);
   } else {
     return "";
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup rgblight
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * RGBLight::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          3, this->red, this->green, this->blue);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t RGBLight::getValues(float * values) {
+  values[0] = this->red;
+  values[1] = this->green;
+  values[2] = this->blue;
+  return 3;
+}
+
 /**
  * @brief   Constructs TCS34725 RGBLight sensor object
  * @ingroup rgblight
@@ -1340,11 +3898,11 @@ RGBLightISL::RGBLightISL(uint8_t islIntensity) :
  * @retval false Failed to initialize
  */
 boolean RGBLightISL::initialize(void) {
-  if (!ARDUSAT_SPACEBOARD) {
+  if (!BOARD_IS_SPACEBOARD()) {
     _writeErrorMessage(unavailable_on_hardware_error_msg, rgblight_sensor_name, spacekit_hardware_name);
   }
 
-  return isl29125_init(islIntensity) && (ARDUSAT_SPACEBOARD || MANUAL_CONFIG);
+  return isl29125_init(islIntensity) && (BOARD_IS_SPACEBOARD() || MANUAL_CONFIG);
 }
 
 /**
@@ -1374,10 +3932,26 @@ boolean RGBLightISL::readSensor(void) {
  *     Serial.println(temp.readToJSON("ambient_temp")); // Read and print values in JSON
  * @endcode
  *****************************************************************************/
-Temperature::Temperature(void) {
+Temperature::Temperature(void) :
+  address(0)
+{
   this->initializeHeader(SENSORID_TMP102, DATA_UNIT_DEGREES_CELSIUS, temperature_sensor_name);
 }
 
+/**
+ * @brief   Sets the I2C address of the sensor, for one that isn't at the
+ *          board's default address or to read several at once
+ * @ingroup temperature
+ *
+ * Call before `begin()`. The TMP102 can be strapped to 0x48-0x4B; the MLX90614
+ * address is programmable.
+ *
+ * @param address I2C address, or 0 (Default) for the board's default address
+ */
+void Temperature::setAddress(uint8_t address) {
+  this->address = address;
+}
+
 /**
  * @brief   Initializes the sensor with any set configurations or defaults
  * @ingroup temperature
@@ -1386,7 +3960,7 @@ Temperature::Temperature(void) {
  * @retval false Failed to initialize
  */
 boolean Temperature::initialize(void) {
-  return tmp102_init();
+  return tmp102_init(this->address);
 }
 
 /**
@@ -1397,7 +3971,7 @@ boolean Temperature::initialize(void) {
  * @retval false Failed to read
  */
 boolean Temperature::readSensor(void) {
-  this->t = tmp102_getTempCelsius();
+  this->t = tmp102_getTempCelsius(this->address);
   return true;
 }
 
@@ -1429,6 +4003,48 @@ const char * Temperature::toJSON(const char * sensorName) {
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup temperature
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * Temperature::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          1, this->t);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t Temperature::getValues(float * values) {
+  values[0] = this->t;
+  return 1;
+}
+
+/**
+ * @brief   Returns last read value as the next frame of a delta stream
+ * @ingroup temperature
+ *
+ * Sends the temperature in counts of TEMPERATURE_DELTA_SCALE degrees.
+ *
+ * @param   encoder the stream's encoder, see DeltaEncoder
+ * @return  keyframe or delta frame, or NULL if uninitialized
+ */
+const unsigned char * Temperature::toDeltaBinary(DeltaEncoder & encoder) {
+  int16_t count = _toCounts(this->t, TEMPERATURE_DELTA_SCALE);
+
+  if (this->header.timestamp != 0) {
+    return rawValuesToDelta(encoder, this->header.sensor_id, this->header.unit, this->header.timestamp,
+                            TEMPERATURE_DELTA_SCALE, 1, &count);
+  } else {
+    return NULL;
+  }
+}
+
 /**
  * @brief   Constructs MLX90614 infrared Temperature sensor object
  * @ingroup temperature
@@ -1452,7 +4068,7 @@ TemperatureMLX::TemperatureMLX(void) {
  * @retval false Failed to initialize
  */
 boolean TemperatureMLX::initialize(void) {
-  return mlx90614_init();
+  return mlx90614_init(this->address);
 }
 
 /**
@@ -1463,7 +4079,7 @@ boolean TemperatureMLX::initialize(void) {
  * @retval false Failed to read
  */
 boolean TemperatureMLX::readSensor(void) {
-  this->t = mlx90614_getTempCelsius();
+  this->t = mlx90614_getTempCelsius(this->address);
   return true;
 }
 
@@ -1546,6 +4162,28 @@ const char * UVLight::toJSON(const char * sensorName) {
   }
 }
 
+/**
+ * @brief   Returns last read value as a binary frame
+ * @ingroup uvlight
+ * @return  binary frame of sensor readings or NULL if uninitialized
+ */
+const unsigned char * UVLight::toBinary(void) {
+  if (this->header.timestamp != 0) {
+    return valuesToBinary(this->header.sensor_id, this->header.unit, this->header.timestamp,
+                          1, this->uvindex);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Gets the last read values, for the report policy
+ */
+uint8_t UVLight::getValues(float * values) {
+  values[0] = this->uvindex;
+  return 1;
+}
+
 /**
  * @brief   Constructs ML8511 UVLight sensor object
  * @ingroup uvlight
@@ -1618,3 +4256,315 @@ boolean UVLightSI::readSensor(void) {
   this->uvindex = si1132_getUVIndex();
   return true;
 }
+
+
+/**************************************************************************//**
+ * @brief   Constructs SensorStats object that summarizes the readings of source
+ * @ingroup sensorstats
+ *
+ * Example Usage:
+ * @code
+ *     Acceleration accel;
+ *     SensorStats accelStats(accel, 0.001, 10000); // mm/s^2, 10 s windows
+ *     accel.begin();
+ *     accelStats.begin();                          // Initialize sensor
+ *     ...
+ *     if (accelStats.read()) {                     // Read and print a summary every 10 s
+ *       accelStats.writeJSON(serialConnection, "accel");
+ *     }
+ * @endcode
+ *
+ * @param   source sensor to summarize
+ * @param   resolution value of one count, in the source's unit
+ * @param   windowMillis window length in ms, or 0 to only count readings
+ * @param   windowSamples readings per window, or 0 to only time the window
+ *****************************************************************************/
+SensorStats::SensorStats(Sensor & source, float resolution, unsigned long windowMillis,
+                         uint16_t windowSamples) :
+  source(&source),
+  resolution(resolution > 0 ? resolution : 1),
+  windowMillis(windowMillis),
+  windowSamples(windowSamples),
+  windowStart(0),
+  lastReading(0),
+  windowEnd(0),
+  numValues(0),
+  count(0)
+{
+  this->initializeHeader(SENSORID_NULL, DATA_UNIT_NONE, stats_sensor_name);
+}
+
+/**
+ * @brief   Initializes the sensor with any set configurations or defaults
+ * @ingroup sensorstats
+ *
+ * The source sensor has to be initialized first.
+ *
+ * @retval true  Successfully initialized
+ * @retval false Failed to initialize
+ */
+boolean SensorStats::initialize(void) {
+  if (!this->source->initialized) {
+    return false;
+  }
+
+  this->resetWindow();
+  return true;
+}
+
+/**
+ * @brief   Sets how long each window lasts
+ * @ingroup sensorstats
+ *
+ * A window ends after windowMillis ms or windowSamples readings, whichever
+ * comes first; either can be 0 to leave it out. A timed window is closed by the
+ * first reading after it, which starts the next window. Windows are also
+ * closed at STATS_MAX_SAMPLES readings. Starts a new window.
+ *
+ * @param   windowMillis window length in ms, or 0
+ * @param   windowSamples readings per window, or 0
+ */
+void SensorStats::setWindow(unsigned long windowMillis, uint16_t windowSamples) {
+  this->windowMillis = windowMillis;
+  this->windowSamples = windowSamples;
+  this->resetWindow();
+}
+
+/**
+ * @brief   Drops the readings of the current window, e.g. after a gap
+ * @ingroup sensorstats
+ *
+ * The summary of the last window that closed is kept.
+ */
+void SensorStats::resetWindow(void) {
+  this->stats.reset();
+}
+
+/**
+ * @brief   Adds the source's latest reading to the window
+ * @ingroup sensorstats
+ *
+ * `read()` calls this after reading the source. Call it yourself after each
+ * reading of the source if something else reads it, e.g. from a
+ * SensorScheduler callback.
+ *
+ * @retval  true  A window closed and its summary is ready
+ * @retval  false The window is still open, or the source has no reading
+ */
+boolean SensorStats::add(void) {
+  float values[REPORT_MAX_VALUES];
+  int16_t counts[STATS_MAX_VALUES];
+  unsigned long timestamp = this->source->header.timestamp;
+  uint8_t n = this->source->getValues(values);
+  boolean closed = false;
+
+  if (n == 0 || timestamp == 0) {
+    return false;
+  }
+  if (n > STATS_MAX_VALUES) {
+    n = STATS_MAX_VALUES;
+  }
+
+  if (this->stats.count() > 0 && this->windowMillis > 0 &&
+      timestamp - this->windowStart >= this->windowMillis) {
+    this->closeWindow();
+    closed = true;
+  }
+
+  for (uint8_t i = 0; i < n; ++i) {
+    counts[i] = _toCounts(values[i], this->resolution);
+  }
+  if (this->stats.count() == 0) {
+    this->windowStart = timestamp;
+  }
+  this->stats.add(counts, n);
+  this->lastReading = timestamp;
+
+  if ((this->windowSamples > 0 && this->stats.count() >= this->windowSamples) ||
+      this->stats.count() == STATS_MAX_SAMPLES) {
+    this->closeWindow();
+    closed = true;
+  }
+
+  return closed;
+}
+
+/*
+ * Keeps the summary of the current window, scaled to the source's unit, and
+ * starts the next one. Records have the source's sensor id and unit, and the
+ * timestamp of the window's last reading.
+ */
+void SensorStats::closeWindow(void) {
+  this->header.sensor_id = this->source->header.sensor_id;
+  this->header.unit = this->source->header.unit;
+  this->windowEnd = this->lastReading;
+  this->header.timestamp = this->windowEnd;
+  this->numValues = this->stats.values();
+  this->count = this->stats.count();
+
+  for (uint8_t i = 0; i < this->numValues; ++i) {
+    this->mean[i] = this->stats.mean(i) * this->resolution;
+    this->minimum[i] = this->stats.minimum(i) * this->resolution;
+    this->maximum[i] = this->stats.maximum(i) * this->resolution;
+    this->stddev[i] = this->stats.stddev(i) * this->resolution;
+  }
+
+  this->stats.reset();
+}
+
+/**
+ * @brief   Reads the source and adds the reading to the window
+ * @ingroup sensorstats
+ *
+ * @retval true  A window closed and its summary is ready
+ * @retval false The window is still open, or the source couldn't be read
+ */
+boolean SensorStats::readSensor(void) {
+  boolean closed = this->source->read() && this->add();
+
+  // read() stamps every reading, but the summary keeps the stamp of its window
+  this->header.timestamp = this->windowEnd;
+  return closed;
+}
+
+/*
+ * Gets the summary values in output order: the count, then the mean, min, max
+ * and standard deviation of each of the source's values
+ */
+float SensorStats::summaryValue(uint8_t index) {
+  uint8_t i = (index - 1) / 4;
+
+  if (index == 0) {
+    return this->count;
+  }
+
+  switch ((index - 1) % 4) {
+    case 0:
+      return this->mean[i];
+    case 1:
+      return this->minimum[i];
+    case 2:
+      return this->maximum[i];
+    default:
+      return this->stddev[i];
+  }
+}
+
+/**
+ * @brief   Returns the summary of the last window in CSV format
+ * @ingroup sensorstats
+ * @param   sensorName The text to display next to the values
+ * @return  count, then mean, min, max and standard deviation of each value,
+ *          or empty string if no window has closed yet
+ */
+const char * SensorStats::toCSV(const char * sensorName) {
+  uint8_t values = 1 + 4 * this->numValues;
+  size_t written;
+  int cs = 0;
+  boolean full = false;
+
+  if (this->count == 0) {
+    return "";
+  }
+
+  _beginOutput();
+  _ChecksumPrint out(_out());
+
+  written = _writeCSVStart(out, &cs, sensorName, this->header.timestamp);
+  for (uint8_t i = 0; i < values; ++i) {
+    written += _writeCSVValue(out, &cs, &full, this->summaryValue(i));
+  }
+  written += _writeCSVEnd(out, cs);
+
+  return _endOutput(written);
+}
+
+/**
+ * @brief   Returns the summary of the last window in JSON format
+ * @ingroup sensorstats
+ *
+ * The records are labelled Count, Mean, Min, Max and StdDev. With more than
+ * one value per reading, the labels end with the index of the value, e.g.
+ * Mean0, Mean1 and Mean2 for the x, y and z means. The 13 records of a 3 value
+ * summary don't all fit in the output buffer, so write them with writeJSON().
+ * Records that don't fit are left out, and an error message is printed to
+ * Serial saying so.
+ *
+ * @param   sensorName The text to display next to the values
+ * @return  summary in JSON format or empty string if no window has closed yet
+ */
+const char * SensorStats::toJSON(const char * sensorName) {
+  const char * const labels[4] = {json_label_mean, json_label_min, json_label_max, json_label_stddev};
+  const char * unit = unit_to_str_P(this->header.unit);
+  char label[8];
+  size_t written;
+  boolean full = false;
+
+  if (this->count == 0) {
+    return "";
+  }
+
+  _beginOutput();
+  written = _writeJSONValue(sensorName, json_label_count, true, unit_none, this->count);
+  for (uint8_t i = 0; i < this->numValues; ++i) {
+    for (uint8_t j = 0; j < 4; ++j) {
+      size_t len, record;
+
+      strcpy_P(label, labels[j]);
+      if (this->numValues > 1) {
+        len = strlen(label);
+        label[len] = '0' + i;
+        label[len + 1] = '\0';
+      }
+      record = _writeJSONValue(sensorName, label, false, unit, this->summaryValue(1 + 4 * i + j));
+      full = full || record == 0;
+      written += record;
+    }
+  }
+
+  if (full) {
+    _writeErrorMessage(output_full_error_msg, this->name);
+  }
+
+  return _endOutput(written);
+}
+
+/**
+ * @brief   Returns the summary of the last window as a binary frame
+ * @ingroup sensorstats
+ * @return  binary frame of float values, in the same order as toCSV(), or
+ *          NULL if no window has closed yet
+ */
+const unsigned char * SensorStats::toBinary(void) {
+  uint8_t values = 1 + 4 * this->numValues;
+  size_t written;
+  uint16_t crc;
+
+  if (this->count == 0) {
+    return NULL;
+  }
+
+  _beginOutput();
+  if (values > _maxBinaryPayload() / sizeof(float)) {
+    values = _maxBinaryPayload() / sizeof(float);
+  }
+
+  written = _writeBinaryHeader(_out(), &crc, BINARY_VALUES_FLOAT, this->header.sensor_id, this->header.unit,
+                               this->header.timestamp, values * sizeof(float));
+  for (uint8_t i = 0; i < values; ++i) {
+    written += _writeBinaryFloat(_out(), &crc, this->summaryValue(i));
+  }
+  written += _writeBinaryCRC(_out(), crc);
+
+  return _endBinaryOutput(written);
+}
+
+/*
+ * Gets the means of the last window, for the report policy
+ */
+uint8_t SensorStats::getValues(float * values) {
+  for (uint8_t i = 0; i < this->numValues; ++i) {
+    values[i] = this->mean[i];
+  }
+  return this->numValues;
+}
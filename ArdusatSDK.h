@@ -16,6 +16,14 @@
 #include <utility/drivers.h>
 #include <avr/pgmspace.h>
 #include <utility/serial.h>
+#include <utility/scheduler.h>
+#include <utility/output_sink.h>
+#include <utility/filter.h>
+#include <utility/fusion.h>
+#include <utility/delta.h>
+#include <utility/report.h>
+#include <utility/stats.h>
+#include <utility/timing.h>
 
 /**
  * Allows the user to manually decide in an Arduino sketch if the SDK should
@@ -27,7 +35,7 @@ extern boolean MANUAL_CONFIG;
 /**
  * Used when dynamically checking if the SpaceBoard is being used or not. If
  * the SpaceBoard is being used, different addresses might be used for each
- * sensor.
+ * sensor. When ARDUSAT_BOARD is set in utility/config.h this is fixed to match.
  */
 extern boolean ARDUSAT_SPACEBOARD;
 
@@ -66,9 +74,14 @@ typedef enum {
 } data_unit_t;
 
 /**
- * Where all of the sensor data is kept before being printed
+ * Where all of the sensor data is kept before being printed. Its size can only
+ * be changed from a sketch without ARDUSAT_STATIC_BUFFERS (see utility/config.h).
  */
+#if ARDUSAT_STATIC_BUFFERS
+extern const int OUTPUT_BUF_SIZE;
+#else
 extern int OUTPUT_BUF_SIZE;
+#endif
 extern char * _output_buffer;
 char * _getOutBuf();
 void _resetOutBuf();
@@ -84,9 +97,35 @@ struct _data_header_v1 {
 typedef struct _data_header_v1 _data_header_t;
 
 /**
- * Get a string representation of a unit constant
+ * Get a string representation of a unit constant. unit_to_str_P returns the
+ * string in PROGMEM, without copying it to RAM.
  */
 const char * unit_to_str(unsigned char unit);
+const char * unit_to_str_P(unsigned char unit);
+
+/**
+ * How the checksum at the end of each CSV and JSON record is calculated.
+ * CHECKSUM_SUM is the sum of the sensor name characters and the rounded values,
+ * which experiments.ardusat.com expects. The CRC modes cover every byte of the
+ * record before the checksum itself, and are printed in decimal like the sum.
+ */
+typedef enum {
+  CHECKSUM_SUM,
+  CHECKSUM_CRC8,   /* CRC-8/SMBUS */
+  CHECKSUM_CRC16,  /* CRC-16/CCITT-FALSE, the same as binary frames */
+} checksum_mode_t;
+
+void setChecksumMode(checksum_mode_t mode);
+checksum_mode_t getChecksumMode();
+
+/**
+ * How the light sensors that integrate over time (Luminosity and the TCS34725
+ * RGBLight) are powered between readings
+ */
+typedef enum {
+  POWER_MODE_CONTINUOUS,  /* always integrating, reads return the last result at once */
+  POWER_MODE_LOW_POWER,   /* powered up for each read, which waits a full integration */
+} power_mode_t;
 
 /**
  * creates a string representation of the data in a CSV format that can be used with
@@ -103,8 +142,61 @@ const char * valueToCSV(const char *sensorName, float value, unsigned long times
  * ~{"sensorName": "name", "unit": "C", "value": 35.3}|
  */
 const char * valuesToJSON(const char *sensorName, unsigned char unit, int numValues, ...);
+const char * valuesToJSON_P(const char *sensorName, unsigned char unit, int numValues, ...);
 const char * valueToJSON(const char *sensorName, unsigned char unit, float value);
 
+/**
+ * creates a compact binary frame of the data that can be decoded on the receiving
+ * end with decode_binary/decode_binary.py
+ *
+ * Format is (multi-byte fields are little endian):
+ * | sync (0xA5) | type | payload length | unit | sensor id | timestamp (4) | payload | CRC-16 (2) |
+ *
+ * The CRC-16/CCITT-FALSE covers everything from `type` to the end of the payload.
+ * The payload is the float values, or for raw frames a float scale followed by
+ * the int16 values (physical value = raw value * scale).
+ *
+ * Delta streams (rawValuesToDelta) start with a keyframe, a raw frame with a
+ * sequence number before the scale. The samples after it are delta frames,
+ * with a shorter header and zigzag-varints of the change in timestamp and in
+ * each value since the last sample:
+ * | sync (0xA5) | type | payload length | unit | sensor id | sequence | payload | CRC-16 (2) |
+ */
+#define BINARY_FRAME_SYNC 0xA5
+#define BINARY_FRAME_HEADER_SIZE 9
+#define BINARY_FRAME_OVERHEAD (BINARY_FRAME_HEADER_SIZE + 2)
+#define BINARY_DELTA_HEADER_SIZE 6
+#define BINARY_DELTA_OVERHEAD (BINARY_DELTA_HEADER_SIZE + 2)
+
+typedef enum {
+  BINARY_VALUES_FLOAT = 0x01,
+  BINARY_VALUES_INT16 = 0x02,
+  BINARY_VALUES_KEYFRAME = 0x03,
+  BINARY_VALUES_DELTA = 0x04,
+} binary_value_type_t;
+
+const unsigned char * valuesToBinary(unsigned char sensorId, unsigned char unit, unsigned long timestamp,
+                                     int numValues, ...);
+const unsigned char * rawValuesToBinary(unsigned char sensorId, unsigned char unit, unsigned long timestamp,
+                                        float scale, int numValues, const int16_t *values);
+const unsigned char * rawValuesToDelta(DeltaEncoder & encoder, unsigned char sensorId, unsigned char unit,
+                                       unsigned long timestamp, float scale, int numValues,
+                                       const int16_t *values);
+size_t binaryFrameLength(const unsigned char *frame);
+
+
+/**
+ * Returned by Sensor::readSensorStep() when a split-phase read has finished,
+ * or could not be completed.
+ */
+#define SENSOR_READ_COMPLETE -1
+#define SENSOR_READ_FAILED -2
+
+/**
+ * How Sensor keeps BUS_NO_CHANNEL in its 4 bit busChannel field
+ */
+#define SENSOR_NO_CHANNEL 0x0F
+
 
 /**************************************************************************//**
  * @class Sensor
@@ -117,21 +209,96 @@ class Sensor {
 
     virtual boolean initialize(void) = 0;
     virtual boolean readSensor(void) = 0;
+    virtual long readSensorStep(uint8_t step);
+
+    unsigned long readStarted;
+    unsigned long readDeadline;
+    uint8_t readStage;
+    void continueRead(void);
+    void countBusErrors(uint16_t errors, uint16_t retries);
+
+#if ARDUSAT_DATA_READY
+    virtual boolean setDataReady(boolean enable);
+    int8_t dataReadyIrq(void);
+#endif
+    void stampReading(void);
+    boolean readRawCounts(void);
+
+#if ARDUSAT_REPORT_POLICY
+    ReportPolicy * reportPolicy;
+#endif
+    virtual uint8_t getValues(float * values);
+    void checkReport(void);
+
+    boolean selectBus(void);
+
+    friend class SensorStats;
+
+    // Packed into two bytes, along with `initialized`
+#if ARDUSAT_DATA_READY
+    uint8_t dataReadyPin : 7;
+    uint8_t dataReadyAttached : 1;
+#endif
+    uint8_t busChannel : 4;     // BUS_NO_CHANNEL is kept as SENSOR_NO_CHANNEL
+#if ARDUSAT_REPORT_POLICY
+    uint8_t reportPending : 1;
+#endif
+    uint8_t pending : 1;
+    uint8_t rawOnly : 1;        // readSensor() only needs to update the raw counts
 
   public:
+    boolean initialized : 1;
     const char * name;
     _data_header_t header;
-    boolean initialized;
+    uint16_t busErrors;   /* I2C transactions that failed during this sensor's reads */
+    uint16_t busRetries;  /* I2C transactions retried during this sensor's reads */
+#if ARDUSAT_TIMING
+    sensor_timing_t timing;  /* time spent reading and formatting, see utility/timing.h */
+#endif
 
     boolean begin(void);
     boolean read(void);
+    boolean startRead(void);
+    boolean poll(void);
+    boolean isReading(void);
+    boolean isPending(void) { return pending; }
+#if ARDUSAT_DATA_READY
+    boolean attachDataReady(uint8_t pin);
+    void detachDataReady(void);
+#endif
+#if ARDUSAT_REPORT_POLICY
+    void setReportPolicy(ReportPolicy * policy);
+#endif
+    boolean reportDue(void);
+    void setBusChannel(uint8_t channel);
+    uint8_t getBusChannel(void) { return busChannel == SENSOR_NO_CHANNEL ? BUS_NO_CHANNEL : busChannel; }
     const char * readToCSV(const char * sensorName);
     const char * readToJSON(const char * sensorName);
+    const unsigned char * readToBinary(void);
+    size_t writeCSV(OutputSink & out, const char * sensorName);
+    size_t writeJSON(OutputSink & out, const char * sensorName);
+    size_t writeBinary(OutputSink & out);
 
     virtual const char * toCSV(const char * sensorName) = 0;
     virtual const char * toJSON(const char * sensorName) = 0;
+    virtual const unsigned char * toBinary(void) = 0;
+    virtual const unsigned char * toDeltaBinary(DeltaEncoder & encoder);
+    size_t writeDeltaBinary(OutputSink & out, DeltaEncoder & encoder);
+
+#if ARDUSAT_TIMING
+    void resetTiming(void);
+    const char * timingToCSV(const char * sensorName);
+    const char * timingToJSON(const char * sensorName);
+#endif
 };
 
+#if ARDUSAT_TIMING
+const char * sdkTimingToCSV(const char * name);
+const char * sdkTimingToJSON(const char * name);
+#endif
+
+boolean beginAll(Sensor * const sensors[], uint8_t count, boolean useCache=false);
+
 
 /**************************************************************************//**
  * @class Acceleration
@@ -154,19 +321,39 @@ class Sensor {
 class Acceleration: public Sensor {
   protected:
     lsm303_accel_gain_e gGain;
+    boolean batchMode;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+#if ARDUSAT_DATA_READY
+    boolean setDataReady(boolean enable);
+#endif
+    DecimationFilter * filter;
 
   public:
     float x;
     float y;
     float z;
+    int16_t rawX;
+    int16_t rawY;
+    int16_t rawZ;
     Acceleration(void);
     Acceleration(lsm303_accel_gain_e gain);
 
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+
+    boolean readRaw(void);
+    float rawScale(void);
+    const unsigned char * toRawBinary(void);
+    const unsigned char * toDeltaBinary(DeltaEncoder & encoder);
+    void setFilter(DecimationFilter * filter);
+
+    boolean setBatchMode(boolean enable);
+    boolean getBatchMode(void) { return batchMode; }
+    uint8_t readBatch(raw_xyz_t *samples, uint8_t maxSamples);
 };
 
 
@@ -191,19 +378,42 @@ class Acceleration: public Sensor {
 class Gyro: public Sensor {
   protected:
     uint8_t range;
+    uint8_t address;
+    boolean batchMode;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+#if ARDUSAT_DATA_READY
+    boolean setDataReady(boolean enable);
+#endif
+    DecimationFilter * filter;
 
   public:
     float x;
     float y;
     float z;
+    int16_t rawX;
+    int16_t rawY;
+    int16_t rawZ;
     Gyro(void);
     Gyro(uint8_t range);
 
+    void setAddress(uint8_t address);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+
+    boolean readRaw(void);
+    float rawScale(void);
+    const unsigned char * toRawBinary(void);
+    const unsigned char * toDeltaBinary(DeltaEncoder & encoder);
+    void setFilter(DecimationFilter * filter);
+
+    boolean setBatchMode(boolean enable);
+    boolean getBatchMode(void) { return batchMode; }
+    uint8_t readBatch(raw_xyz_t *samples, uint8_t maxSamples);
 };
 
 
@@ -228,20 +438,32 @@ class Luminosity: public Sensor {
   protected:
     tsl2561Gain_t gain;
     tsl2561IntegrationTime_t intTime;
+    power_mode_t powerMode;
+    uint8_t address;
+    TSL2561 device;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+    long readSensorStep(uint8_t step);
 
   public:
     float lux;
+    tsl2561Gain_t rangeGain;
+    tsl2561IntegrationTime_t rangeIntTime;
     Luminosity(void);
     Luminosity(tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain);
     Luminosity(tsl2561Gain_t gain, tsl2561IntegrationTime_t intTime);
     Luminosity(tsl2561IntegrationTime_t intTime);
     Luminosity(tsl2561Gain_t gain);
 
+    void setPowerMode(power_mode_t mode);
+    power_mode_t getPowerMode(void) { return powerMode; }
+    void setAddress(uint8_t address);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
 };
 
 
@@ -269,16 +491,31 @@ class Magnetic: public Sensor {
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+#if ARDUSAT_DATA_READY
+    boolean setDataReady(boolean enable);
+#endif
+    DecimationFilter * filter;
 
   public:
     float x;
     float y;
     float z;
+    int16_t rawX;
+    int16_t rawY;
+    int16_t rawZ;
     Magnetic(void);
     Magnetic(lsm303_mag_scale_e gaussScale);
 
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+
+    boolean readRaw(void);
+    float rawScale(void);
+    const unsigned char * toRawBinary(void);
+    const unsigned char * toDeltaBinary(DeltaEncoder & encoder);
+    void setFilter(DecimationFilter * filter);
 };
 
 
@@ -303,9 +540,12 @@ class Orientation: public Sensor {
   protected:
     Acceleration * accel;
     Magnetic * mag;
+    unsigned long maxSampleAge;
+    boolean fastTrig;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
 
   public:
     float roll;
@@ -313,8 +553,85 @@ class Orientation: public Sensor {
     float heading;
     Orientation(Acceleration & accel, Magnetic & mag);
 
+    void setMaxSampleAge(unsigned long maxAge);
+    void setFastTrig(boolean enable);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+};
+
+
+/**************************************************************************//**
+ * @class FusedOrientation
+ * @ingroup sensor
+ *
+ * @defgroup fusedorientation
+ * @brief Tracks attitude by fusing the Gyro, Accelerometer and Magnetometer
+ *
+ * Unlike Orientation, which works out the angles from a single accelerometer
+ * and magnetometer reading, this runs a fixed-point complementary filter (see
+ * FusionFilter) on every gyro sample, with the accelerometer and magnetometer
+ * only correcting the drift. The result is much less noisy, and stays right
+ * while the board is moving.
+ *
+ * For the full sensor rate, put the gyro and accelerometer in batch mode and
+ * read often enough that their FIFOs don't overflow (32 samples). Each reading
+ * then runs one filter update for every gyro sample in the FIFO. Without batch
+ * mode each reading is a single gyro sample, so readings have to come at the
+ * sensor rate. The magnetometer is only read every `setMagInterval()` ms.
+ *
+ * Example Usage:
+ * @code
+ *     Gyro gyro;
+ *     Acceleration accel;
+ *     Magnetic mag;
+ *     FusedOrientation fused(gyro, accel, mag);     // Instantiate sensor object
+ *
+ *     gyro.setBatchMode(true);
+ *     accel.setBatchMode(true);
+ *     gyro.begin();
+ *     accel.begin();
+ *     mag.begin();
+ *     fused.begin();                                // Initialize sensor
+ *     Serial.println(fused.readToJSON("attitude")); // Read and print values in JSON
+ * @endcode
+ *****************************************************************************/
+class FusedOrientation: public Sensor {
+  protected:
+    Gyro * gyro;
+    Acceleration * accel;
+    Magnetic * mag;
+    FusionFilter filter;
+    unsigned long magInterval;
+    unsigned long lastMag;
+    unsigned long lastUpdate;
+    unsigned long samplePeriod;
+
+    boolean initialize(void);
+    boolean readSensor(void);
+    uint8_t getValues(float * values);
+    void updateAccel(void);
+    void updateMag(void);
+    uint8_t updateGyro(unsigned long elapsed);
+
+  public:
+    float qw;
+    float qx;
+    float qy;
+    float qz;
+    float roll;
+    float pitch;
+    float heading;
+    FusedOrientation(Gyro & gyro, Acceleration & accel, Magnetic & mag);
+
+    void setGains(float kp, float ki);
+    void setMagInterval(unsigned long interval);
+    void reset(void);
+
+    const char * toCSV(const char * sensorName);
+    const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
 };
 
 
@@ -341,9 +658,13 @@ class Orientation: public Sensor {
 class Pressure: public Sensor {
   protected:
     bmp085_mode_t bmp085_mode;
+    uint8_t tempSamples;
+    float tempThreshold;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+    long readSensorStep(uint8_t step);
 
   public:
     float pressure;
@@ -353,8 +674,11 @@ class Pressure: public Sensor {
     float altitudeFromSeaLevelPressure(float seaLevelPressure);
     float seaLevelPressureFromAltitude(float altitude);
 
+    void setTemperatureRefresh(uint8_t samples, float threshold = 0);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
 };
 
 
@@ -394,19 +718,31 @@ class RGBLight: public Sensor {
   protected:
     tcs34725IntegrationTime_t tcsIt;
     tcs34725Gain_t tcsGain;
+    power_mode_t powerMode;
+    boolean autoRange;
+    Adafruit_TCS34725 device;
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
+    long readSensorStep(uint8_t step);
     RGBLight(tcs34725IntegrationTime_t tcsIt, tcs34725Gain_t tcsGain);
 
   public:
     float red;
     float green;
     float blue;
+    tcs34725Gain_t rangeGain;
+    tcs34725IntegrationTime_t rangeIntTime;
     RGBLight(void);
 
+    void setPowerMode(power_mode_t mode);
+    power_mode_t getPowerMode(void) { return powerMode; }
+    void setAutoRange(boolean enable);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
 };
 
 /**
@@ -442,6 +778,11 @@ class RGBLightISL: public RGBLight {
 };
 
 
+/**
+ * Degrees per count in Temperature delta streams (see toDeltaBinary)
+ */
+#define TEMPERATURE_DELTA_SCALE 0.01F
+
 /**************************************************************************//**
  * @class Temperature
  * @ingroup sensor
@@ -476,15 +817,22 @@ class RGBLightISL: public RGBLight {
  *****************************************************************************/
 class Temperature: public Sensor {
   protected:
+    uint8_t address;
+
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
 
   public:
     float t;
     Temperature(void);
 
+    void setAddress(uint8_t address);
+
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+    const unsigned char * toDeltaBinary(DeltaEncoder & encoder);
 };
 
 /**
@@ -547,6 +895,7 @@ class UVLight: public Sensor {
 
     boolean initialize(void);
     boolean readSensor(void);
+    uint8_t getValues(float * values);
     UVLight(int pin);
 
   public:
@@ -555,6 +904,7 @@ class UVLight: public Sensor {
 
     const char * toCSV(const char * sensorName);
     const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
 };
 
 /**
@@ -584,4 +934,80 @@ class UVLightSI: public UVLight {
     UVLightSI(void);
 };
 
+/**
+ * How long a SensorStats window lasts unless set otherwise, in ms
+ */
+#ifndef STATS_DEFAULT_WINDOW_MS
+#define STATS_DEFAULT_WINDOW_MS 60000UL
+#endif
+
+/**************************************************************************//**
+ * @class SensorStats
+ * @ingroup sensor
+ *
+ * @defgroup sensorstats
+ * @brief Summarizes the readings of another sensor over a window
+ *
+ * Each reading of the source sensor is rounded to counts of `resolution`
+ * (e.g. 0.01 for hundredths of a degree) and added to a WindowStats. When the
+ * window is over, after `windowMillis` ms or `windowSamples` readings, the
+ * count, mean, min, max and standard deviation of each of the source's values
+ * are kept, and are output in one record by toCSV(), toJSON() and toBinary(),
+ * timestamped with the window's last reading.
+ * Values beyond +/-32767 counts are clamped, so pick a resolution that fits the
+ * sensor's range.
+ *
+ * `read()` reads the source and returns true only when a window has closed.
+ * To sample the source with a SensorScheduler, call `add()` from its callback
+ * instead.
+ *
+ * Example Usage:
+ * @code
+ *     TemperatureTMP temp;
+ *     SensorStats tempStats(temp, 0.01, 60000);       // Instantiate sensor object
+ *
+ *     temp.begin();
+ *     tempStats.begin();                              // Initialize sensor
+ *     ...
+ *     if (tempStats.read()) {                         // Read as often as you like
+ *       Serial.println(tempStats.toCSV("temp_stats")); // One record a minute
+ *     }
+ * @endcode
+ *****************************************************************************/
+class SensorStats: public Sensor {
+  protected:
+    Sensor * source;
+    WindowStats stats;
+    float resolution;
+    unsigned long windowMillis;
+    uint16_t windowSamples;
+    unsigned long windowStart;
+    unsigned long lastReading;  /* timestamp of the last reading in the window */
+    unsigned long windowEnd;    /* timestamp of the last reading in the last closed window */
+
+    boolean initialize(void);
+    boolean readSensor(void);
+    uint8_t getValues(float * values);
+    void closeWindow(void);
+    float summaryValue(uint8_t index);
+
+  public:
+    uint8_t numValues;  /* values per source reading, at most STATS_MAX_VALUES */
+    uint16_t count;     /* readings in the last window */
+    float mean[STATS_MAX_VALUES];
+    float minimum[STATS_MAX_VALUES];
+    float maximum[STATS_MAX_VALUES];
+    float stddev[STATS_MAX_VALUES];
+    SensorStats(Sensor & source, float resolution, unsigned long windowMillis = STATS_DEFAULT_WINDOW_MS,
+                uint16_t windowSamples = 0);
+
+    void setWindow(unsigned long windowMillis, uint16_t windowSamples = 0);
+    boolean add(void);
+    void resetWindow(void);
+
+    const char * toCSV(const char * sensorName);
+    const char * toJSON(const char * sensorName);
+    const unsigned char * toBinary(void);
+};
+
 #endif /* ARDUSATSDK_H_ */
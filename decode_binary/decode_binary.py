@@ -0,0 +1,270 @@
+#!/usr/bin/env python
+"""
+Decodes binary frames written by the Ardusat SDK (`valuesToBinary`,
+`rawValuesToBinary`, `rawValuesToDelta`, `Sensor::toBinary`,
+`Sensor::toDeltaBinary`) into CSV lines.
+
+Frame layout (multi-byte fields are little endian):
+
+    | sync 0xA5 | type | payload length | unit | sensor id | timestamp (u32) | payload | CRC-16 |
+
+Type 0x01 payloads are float32 values, type 0x02 payloads are a float32 scale
+followed by int16 raw counts (value = count * scale). The CRC-16/CCITT-FALSE
+covers everything from `type` to the end of the payload.
+
+Delta streams start with a type 0x03 keyframe, a type 0x02 frame with a u8
+sequence number before the scale. Each sample after it is a type 0x04 delta
+frame with a shorter header,
+
+    | sync 0xA5 | 0x04 | payload length | unit | sensor id | sequence | payload | CRC-16 |
+
+whose payload is the change in timestamp and in each count since the last
+sample, as zigzag-varints. Streams are told apart by sensor id and unit. After
+a lost frame the sequence numbers don't follow on, and the stream's deltas are
+dropped until its next keyframe.
+
+Anything that isn't a valid frame (text output, line noise) is skipped.
+
+Usage:
+    python decode_binary.py capture.bin
+    python decode_binary.py --serial /dev/ttyUSB0 --baud 9600   (requires pyserial)
+    cat capture.bin | python decode_binary.py
+"""
+
+import argparse
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+HEADER_SIZE = 9
+CRC_SIZE = 2
+
+VALUES_FLOAT = 0x01
+VALUES_INT16 = 0x02
+VALUES_KEYFRAME = 0x03
+VALUES_DELTA = 0x04
+
+DELTA_HEADER_SIZE = 6
+
+# Mirrors sensor_id_t in ArdusatSDK.h
+SENSOR_NAMES = {
+    0x00: "Null",
+    0x01: "TMP102",
+    0x02: "TSL2561",
+    0x03: "MLX90614",
+    0x04: "Adafruit9DOFIMU",
+    0x05: "SI1132",
+    0x06: "ML8511",
+    0x07: "BMP180",
+    0x08: "ISL29125",
+    0x09: "TCS34725",
+}
+
+# Mirrors data_unit_t / unit_to_str in ArdusatSDK
+UNIT_NAMES = {
+    0: "",
+    1: "m/s^2",
+    2: "rad/s",
+    3: "uT",
+    4: "C",
+    5: "F",
+    6: "m/s",
+    7: "lux",
+    8: "rad",
+    9: "mW/cm^2",
+    10: "deg",
+    11: "hPa",
+}
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, matching utility/crc.cpp"""
+    for byte in bytearray(data):
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def decode_payload(frame_type, payload):
+    """Returns the physical values in a frame payload, or None if it's malformed"""
+    if frame_type == VALUES_FLOAT:
+        if len(payload) % 4:
+            return None
+        return list(struct.unpack("<%df" % (len(payload) // 4), payload))
+
+    if frame_type == VALUES_INT16:
+        if len(payload) < 4 or (len(payload) - 4) % 2:
+            return None
+        scale = struct.unpack("<f", payload[:4])[0]
+        counts = struct.unpack("<%dh" % ((len(payload) - 4) // 2), payload[4:])
+        return [count * scale for count in counts]
+
+    return None
+
+
+def read_varints(data):
+    """Returns the zigzag-varints in data as signed values, or None if one is cut off"""
+    values = []
+    value = shift = 0
+    for byte in bytearray(data):
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            values.append((value >> 1) ^ -(value & 1))
+            value = shift = 0
+    if shift:
+        return None
+    return values
+
+
+class DeltaStream(object):
+    """The last sample of one delta stream"""
+
+    def __init__(self, sequence, timestamp, scale, counts):
+        self.sequence = sequence
+        self.timestamp = timestamp
+        self.scale = scale
+        self.counts = counts
+
+
+class FrameDecoder(object):
+    """Incrementally pulls frames out of a byte stream"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.bad_frames = 0
+        self.lost_deltas = 0
+        self.streams = {}
+
+    def decode_keyframe(self, key, timestamp, payload):
+        """Starts a delta stream over, returning the keyframe's values"""
+        if len(payload) < 5 or (len(payload) - 5) % 2:
+            return None
+        sequence = bytearray(payload[:1])[0]
+        scale = struct.unpack("<f", payload[1:5])[0]
+        counts = list(struct.unpack("<%dh" % ((len(payload) - 5) // 2), payload[5:]))
+        self.streams[key] = DeltaStream(sequence, timestamp, scale, counts)
+        return [count * scale for count in counts]
+
+    def decode_delta(self, key, sequence, payload):
+        """Applies a delta frame to its stream, returning the timestamp and values"""
+        deltas = read_varints(payload)
+        stream = self.streams.get(key)
+        if deltas is None or stream is None or len(deltas) != len(stream.counts) + 1:
+            return None, None
+        if sequence != (stream.sequence + 1) & 0xFF:
+            # A frame was lost: wait for the next keyframe
+            del self.streams[key]
+            return None, None
+
+        stream.sequence = sequence
+        stream.timestamp = (stream.timestamp + deltas[0]) & 0xFFFFFFFF
+        stream.counts = [count + delta for count, delta in zip(stream.counts, deltas[1:])]
+        return stream.timestamp, [count * stream.scale for count in stream.counts]
+
+    def feed(self, data):
+        """Adds bytes to the stream and yields every complete, valid frame as a dict"""
+        self.buf.extend(data)
+
+        while True:
+            start = self.buf.find(bytearray([FRAME_SYNC]))
+            if start < 0:
+                del self.buf[:]
+                return
+            del self.buf[:start]
+
+            if len(self.buf) < HEADER_SIZE:
+                return
+
+            frame_type, length = self.buf[1], self.buf[2]
+            header_size = DELTA_HEADER_SIZE if frame_type == VALUES_DELTA else HEADER_SIZE
+            frame_len = header_size + length + CRC_SIZE
+            if len(self.buf) < frame_len:
+                return
+
+            frame = bytes(self.buf[:frame_len])
+            unit, sensor_id = bytearray(frame[3:5])
+            payload = frame[header_size:-CRC_SIZE]
+            crc = struct.unpack("<H", frame[-CRC_SIZE:])[0]
+            if crc != crc16(frame[1:-CRC_SIZE]):
+                # Not a frame after all, resync on the next sync byte
+                self.bad_frames += 1
+                del self.buf[:1]
+                continue
+
+            del self.buf[:frame_len]
+            if frame_type == VALUES_DELTA:
+                timestamp, values = self.decode_delta((sensor_id, unit), bytearray(frame[5:6])[0], payload)
+                if values is None:
+                    self.lost_deltas += 1
+                    continue
+            else:
+                timestamp = struct.unpack("<I", frame[5:HEADER_SIZE])[0]
+                if frame_type == VALUES_KEYFRAME:
+                    values = self.decode_keyframe((sensor_id, unit), timestamp, payload)
+                else:
+                    values = decode_payload(frame_type, payload)
+                if values is None:
+                    self.bad_frames += 1
+                    continue
+
+            yield {
+                "timestamp": timestamp,
+                "sensor_id": sensor_id,
+                "sensor": SENSOR_NAMES.get(sensor_id, "0x%02X" % sensor_id),
+                "unit": UNIT_NAMES.get(unit, str(unit)),
+                "values": values,
+            }
+
+
+def format_csv(frame):
+    return ",".join([str(frame["timestamp"]), frame["sensor"], frame["unit"]] +
+                    ["%.3f" % value for value in frame["values"]])
+
+
+def read_chunks(args):
+    if args.serial:
+        import serial
+        port = serial.Serial(args.serial, args.baud, timeout=1)
+        while True:
+            data = port.read(256)
+            if data:
+                yield data
+    else:
+        stream = open(args.file, "rb") if args.file else getattr(sys.stdin, "buffer", sys.stdin)
+        while True:
+            data = stream.read(4096)
+            if not data:
+                return
+            yield data
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Ardusat SDK binary frames to CSV")
+    parser.add_argument("file", nargs="?", help="capture file to decode (default: stdin)")
+    parser.add_argument("--serial", help="serial port to read frames from (requires pyserial)")
+    parser.add_argument("--baud", type=int, default=9600, help="serial baud rate (default: 9600)")
+    args = parser.parse_args()
+
+    decoder = FrameDecoder()
+    print("timestamp (millis),sensor,unit,values...")
+    try:
+        for chunk in read_chunks(args):
+            for frame in decoder.feed(chunk):
+                print(format_csv(frame))
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if decoder.bad_frames:
+        sys.stderr.write("skipped %d corrupt frames\n" % decoder.bad_frames)
+    if decoder.lost_deltas:
+        sys.stderr.write("skipped %d delta frames waiting for a keyframe\n" % decoder.lost_deltas)
+
+
+if __name__ == "__main__":
+    main()
@@ -23,7 +23,7 @@ function deploy () {
     mkdir tmp_ArdusatSDK
     cp -r ./ArdusatSDK tmp_ArdusatSDK/ArdusatSDK
     cd tmp_ArdusatSDK
-    rm -rf ./ArdusatSDK/.git ./ArdusatSDK/decode_binary ./ArdusatSDK/.ycm* ./ArdusatSDK/*.pyc ./ArdusatSDK/deploy_sdk.sh ./ArdusatSDK/.gitignore
+    rm -rf ./ArdusatSDK/.git ./ArdusatSDK/decode_binary ./ArdusatSDK/sram_report ./ArdusatSDK/tools ./ArdusatSDK/.ycm* ./ArdusatSDK/*.pyc ./ArdusatSDK/deploy_sdk.sh ./ArdusatSDK/.gitignore
     zip -r ArdusatSDK.zip ./ArdusatSDK
     cp -f ArdusatSDK.zip ~/Downloads/ArdusatSDK.zip
 }
@@ -0,0 +1,171 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  benchmark.ino
+ *
+ *    Description:  Measures what each reading costs: the time taken by read() and
+ *                  the CSV/JSON formatting, and the I2C transactions, bytes and
+ *                  estimated bus time behind each sample. Run it before and after a
+ *                  change to a driver or the output code to see what the change
+ *                  bought.
+ *
+ *        Version:  1.0
+ *        Created:  10/14/2026
+ *       Revision:  none
+ *       Compiler:  Arduino
+ *
+ *   Organization:  Ardusat
+ *
+ * =====================================================================================
+ */
+
+/*-----------------------------------------------------------------------------
+ *  Includes
+ *-----------------------------------------------------------------------------*/
+#include <Arduino.h>
+#include <Wire.h>
+#include <ArdusatSDK.h>
+
+/*-----------------------------------------------------------------------------
+ *  Setup Software Serial to allow for both RF communication and USB communication
+ *    RX is digital pin 8 (connect to TX/DOUT of RF Device)
+ *    TX is digital pin 9 (connect to RX/DIN of RF Device)
+ *-----------------------------------------------------------------------------*/
+ArdusatSerial serialConnection(SERIAL_MODE_HARDWARE_AND_SOFTWARE, 8, 9);
+
+/*-----------------------------------------------------------------------------
+ *  Number of times each operation is run; the results are per run
+ *-----------------------------------------------------------------------------*/
+#define ITERATIONS 50
+
+Acceleration accel;
+Gyro gyro;
+Magnetic mag;
+Orientation orient(accel, mag);
+FusedOrientation fused(gyro, accel, mag);
+Luminosity lum;
+Pressure pressure;
+Temperature temp;
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  report
+ *  Description:  Prints one line of results: us per run, then I2C transactions,
+ *                bytes and estimated us on the bus per run.
+ * =====================================================================================
+ */
+void report(const char * name, unsigned long elapsed)
+{
+  serialConnection.print(name);
+  serialConnection.print(", us: ");
+  serialConnection.print(elapsed / ITERATIONS);
+  serialConnection.print(", transactions: ");
+  serialConnection.print((float) ArdusatBus.transactionCount() / ITERATIONS);
+  serialConnection.print(", bytes: ");
+  serialConnection.print((float) ArdusatBus.byteCount() / ITERATIONS);
+  serialConnection.print(", bus us: ");
+  serialConnection.println(ArdusatBus.busMicros() / ITERATIONS);
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  benchRead
+ *  Description:  Times ITERATIONS blocking reads of a sensor.
+ * =====================================================================================
+ */
+void benchRead(Sensor & sensor, const char * name)
+{
+  unsigned long start;
+
+  if (!sensor.initialized) {
+    serialConnection.print(name);
+    serialConnection.println(", not found");
+    return;
+  }
+
+  ArdusatBus.resetCounts();
+  start = micros();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    sensor.read();
+  }
+  report(name, micros() - start);
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  benchFormat
+ *  Description:  Times the CSV and JSON output of the last reading, without the
+ *                read or the serial port.
+ * =====================================================================================
+ */
+void benchFormat(void)
+{
+  unsigned long start;
+
+  ArdusatBus.resetCounts();
+  start = micros();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    accel.toCSV("accelerometer");
+  }
+  report("toCSV", micros() - start);
+
+  start = micros();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    accel.toJSON("accelerometer");
+  }
+  report("toJSON", micros() - start);
+
+  start = micros();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    valuesToCSV("accelerometer", millis(), 3, accel.x, accel.y, accel.z);
+  }
+  report("valuesToCSV", micros() - start);
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  setup
+ *  Description:  This function runs when the Arduino first turns on/resets. This is
+ *                our chance to take care of all one-time configuration tasks to get
+ *                the program ready to begin logging data.
+ * =====================================================================================
+ */
+void setup(void)
+{
+  serialConnection.begin(9600);
+
+  accel.begin();
+  gyro.begin();
+  mag.begin();
+  orient.begin();
+  fused.begin();
+  lum.begin();
+  pressure.begin();
+  temp.begin();
+
+  /* We're ready to go! */
+  serialConnection.println("");
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  loop
+ *  Description:  After setup runs, this loop function runs until the Arduino loses
+ *                power or resets. Each pass runs the whole benchmark once.
+ * =====================================================================================
+ */
+void loop(void)
+{
+  benchRead(accel, "acceleration");
+  benchRead(gyro, "gyro");
+  benchRead(mag, "magnetic");
+  benchRead(orient, "orientation");
+  benchRead(fused, "fused orientation");
+  benchRead(lum, "luminosity");
+  benchRead(pressure, "pressure");
+  benchRead(temp, "temperature");
+  benchFormat();
+
+  serialConnection.println("");
+  delay(5000);
+}
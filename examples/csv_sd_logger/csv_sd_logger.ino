@@ -3,8 +3,13 @@
  *
  *       Filename:  csv.ino
  *
- *    Description:  Outputs the values from two different sensors into text properly
- *                  formatted for a CSV file.
+ *    Description:  Logs the values from two different sensors to a CSV file on an
+ *                  SD card, a whole 512 byte block at a time so that logging
+ *                  doesn't stall the sketch. Each file is preallocated, and a new
+ *                  one is started once it's full.
+ *
+ *                  Needs the SdFat library (version 2), and an SD card module with
+ *                  its chip select on pin 10.
  *
  *                  This example uses many third-party libraries available from
  *                  Adafruit (https://github.com/adafruit). These libraries are
@@ -29,6 +34,8 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <ArdusatSDK.h>
+#include <SdFat.h>
+#include <utility/sd_sink.h>
 
 /*-----------------------------------------------------------------------------
  *  Setup Software Serial to allow for both RF communication and USB communication
@@ -40,9 +47,44 @@ ArdusatSerial serialConnection(SERIAL_MODE_HARDWARE_AND_SOFTWARE, 8, 9);
 /*-----------------------------------------------------------------------------
  *  Constant Definitions
  *-----------------------------------------------------------------------------*/
+#define SD_CS_PIN 10
+#define LOG_FILE_SIZE 1048576UL  /* bytes preallocated for each log file */
+
 Acceleration accel;
 Temperature temp;
 
+SdFat sd;
+FsFile logFile;
+SDBlockSink<FsFile> logSink(logFile);
+int logNumber = 0;
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  openLog
+ *  Description:  Creates the next log file (log0.csv, log1.csv, ...), preallocates
+ *                it and writes the CSV header.
+ * =====================================================================================
+ */
+boolean openLog(void)
+{
+  char name[16];
+
+  sprintf(name, "log%d.csv", logNumber++);
+  if (!logFile.open(name, O_WRONLY | O_CREAT | O_TRUNC) ||
+      !logSink.preallocate(LOG_FILE_SIZE)) {
+    serialConnection.println("couldn't create the log file");
+    return false;
+  }
+
+  serialConnection.print("logging to ");
+  serialConnection.println(name);
+
+  logSink.print("timestamp (millis), name, ");
+  logSink.print("temperature (C), x acceleration (m/s^2), y acceleration (m/s^2), z acceleration (m/s^2), ");
+  logSink.println("checksum");
+  return true;
+}
+
 /*
  * ===  FUNCTION  ======================================================================
  *         Name:  setup
@@ -58,11 +100,18 @@ void setup(void)
   accel.begin();
   temp.begin();
 
+  if (!sd.begin(SD_CS_PIN)) {
+    serialConnection.println("SD card not found");
+    while (true);
+  }
+
+  /* openLog() prints its own error */
+  if (!openLog()) {
+    while (true);
+  }
+
   /* We're ready to go! */
   serialConnection.println("");
-  serialConnection.print("timestamp (millis), name, ");
-  serialConnection.print("temperature (C), x acceleration (m/s^2), y acceleration (m/s^2), z acceleration (m/s^2), ");
-  serialConnection.println("checksum");
 }
 
 /*
@@ -70,8 +119,9 @@ void setup(void)
  *         Name:  loop
  *  Description:  After setup runs, this loop function runs until the Arduino loses
  *                power or resets. We go through and update each of the attached
- *                sensors, write out the updated values in JSON format, then delay
- *                before repeating the loop again.
+ *                sensors, log the updated values in CSV format, then delay
+ *                before repeating the loop again. Writing to the log only copies
+ *                into RAM, except when a block fills up.
  * =====================================================================================
  */
 void loop(void)
@@ -79,7 +129,12 @@ void loop(void)
   accel.read();
   temp.read();
   
-  serialConnection.println(valuesToCSV("reading", accel.header.timestamp, 4, temp.t, accel.x, accel.y, accel.z));
+  logSink.println(valuesToCSV("reading", accel.header.timestamp, 4, temp.t, accel.x, accel.y, accel.z));
+
+  if (logSink.size() >= LOG_FILE_SIZE - SD_SINK_BLOCK_SIZE) {
+    logSink.close();
+    openLog();
+  }
 
-  delay(1000);
+  delay(100);
 }
@@ -0,0 +1,115 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  scheduler.ino
+ *
+ *    Description:  Samples the IMU at 100 Hz while the slower sensors are read at
+ *                  their own rates, without their conversion/integration times
+ *                  holding up the IMU. Outputs each reading in CSV format that
+ *                  can be streamed to the Ardusat Experiment Platform
+ *                  (http://experiments.ardusat.com).
+ *
+ *        Version:  1.0
+ *        Created:  10/14/2026
+ *       Revision:  none
+ *       Compiler:  Arduino
+ *
+ *   Organization:  Ardusat
+ *
+ * =====================================================================================
+ */
+
+/*-----------------------------------------------------------------------------
+ *  Includes
+ *-----------------------------------------------------------------------------*/
+#include <Arduino.h>
+#include <Wire.h>
+#include <ArdusatSDK.h>
+
+/*-----------------------------------------------------------------------------
+ *  200 IMU readings a second need more bandwidth than 9600 baud offers, so this
+ *  example only uses hardware serial and runs it at 115200 baud.
+ *-----------------------------------------------------------------------------*/
+ArdusatSerial serialConnection(SERIAL_MODE_HARDWARE);
+
+Acceleration accel;
+Gyro gyro;
+Luminosity lum;
+Pressure pressure;
+RGBLight rgb;
+
+SensorScheduler scheduler;
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  printAccel, printGyro, ...
+ *  Description:  Called by the scheduler every time the matching sensor has a new
+ *                reading ready.
+ * =====================================================================================
+ */
+void printAccel(Sensor & sensor)
+{
+  accel.writeCSV(serialConnection, "accelerometer");
+}
+
+void printGyro(Sensor & sensor)
+{
+  gyro.writeCSV(serialConnection, "gyro");
+}
+
+void printLum(Sensor & sensor)
+{
+  lum.writeCSV(serialConnection, "luminosity");
+}
+
+void printPressure(Sensor & sensor)
+{
+  pressure.writeCSV(serialConnection, "pressure");
+}
+
+void printRGB(Sensor & sensor)
+{
+  rgb.writeCSV(serialConnection, "rgb");
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  setup
+ *  Description:  This function runs when the Arduino first turns on/resets. This is
+ *                our chance to take care of all one-time configuration tasks to get
+ *                the program ready to begin logging data.
+ * =====================================================================================
+ */
+void setup(void)
+{
+  serialConnection.begin(115200);
+
+  accel.begin();
+  gyro.begin();
+  lum.begin();
+  pressure.begin();
+  rgb.begin();
+
+  //             sensor,    period (ms), callback
+  scheduler.add(accel,     10,          printAccel);    // 100 Hz
+  scheduler.add(gyro,      10,          printGyro);     // 100 Hz
+  scheduler.add(lum,       500,         printLum);      // 2 Hz
+  scheduler.add(pressure,  1000,        printPressure); // 1 Hz
+  scheduler.add(rgb,       5000,        printRGB);      // 0.2 Hz
+
+  /* We're ready to go! */
+  serialConnection.println("");
+}
+
+/*
+ * ===  FUNCTION  ======================================================================
+ *         Name:  loop
+ *  Description:  After setup runs, this loop function runs until the Arduino loses
+ *                power or resets. The scheduler starts readings as they are due and
+ *                calls back as each one finishes, so there's no delay here.
+ * =====================================================================================
+ */
+void loop(void)
+{
+  scheduler.run();
+}
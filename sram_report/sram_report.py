@@ -0,0 +1,240 @@
+#!/usr/bin/env python
+"""
+Lists the SRAM a compiled sketch uses, with the Ardusat SDK's share broken out
+symbol by symbol: the output buffer, serial and FIFO buffers, sensor objects,
+string tables that didn't make it into PROGMEM, and the vtables that avr-gcc
+keeps in RAM for every Sensor class. It also lists the size of an object of
+each sensor class, so the cost of adding another sensor is known up front.
+
+It reads the symbol table of the sketch's ELF file with avr-nm. The file and
+line numbers come from the debug information the Arduino IDE builds with, and
+tell the SDK's symbols apart from the core's, Wire's and the sketch's. The
+types of the variables and the sizes of the classes come from the same debug
+information, read with avr-objdump, so sensors and other SDK objects the
+sketch declares as globals count towards the SDK too. Only .data and .bss are
+counted; the heap and stack aren't known until run time, so build the SDK with
+ARDUSAT_STATIC_BUFFERS (see utility/config.h) for the output buffer to be
+counted too.
+
+Usage:
+    python sram_report.py sketch.ino.elf
+    python sram_report.py --budget 600 sketch.ino.elf   (exits 1 if the SDK uses more)
+    python sram_report.py --all --nm /path/to/avr-nm --objdump /path/to/avr-objdump sketch.ino.elf
+
+With arduino-cli, `arduino-cli compile --build-path build ...` leaves the ELF in
+build/. In the Arduino IDE, turn on verbose output during compilation to see
+where it is.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# AVR data memory is mapped at 0x800000 in the ELF; anything below is flash
+RAM_OFFSET = 0x800000
+
+NM_LINE = re.compile(r"^([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+(\S)\s+(.*?)(?:\t(\S+):(\d+))?$")
+
+DIE_LINE = re.compile(r"^\s*<(\d+)><([0-9a-fA-F]+)>: Abbrev Number: \d+ \((DW_TAG_\w+)\)")
+ATTR_LINE = re.compile(r"^\s*<[0-9a-fA-F]+>\s+(DW_AT_\w+)\s*: (.*)$")
+
+# Types that only wrap the one they refer to
+WRAPPER_TAGS = ("DW_TAG_typedef", "DW_TAG_const_type", "DW_TAG_volatile_type", "DW_TAG_array_type")
+CLASS_TAGS = ("DW_TAG_class_type", "DW_TAG_structure_type")
+
+
+class Symbol(object):
+    def __init__(self, address, kind, name, size, path, line):
+        self.address = address
+        self.kind = kind
+        self.name = name
+        self.size = size
+        self.path = path
+        self.line = line
+
+    def in_ram(self):
+        return self.address >= RAM_OFFSET and self.kind.lower() in "bdrvw"
+
+    def location(self):
+        if not self.path:
+            return "?"
+        return "%s:%s" % (self.path.replace("\\", "/").split("/")[-1], self.line)
+
+
+def read_symbols(nm, elf):
+    """
+    Returns every sized symbol, biggest first
+    """
+    output = subprocess.check_output([nm, "--print-size", "--size-sort", "--reverse-sort",
+                                      "--demangle", "--line-numbers", elf])
+    symbols = []
+
+    for line in output.decode("utf-8", "replace").splitlines():
+        match = NM_LINE.match(line)
+        if match is None:
+            continue
+        address, size, kind, name, path, lineno = match.groups()
+        symbols.append(Symbol(int(address, 16), kind, name, int(size, 16), path, lineno))
+
+    return symbols
+
+
+def read_dies(objdump, elf):
+    """
+    Returns the entries of the debug information by offset, with the
+    attributes the report needs
+    """
+    output = subprocess.check_output([objdump, "--dwarf=info", elf])
+    dies = {}
+    parents = []
+    die = None
+
+    for line in output.decode("utf-8", "replace").splitlines():
+        match = DIE_LINE.match(line)
+        if match is not None:
+            depth, offset, tag = match.groups()
+            del parents[int(depth):]
+            die = {"tag": tag, "bases": []}
+            if tag == "DW_TAG_inheritance" and parents:
+                parents[-1]["bases"].append(die)
+            dies[int(offset, 16)] = die
+            parents.append(die)
+            continue
+
+        match = ATTR_LINE.match(line)
+        if match is None or die is None:
+            continue
+        attr, value = match.groups()
+        if attr == "DW_AT_name":
+            # (indirect string, offset: 0x62eb): Gyro
+            die["name"] = value.rsplit("): ", 1)[-1] if value.startswith("(") else value.strip()
+        elif attr == "DW_AT_byte_size":
+            die["size"] = int(value.split()[0], 0)
+        elif attr == "DW_AT_declaration":
+            die["declaration"] = True
+        elif attr == "DW_AT_type":
+            ref = re.search(r"<0x([0-9a-fA-F]+)>", value)
+            if ref is not None:
+                die["type"] = int(ref.group(1), 16)
+        elif attr == "DW_AT_location":
+            addr = re.search(r"DW_OP_addr: ([0-9a-fA-F]+)", value)
+            if addr is not None:
+                die["address"] = int(addr.group(1), 16)
+
+    return dies
+
+
+def class_of(dies, offset):
+    """
+    Returns the class or struct entry a type is, or is an array of
+    """
+    die = dies.get(offset)
+    while die is not None and die["tag"] in WRAPPER_TAGS:
+        die = dies.get(die.get("type"))
+    if die is None or die["tag"] not in CLASS_TAGS:
+        return None
+    return die
+
+
+def derives_from(dies, die, name):
+    if die.get("name") == name:
+        return True
+    for base in die["bases"]:
+        parent = class_of(dies, base.get("type"))
+        if parent is not None and derives_from(dies, parent, name):
+            return True
+    return False
+
+
+def read_types(objdump, elf):
+    """
+    Returns the size of each sensor class, and the class of each global
+    variable by address
+    """
+    dies = read_dies(objdump, elf)
+    sensors = {}
+    variables = {}
+
+    for die in dies.values():
+        if (die["tag"] in CLASS_TAGS and "name" in die and "size" in die and
+                not die.get("declaration") and derives_from(dies, die, "Sensor")):
+            sensors[die["name"]] = die["size"]
+        elif die["tag"] == "DW_TAG_variable" and "address" in die:
+            type_die = class_of(dies, die.get("type"))
+            if type_die is not None and "name" in type_die:
+                variables[die["address"]] = type_die["name"]
+
+    return sensors, variables
+
+
+def in_sdk(symbol, sdk_path):
+    return symbol.path is not None and sdk_path in symbol.path.replace("\\", "/")
+
+
+def sdk_classes(symbols, sdk_path):
+    """
+    Returns the classes with methods in the SDK. Their vtables have no line
+    information, so they're told apart by name.
+    """
+    classes = set()
+
+    for symbol in symbols:
+        if in_sdk(symbol, sdk_path) and "::" in symbol.name:
+            classes.add(symbol.name.split("(")[0].rsplit("::", 1)[0])
+    return classes
+
+
+def is_sdk(symbol, sdk_path, classes, variables):
+    if symbol.name.startswith("vtable for "):
+        return symbol.name[len("vtable for "):] in classes
+    return in_sdk(symbol, sdk_path) or variables.get(symbol.address) in classes
+
+
+def print_table(title, symbols):
+    print("%s: %d bytes" % (title, sum(s.size for s in symbols)))
+    for symbol in symbols:
+        print("  %6d  %-48s %s" % (symbol.size, symbol.name, symbol.location()))
+    print("")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report the SRAM used by the Ardusat SDK in a sketch")
+    parser.add_argument("elf", help="the sketch's compiled .elf file")
+    parser.add_argument("--nm", default="avr-nm", help="avr-nm to use (default: avr-nm on the PATH)")
+    parser.add_argument("--objdump", default="avr-objdump",
+                        help="avr-objdump to use (default: avr-objdump on the PATH)")
+    parser.add_argument("--sdk-path", default="ArdusatSDK",
+                        help="part of the path of every SDK source file (default: ArdusatSDK)")
+    parser.add_argument("--budget", type=int,
+                        help="fail (exit status 1) if the SDK uses more than this many bytes")
+    parser.add_argument("--all", action="store_true", help="also list the symbols outside the SDK")
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.nm, args.elf)
+    classes = sdk_classes(symbols, args.sdk_path)
+    sensors, variables = read_types(args.objdump, args.elf)
+    ram = [s for s in symbols if s.in_ram()]
+    sdk = [s for s in ram if is_sdk(s, args.sdk_path, classes, variables)]
+    other = [s for s in ram if not is_sdk(s, args.sdk_path, classes, variables)]
+
+    print("Sensor object sizes:")
+    for size, name in sorted(((size, name) for name, size in sensors.items()), reverse=True):
+        print("  %6d  %s" % (size, name))
+    print("")
+
+    print_table("Ardusat SDK", sdk)
+    if args.all:
+        print_table("Core, libraries and sketch", other)
+
+    sdk_total = sum(s.size for s in sdk)
+    total = sdk_total + sum(s.size for s in other)
+    print("SDK %d bytes of %d bytes of .data and .bss" % (sdk_total, total))
+
+    if args.budget is not None and sdk_total > args.budget:
+        sys.stderr.write("SDK uses %d bytes, over the budget of %d\n" % (sdk_total, args.budget))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
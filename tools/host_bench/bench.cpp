@@ -0,0 +1,185 @@
+/**
+ * @file   bench.cpp
+ * @date   October 14, 2026
+ * @brief  Benchmarks the SDK's read and output paths on the host
+ *
+ * Each sensor of the simulated kit is read a number of times, and for each
+ * sample this prints the bus traffic (STARTs, STOPs, bytes including address
+ * bytes), the time the bus was busy, the simulated time the read took
+ * (bus time plus the driver's delays), and the host CPU time. The output
+ * functions are timed the same way. Bus traffic and simulated time are what
+ * the board would see; host CPU time is only comparable between runs on the
+ * same machine, for spotting changes in the formatting code.
+ *
+ *   bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ArdusatSDK.h>
+#include "sim.h"
+#include "kit.h"
+
+#define DEFAULT_ITERATIONS 100
+
+static int iterations = DEFAULT_ITERATIONS;
+
+Acceleration accel;
+Gyro gyro;
+Magnetic mag;
+Orientation orient(accel, mag);
+FusedOrientation fused(gyro, accel, mag);
+Luminosity lum;
+Pressure pressure;
+Temperature temp;
+TemperatureMLX irTemp;
+UVLightML uv;
+
+static uint64_t _hostNanos(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+typedef struct {
+  uint64_t simStart;
+  uint64_t hostStart;
+} bench_t;
+
+static void _start(bench_t *bench)
+{
+  simBus.resetCounts();
+  ArdusatBus.resetCounts();
+  bench->simStart = simNanos();
+  bench->hostStart = _hostNanos();
+}
+
+/*
+ * Prints one line of results, per run
+ */
+static void _report(const char *name, const bench_t *bench, size_t outputBytes)
+{
+  uint64_t host = _hostNanos() - bench->hostStart;
+  uint64_t sim = simNanos() - bench->simStart;
+  const sim_bus_counts_t & counts = simBus.counts();
+
+  printf("%-18s %7.1f %7.1f %7.1f %8.1f %10.1f %9.0f", name,
+         (double) counts.starts / iterations, (double) counts.stops / iterations,
+         (double) counts.bytes / iterations, (double) counts.busNanos / 1000.0 / iterations,
+         (double) sim / 1000.0 / iterations, (double) host / iterations);
+  if (outputBytes > 0) {
+    printf(" %7.1f", (double) outputBytes / iterations);
+  }
+  printf("\n");
+}
+
+static void _benchRead(Sensor & sensor, const char *name)
+{
+  bench_t bench;
+  int failed = 0;
+
+  if (!sensor.initialized) {
+    printf("%-18s not found\n", name);
+    return;
+  }
+
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    if (!sensor.read()) {
+      failed++;
+    }
+  }
+  _report(name, &bench, 0);
+
+  if (failed > 0) {
+    printf("%-18s %d of %d reads failed\n", "", failed, iterations);
+  }
+}
+
+static void _benchFormat(void)
+{
+  bench_t bench;
+  size_t bytes;
+
+  bytes = 0;
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    bytes += strlen(valuesToCSV("accelerometer", accel.header.timestamp, 3, accel.x, accel.y, accel.z));
+  }
+  _report("valuesToCSV", &bench, bytes);
+
+  bytes = 0;
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    bytes += strlen(valuesToJSON("accelerometer", DATA_UNIT_METER_PER_SECONDSQUARED, 3,
+                                 "x", accel.x, "y", accel.y, "z", accel.z));
+  }
+  _report("valuesToJSON", &bench, bytes);
+
+  bytes = 0;
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    bytes += strlen(accel.toCSV("accelerometer"));
+  }
+  _report("toCSV", &bench, bytes);
+
+  bytes = 0;
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    bytes += strlen(accel.toJSON("accelerometer"));
+  }
+  _report("toJSON", &bench, bytes);
+
+  bytes = 0;
+  _start(&bench);
+  for (int i = 0; i < iterations; ++i) {
+    bytes += binaryFrameLength(accel.toBinary());
+  }
+  _report("toBinary", &bench, bytes);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+    if (iterations < 1) {
+      fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  attachKit();
+
+  accel.begin();
+  gyro.begin();
+  mag.begin();
+  orient.begin();
+  fused.begin();
+  lum.begin();
+  pressure.begin();
+  temp.begin();
+  irTemp.begin();
+  uv.begin();
+
+  printf("%d runs each, I2C at %lu kHz. Per run:\n\n", iterations,
+         (unsigned long) (ArdusatBus.defaultClock() / 1000));
+  printf("%-18s %7s %7s %7s %8s %10s %9s %7s\n", "", "starts", "stops", "bytes",
+         "bus us", "total us", "host ns", "output");
+
+  _benchRead(accel, "acceleration");
+  _benchRead(gyro, "gyro");
+  _benchRead(mag, "magnetic");
+  _benchRead(orient, "orientation");
+  _benchRead(fused, "fused orientation");
+  _benchRead(lum, "luminosity");
+  _benchRead(pressure, "pressure");
+  _benchRead(temp, "temperature");
+  _benchRead(irTemp, "IR temperature");
+  _benchRead(uv, "UV light");
+  _benchFormat();
+
+  return 0;
+}
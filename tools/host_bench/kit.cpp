@@ -0,0 +1,146 @@
+/**
+ * @file   kit.cpp
+ * @date   October 14, 2026
+ * @brief  Register maps of the Space Kit's sensors, for the host build
+ *
+ * Each map holds what the drivers check on begin() (ID registers) and a fixed
+ * reading, so every read does the same bus traffic as on the board. Readings
+ * are roughly a kit lying flat on a desk. There's no ISL29125 at 0x44 or TCS34725 at
+ * 0x29, so the SDK detects the kit rather than the spaceboard and the
+ * spaceboard-only sensors aren't simulated. Nor is the SI1132: its
+ * command/response protocol doesn't fit a register map.
+ */
+
+#include <Arduino.h>
+#include <utility/drivers.h>
+#include "sim.h"
+#include "kit.h"
+
+/*
+ * LSM303DLHC accelerometer. Sub-addresses only auto-increment with bit 7 set.
+ * 4 mg per count at the SDK's default +/-8 g, left-aligned 12 bit.
+ */
+static class LSM303AccelMap : public RegisterMap {
+  public:
+    LSM303AccelMap() : RegisterMap(DRIVER_LSM303_DLHC_ACCEL_ADDR, 0x7F, 0x80) {
+      set8(0x20, 0x07);                      // CTRL_REG1_A
+      set16LE(0x28, (uint16_t) (12 << 4));   // OUT_X_A
+      set16LE(0x2A, (uint16_t) (-5 << 4));   // OUT_Y_A
+      set16LE(0x2C, (uint16_t) (245 << 4));  // OUT_Z_A
+    }
+} _lsm303_accel;
+
+/*
+ * LSM303DLHC magnetometer. Big endian, in X, Z, Y order.
+ */
+static class LSM303MagMap : public RegisterMap {
+  public:
+    LSM303MagMap() : RegisterMap(DRIVER_LSM303_ADDR) {
+      set16(0x03, (uint16_t) 230);   // OUT_X_M
+      set16(0x05, (uint16_t) -420);  // OUT_Z_M
+      set16(0x07, (uint16_t) -120);  // OUT_Y_M
+      set8(0x09, 0x01);              // SR_REG_M: data ready
+      set8(0x0F, 0x3C);              // WHO_AM_I_M, read to tell the DLHC apart
+    }
+} _lsm303_mag;
+
+/*
+ * L3GD20H gyro. Sub-addresses only auto-increment with bit 7 set.
+ */
+static class L3GD20HMap : public RegisterMap {
+  public:
+    L3GD20HMap() : RegisterMap(L3GD20_ADDRESS, 0x7F, 0x80) {
+      set8(0x0F, L3GD20H_ID);             // WHO_AM_I
+      set16LE(0x28, (uint16_t) 12);       // OUT_X
+      set16LE(0x2A, (uint16_t) -8);       // OUT_Y
+      set16LE(0x2C, (uint16_t) 3);        // OUT_Z
+    }
+} _l3gd20h;
+
+/*
+ * BMP180, with the calibration and readings of the datasheet's worked example
+ * (15.0 C, 699.64 hPa at oversampling 0). Writing a conversion command to the
+ * control register loads its result.
+ */
+static class BMP180Map : public RegisterMap {
+  public:
+    BMP180Map() : RegisterMap(DRIVER_BMP180_ADDR) {
+      static const int16_t calibration[] = {
+        408, -72, -14383, (int16_t) 32741, (int16_t) 32757, 23153, 6190, 4, -32768, -8711, 2868,
+      };
+
+      for (uint8_t i = 0; i < sizeof(calibration) / sizeof(calibration[0]); ++i) {
+        set16(0xAA + 2 * i, (uint16_t) calibration[i]);
+      }
+      set8(0xD0, 0x55);  // chip ID
+    }
+
+  protected:
+    void registerWritten(uint8_t reg, uint8_t value) {
+      if (reg != 0xF4) {
+        return;
+      }
+
+      if (value == 0x2E) {
+        set16(0xF6, 27898);  // UT
+      } else if ((value & 0x3F) == 0x34) {
+        // UP, which the driver shifts down by 8 - oversampling
+        set16(0xF6, 23843);
+        set8(0xF8, 0);
+      }
+    }
+} _bmp180;
+
+/*
+ * TSL2561 light sensor. The command bits are above the 4 bit register
+ * address.
+ */
+static class TSL2561Map : public RegisterMap {
+  public:
+    TSL2561Map() : RegisterMap(DRIVER_TSL2561_ADDR, 0x0F) {
+      set8(0x0A, 0x0A);                // ID, passing the driver's check
+      set16LE(0x0C, 1000);             // channel 0, visible and infrared
+      set16LE(0x0E, 200);              // channel 1, infrared
+    }
+} _tsl2561;
+
+/*
+ * TMP102 temperature sensor, 16 bit registers selected by a 2 bit pointer
+ */
+static class TMP102Map : public RegisterMap {
+  public:
+    TMP102Map() : RegisterMap(DRIVER_TMP102_ADDR, 0x03, 0, 2) {
+      set16(0x00, 0x1900);  // 25.0 C
+      set16(0x01, 0x60A0);  // configuration at power up
+    }
+} _tmp102;
+
+/*
+ * MLX90614 IR thermometer. SMBus words, least significant byte first, then a
+ * PEC byte.
+ */
+static class MLX90614Map : public RegisterMap {
+  public:
+    MLX90614Map() : RegisterMap(DRIVER_MLX90614_ADDR, 0x3F, 0, 3) {
+      set16LE(0x06, 14908);  // Ta, 25.0 C in 0.02 K
+      set16LE(0x07, 15158);  // Tobj1, 30.0 C
+    }
+} _mlx90614;
+
+/**
+ * Puts the kit's sensors on the simulated bus, and sets the ML8511's analog
+ * outputs
+ */
+void attachKit(void)
+{
+  simBus.attach(_lsm303_accel);
+  simBus.attach(_lsm303_mag);
+  simBus.attach(_l3gd20h);
+  simBus.attach(_bmp180);
+  simBus.attach(_tsl2561);
+  simBus.attach(_tmp102);
+  simBus.attach(_mlx90614);
+
+  simSetAnalog(DRIVER_ML8511_UV_PIN, 310);
+  simSetAnalog(DRIVER_ML8511_REF_PIN, 1023);
+}
@@ -0,0 +1,12 @@
+/**
+ * @file   kit.h
+ * @date   October 14, 2026
+ * @brief  Simulated Space Kit sensors for the host build
+ */
+
+#ifndef HOST_KIT_H_
+#define HOST_KIT_H_
+
+void attachKit(void);
+
+#endif
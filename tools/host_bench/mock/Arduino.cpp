@@ -0,0 +1,130 @@
+/**
+ * @file   Arduino.cpp
+ * @date   October 14, 2026
+ * @brief  Simulated clock, pins, EEPROM and Serial for the host build
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include "../sim.h"
+
+HardwareSerial Serial;
+
+static uint64_t _sim_nanos;
+static int _analog[NUM_DIGITAL_PINS];
+static uint8_t _digital[NUM_DIGITAL_PINS];
+static uint8_t _eeprom[E2END + 1];
+static bool _eeprom_erased;
+
+uint64_t simNanos(void)
+{
+  return _sim_nanos;
+}
+
+void simAdvance(uint64_t nanos)
+{
+  _sim_nanos += nanos;
+}
+
+void simSetAnalog(uint8_t pin, int value)
+{
+  if (pin < NUM_DIGITAL_PINS) {
+    _analog[pin] = value;
+  }
+}
+
+unsigned long millis(void)
+{
+  return (unsigned long) (_sim_nanos / 1000000ULL);
+}
+
+unsigned long micros(void)
+{
+  return (unsigned long) (_sim_nanos / 1000ULL);
+}
+
+void delay(unsigned long ms)
+{
+  simAdvance((uint64_t) ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  simAdvance((uint64_t) us * 1000ULL);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  // Inputs float high, as the I2C lines and open-drain sensor outputs do
+  if (pin < NUM_DIGITAL_PINS && mode != OUTPUT) {
+    _digital[pin] = HIGH;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (pin < NUM_DIGITAL_PINS) {
+    _digital[pin] = val ? HIGH : LOW;
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  return pin < NUM_DIGITAL_PINS ? _digital[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  // 13 ADC clocks at the core's 125 kHz ADC clock
+  simAdvance(104000ULL);
+  if (pin < A0) {
+    pin += A0;
+  }
+  return pin < NUM_DIGITAL_PINS ? _analog[pin] : 0;
+}
+
+void attachInterrupt(uint8_t, void (*)(void), int)
+{
+}
+
+void detachInterrupt(uint8_t)
+{
+}
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *s)
+{
+  sprintf(s, "%*.*f", width, prec, val);
+  return s;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  // stderr keeps the SDK's messages out of the benchmark results
+  fputc(c, stderr);
+  return 1;
+}
+
+static uint8_t * _eepromAt(const void *addr)
+{
+  if (!_eeprom_erased) {
+    memset(_eeprom, 0xFF, sizeof(_eeprom));
+    _eeprom_erased = true;
+  }
+  return _eeprom + ((size_t) addr & E2END);
+}
+
+void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+  memcpy(dst, _eepromAt(src), n);
+}
+
+void eeprom_write_block(const void *src, void *dst, size_t n)
+{
+  memcpy(_eepromAt(dst), src, n);
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t n)
+{
+  memcpy(_eepromAt(dst), src, n);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   Arduino.h
+ * @date   October 14, 2026
+ * @brief  The parts of the Arduino AVR core the SDK uses, for the host build
+ *
+ * Time only moves when the SDK waits: delay(), delayMicroseconds() and I2C
+ * transfers advance the simulated clock (see sim.h), so millis() and micros()
+ * measure what a sample would cost on the board rather than host CPU time.
+ */
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <endian.h>
+
+// glibc's byte order macros would shadow the SDK's endian_e values
+#undef BIG_ENDIAN
+#undef LITTLE_ENDIAN
+
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define NOT_AN_INTERRUPT -1
+
+#define PI 3.1415926535897932384626433832795
+
+// ATmega328 pins
+#define NUM_DIGITAL_PINS 20
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define SDA 18
+#define SCL 19
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define lowByte(w)  ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit)  (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit)   ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bit(b) (1UL << (b))
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+#define interrupts() sei()
+#define noInterrupts() cli()
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *s);
+
+#include "HardwareSerial.h"
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file   HardwareSerial.h
+ * @date   October 14, 2026
+ * @brief  Serial for the host build, written to stderr and never receiving
+ */
+
+#ifndef HOST_HARDWARESERIAL_H_
+#define HOST_HARDWARESERIAL_H_
+
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    void end() {}
+    virtual int available(void) { return 0; }
+    virtual int peek(void) { return -1; }
+    virtual int read(void) { return -1; }
+    virtual int availableForWrite(void) { return 63; }
+    virtual size_t write(uint8_t c);
+    using Print::write;
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
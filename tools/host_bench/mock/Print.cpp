@@ -0,0 +1,147 @@
+/**
+ * @file   Print.cpp
+ * @date   October 14, 2026
+ * @brief  Arduino Print class for the host build, formatting as the AVR core does
+ */
+
+#include <math.h>
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+
+  while (size--) {
+    if (write(*buffer++)) {
+      n++;
+    } else {
+      break;
+    }
+  }
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *ifsh)
+{
+  return write(reinterpret_cast<const char *>(ifsh));
+}
+
+size_t Print::print(const char str[])
+{
+  return write(str);
+}
+
+size_t Print::print(char c)
+{
+  return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char b, int base)
+{
+  return print((unsigned long) b, base);
+}
+
+size_t Print::print(int n, int base)
+{
+  return print((long) n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+  return print((unsigned long) n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+  if (base == 0) {
+    return write((uint8_t) n);
+  } else if (base == 10 && n < 0) {
+    return print('-') + printNumber(-(unsigned long) n, 10);
+  }
+  return printNumber(n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  if (base == 0) {
+    return write((uint8_t) n);
+  }
+  return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+  return printFloat(n, digits);
+}
+
+size_t Print::println(void)
+{
+  return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *ifsh) { return print(ifsh) + println(); }
+size_t Print::println(const char c[]) { return print(c) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char b, int base) { return print(b, base) + println(); }
+size_t Print::println(int num, int base) { return print(num, base) + println(); }
+size_t Print::println(unsigned int num, int base) { return print(num, base) + println(); }
+size_t Print::println(long num, int base) { return print(num, base) + println(); }
+size_t Print::println(unsigned long num, int base) { return print(num, base) + println(); }
+size_t Print::println(double num, int digits) { return print(num, digits) + println(); }
+
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+
+  *str = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+
+  return write(str);
+}
+
+size_t Print::printFloat(double number, uint8_t digits)
+{
+  size_t n = 0;
+
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0) return print("ovf");
+  if (number < -4294967040.0) return print("ovf");
+
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) {
+    rounding /= 10.0;
+  }
+  number += rounding;
+
+  unsigned long int_part = (unsigned long) number;
+  double remainder = number - (double) int_part;
+  n += print(int_part);
+
+  if (digits > 0) {
+    n += print('.');
+  }
+
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int toPrint = (unsigned int) remainder;
+    n += print(toPrint);
+    remainder -= toPrint;
+  }
+
+  return n;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file   Print.h
+ * @date   October 14, 2026
+ * @brief  Arduino Print class for the host build
+ */
+
+#ifndef HOST_PRINT_H_
+#define HOST_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>  // avr-libc's stdio.h includes it, and the SDK relies on that
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class Print {
+  private:
+    int write_error;
+    size_t printNumber(unsigned long n, uint8_t base);
+    size_t printFloat(double number, uint8_t digits);
+
+  protected:
+    void setWriteError(int err = 1) { write_error = err; }
+
+  public:
+    Print() : write_error(0) {}
+    virtual ~Print() {}
+
+    int getWriteError() { return write_error; }
+    void clearWriteError() { setWriteError(0); }
+
+    virtual size_t write(uint8_t) = 0;
+    size_t write(const char *str) {
+      if (str == NULL) return 0;
+      return write((const uint8_t *) str, strlen(str));
+    }
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *buffer, size_t size) {
+      return write((const uint8_t *) buffer, size);
+    }
+
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper *);
+    size_t print(const char[]);
+    size_t print(char);
+    size_t print(unsigned char, int = DEC);
+    size_t print(int, int = DEC);
+    size_t print(unsigned int, int = DEC);
+    size_t print(long, int = DEC);
+    size_t print(unsigned long, int = DEC);
+    size_t print(double, int = 2);
+
+    size_t println(const __FlashStringHelper *);
+    size_t println(const char[]);
+    size_t println(char);
+    size_t println(unsigned char, int = DEC);
+    size_t println(int, int = DEC);
+    size_t println(unsigned int, int = DEC);
+    size_t println(long, int = DEC);
+    size_t println(unsigned long, int = DEC);
+    size_t println(double, int = 2);
+    size_t println(void);
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file   Stream.h
+ * @date   October 14, 2026
+ * @brief  Arduino Stream class for the host build
+ */
+
+#ifndef HOST_STREAM_H_
+#define HOST_STREAM_H_
+
+#include "Print.h"
+
+class Stream : public Print {
+  protected:
+    unsigned long _timeout;
+
+  public:
+    Stream() : _timeout(1000) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout(void) { return _timeout; }
+};
+
+#endif
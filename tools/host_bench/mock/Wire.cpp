@@ -0,0 +1,117 @@
+/**
+ * @file   Wire.cpp
+ * @date   October 14, 2026
+ * @brief  Arduino Wire library for the host build, on the simulated I2C bus
+ */
+
+#include <Arduino.h>
+#include "Wire.h"
+#include "../sim.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire() :
+  rxBufferIndex(0),
+  rxBufferLength(0),
+  txAddress(0),
+  txBufferLength(0),
+  transmitting(false),
+  timeoutFlag(false)
+{
+}
+
+void TwoWire::begin(void)
+{
+  rxBufferIndex = 0;
+  rxBufferLength = 0;
+  txBufferLength = 0;
+  simBus.setClock(100000);
+}
+
+void TwoWire::end(void)
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+  simBus.setClock(clock);
+}
+
+void TwoWire::setWireTimeout(uint32_t, bool)
+{
+  timeoutFlag = false;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  transmitting = true;
+  txAddress = address;
+  txBufferLength = 0;
+}
+
+/*
+ * Like the AVR core, this sends whatever is buffered to the last address
+ * given to beginTransmission(), so calling it without one still puts an
+ * address byte on the bus
+ */
+uint8_t TwoWire::endTransmission(uint8_t sendStop)
+{
+  uint8_t ret = simBus.transmit(txAddress, txBuffer, txBufferLength, sendStop);
+
+  txBufferLength = 0;
+  transmitting = false;
+  return ret;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
+{
+  if (quantity > BUFFER_LENGTH) {
+    quantity = BUFFER_LENGTH;
+  }
+
+  rxBufferIndex = 0;
+  rxBufferLength = simBus.receive(address, rxBuffer, quantity, sendStop);
+  return rxBufferLength;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (!transmitting || txBufferLength >= BUFFER_LENGTH) {
+    setWriteError();
+    return 0;
+  }
+
+  txBuffer[txBufferLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  for (size_t i = 0; i < quantity; ++i) {
+    if (!write(data[i])) {
+      return i;
+    }
+  }
+  return quantity;
+}
+
+int TwoWire::available(void)
+{
+  return rxBufferLength - rxBufferIndex;
+}
+
+int TwoWire::read(void)
+{
+  if (rxBufferIndex < rxBufferLength) {
+    return rxBuffer[rxBufferIndex++];
+  }
+  return -1;
+}
+
+int TwoWire::peek(void)
+{
+  if (rxBufferIndex < rxBufferLength) {
+    return rxBuffer[rxBufferIndex];
+  }
+  return -1;
+}
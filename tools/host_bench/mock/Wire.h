@@ -0,0 +1,77 @@
+/**
+ * @file   Wire.h
+ * @date   October 14, 2026
+ * @brief  Arduino Wire library for the host build, on the simulated I2C bus
+ *
+ * Buffers and return codes follow the AVR core's Wire (1.8.3 or newer, with
+ * timeouts): transfers of up to BUFFER_LENGTH bytes, endTransmission()
+ * returning 2 when the address isn't acknowledged, and requestFrom()
+ * returning the number of bytes read. Each transfer goes to SimBus, which
+ * counts it and advances the simulated clock.
+ */
+
+#ifndef HOST_WIRE_H_
+#define HOST_WIRE_H_
+
+#include <stdint.h>
+#include "Stream.h"
+
+#define BUFFER_LENGTH 32
+#define WIRE_HAS_TIMEOUT
+
+class TwoWire : public Stream {
+  private:
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    uint8_t rxBufferIndex;
+    uint8_t rxBufferLength;
+
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txBufferLength;
+
+    bool transmitting;
+    bool timeoutFlag;
+
+  public:
+    TwoWire();
+
+    void begin();
+    void end();
+    void setClock(uint32_t clock);
+    void setWireTimeout(uint32_t timeout = 25000, bool reset_with_timeout = false);
+    bool getWireTimeoutFlag(void) { return timeoutFlag; }
+    void clearWireTimeoutFlag(void) { timeoutFlag = false; }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+    uint8_t endTransmission(uint8_t sendStop);
+    uint8_t endTransmission(void) { return endTransmission((uint8_t) true); }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+      return requestFrom(address, quantity, (uint8_t) true);
+    }
+    uint8_t requestFrom(int address, int quantity) {
+      return requestFrom((uint8_t) address, (uint8_t) quantity, (uint8_t) true);
+    }
+    uint8_t requestFrom(int address, int quantity, int sendStop) {
+      return requestFrom((uint8_t) address, (uint8_t) quantity, (uint8_t) sendStop);
+    }
+
+    virtual size_t write(uint8_t data);
+    virtual size_t write(const uint8_t *data, size_t quantity);
+    virtual int available(void);
+    virtual int read(void);
+    virtual int peek(void);
+    virtual void flush(void) {}
+
+    inline size_t write(unsigned long n) { return write((uint8_t) n); }
+    inline size_t write(long n) { return write((uint8_t) n); }
+    inline size_t write(unsigned int n) { return write((uint8_t) n); }
+    inline size_t write(int n) { return write((uint8_t) n); }
+    using Print::write;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * @file   eeprom.h
+ * @date   October 14, 2026
+ * @brief  avr-libc EEPROM access for the host build, an erased E2END + 1 bytes
+ */
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+void eeprom_read_block(void *dst, const void *src, size_t n);
+void eeprom_write_block(const void *src, void *dst, size_t n);
+void eeprom_update_block(const void *src, void *dst, size_t n);
+
+#endif
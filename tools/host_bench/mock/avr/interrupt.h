@@ -0,0 +1,13 @@
+/**
+ * @file   interrupt.h
+ * @date   October 14, 2026
+ * @brief  Interrupt control for the host build, where nothing interrupts
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#define cli()
+#define sei()
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file   io.h
+ * @date   October 14, 2026
+ * @brief  ATmega328 constants the SDK uses, for the host build
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#define E2END 0x3FF
+#define RAMEND 0x8FF
+
+#endif
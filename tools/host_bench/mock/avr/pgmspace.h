@@ -0,0 +1,36 @@
+/**
+ * @file   pgmspace.h
+ * @date   October 14, 2026
+ * @brief  avr-libc flash access for the host build, where flash is plain memory
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)  (*(const uint8_t *) (addr))
+#define pgm_read_word(addr)  (*(const uint16_t *) (addr))
+#define pgm_read_dword(addr) (*(const uint32_t *) (addr))
+#define pgm_read_float(addr) (*(const float *) (addr))
+#define pgm_read_ptr(addr)   (*(void * const *) (addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#define memcpy_P   memcpy
+#define strcpy_P   strcpy
+#define strncpy_P  strncpy
+#define strcat_P   strcat
+#define strcmp_P   strcmp
+#define strlen_P   strlen
+#define sprintf_P  sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @file   delay.h
+ * @date   October 14, 2026
+ * @brief  avr-libc busy waits for the host build, on the simulated clock
+ */
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#define _delay_ms(ms) delay((unsigned long) (ms))
+#define _delay_us(us) delayMicroseconds((unsigned int) (us))
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file   sim.cpp
+ * @date   October 14, 2026
+ * @brief  Simulated I2C bus and register-mapped devices for the host build
+ */
+
+#include <string.h>
+#include "sim.h"
+
+SimBus simBus;
+
+RegisterMap::RegisterMap(uint8_t addr, uint8_t regMask, uint8_t autoIncBit, uint8_t regWidth) :
+  SimDevice(addr),
+  _mask(regMask),
+  _autoIncBit(autoIncBit),
+  _width(regWidth ? regWidth : 1),
+  _pos(0),
+  _increment(true),
+  _pointerNext(false)
+{
+  memset(_regs, 0, sizeof(_regs));
+}
+
+void RegisterMap::set8(uint8_t reg, uint8_t value)
+{
+  _regs[(uint8_t) (reg * _width)] = value;
+}
+
+void RegisterMap::set16(uint8_t reg, uint16_t value)
+{
+  uint8_t pos = reg * _width;
+
+  _regs[pos] = value >> 8;
+  _regs[(uint8_t) (pos + 1)] = value & 0xFF;
+}
+
+void RegisterMap::set16LE(uint8_t reg, uint16_t value)
+{
+  uint8_t pos = reg * _width;
+
+  _regs[pos] = value & 0xFF;
+  _regs[(uint8_t) (pos + 1)] = value >> 8;
+}
+
+uint8_t RegisterMap::get8(uint8_t reg)
+{
+  return _regs[(uint8_t) (reg * _width)];
+}
+
+void RegisterMap::beginWrite(void)
+{
+  _pointerNext = true;
+}
+
+void RegisterMap::write(uint8_t value)
+{
+  if (_pointerNext) {
+    _pointerNext = false;
+    _pos = (value & _mask) * _width;
+    _increment = _autoIncBit == 0 || (value & _autoIncBit);
+    return;
+  }
+
+  _regs[_pos] = value;
+  registerWritten(_pos / _width, value);
+  _advance();
+}
+
+uint8_t RegisterMap::read(void)
+{
+  uint8_t value = _regs[_pos];
+
+  _advance();
+  return value;
+}
+
+/*
+ * Moves to the next byte, staying in the same register unless auto-increment
+ * is on
+ */
+void RegisterMap::_advance(void)
+{
+  _pos++;
+  if (!_increment && _pos % _width == 0) {
+    _pos -= _width;
+  }
+}
+
+SimBus::SimBus() :
+  _numDevices(0),
+  _clock(100000)
+{
+  resetCounts();
+}
+
+void SimBus::attach(SimDevice & device)
+{
+  if (_numDevices < SIM_BUS_MAX_DEVICES && _find(device.address()) == NULL) {
+    _devices[_numDevices++] = &device;
+  }
+}
+
+void SimBus::detach(SimDevice & device)
+{
+  for (uint8_t i = 0; i < _numDevices; ++i) {
+    if (_devices[i] == &device) {
+      _devices[i] = _devices[--_numDevices];
+      return;
+    }
+  }
+}
+
+void SimBus::resetCounts(void)
+{
+  memset(&_counts, 0, sizeof(_counts));
+}
+
+SimDevice * SimBus::_find(uint8_t addr)
+{
+  for (uint8_t i = 0; i < _numDevices; ++i) {
+    if (_devices[i]->address() == addr) {
+      return _devices[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Counts bus time and moves the clock on by it, since Wire blocks until a
+ * transfer is done
+ */
+void SimBus::_busy(uint32_t bits)
+{
+  uint64_t nanos = (uint64_t) bits * 1000000000ULL / _clock;
+
+  _counts.busNanos += nanos;
+  simAdvance(nanos);
+}
+
+/**
+ * Sends a START, the address and data, and a STOP if sendStop is set
+ *
+ * @return 0 on success, or 2 if no device acknowledged the address, like
+ *         Wire's endTransmission()
+ */
+uint8_t SimBus::transmit(uint8_t addr, const uint8_t *data, uint8_t length, bool sendStop)
+{
+  SimDevice *device = _find(addr);
+
+  _counts.starts++;
+  _counts.bytes++;
+  if (device == NULL) {
+    _counts.nacks++;
+    _counts.stops++;
+    _busy(1 + 9 + 1);
+    return 2;
+  }
+
+  device->beginWrite();
+  for (uint8_t i = 0; i < length; ++i) {
+    device->write(data[i]);
+  }
+  _counts.bytes += length;
+  if (sendStop) {
+    _counts.stops++;
+  }
+  _busy(1 + 9 * (1 + length) + (sendStop ? 1 : 0));
+  return 0;
+}
+
+/**
+ * Sends a START and the address, reads length bytes, and sends a STOP if
+ * sendStop is set
+ *
+ * @return number of bytes read, 0 if no device acknowledged the address
+ */
+uint8_t SimBus::receive(uint8_t addr, uint8_t *data, uint8_t length, bool sendStop)
+{
+  SimDevice *device = _find(addr);
+
+  _counts.starts++;
+  _counts.bytes++;
+  if (device == NULL) {
+    _counts.nacks++;
+    _counts.stops++;
+    _busy(1 + 9 + 1);
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < length; ++i) {
+    data[i] = device->read();
+  }
+  _counts.bytes += length;
+  if (sendStop) {
+    _counts.stops++;
+  }
+  _busy(1 + 9 * (1 + length) + (sendStop ? 1 : 0));
+  return length;
+}
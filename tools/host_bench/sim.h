@@ -0,0 +1,150 @@
+/**
+ * @file   sim.h
+ * @date   October 14, 2026
+ * @brief  Simulated clock, pins and I2C bus behind the host build's Arduino core
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+
+/**
+ * Most devices that can be attached to the bus at once
+ */
+#define SIM_BUS_MAX_DEVICES 16
+
+/*
+ * Simulated time in ns, advanced only by delays and bus transfers. millis()
+ * and micros() read it.
+ */
+uint64_t simNanos(void);
+void simAdvance(uint64_t nanos);
+
+/*
+ * Sets what analogRead() returns for a pin, 0 to 1023
+ */
+void simSetAnalog(uint8_t pin, int value);
+
+/**
+ * Bus traffic, as a logic analyzer would count it
+ */
+typedef struct {
+  uint32_t starts;    // STARTs and repeated STARTs, one per address byte
+  uint32_t stops;
+  uint32_t bytes;     // bytes on the wire, including address bytes
+  uint32_t nacks;     // address bytes no device acknowledged
+  uint64_t busNanos;  // time the bus was busy, at the clock in use
+} sim_bus_counts_t;
+
+/**************************************************************************//**
+ * @class SimDevice
+ *
+ * @brief An I2C slave on the simulated bus
+ *
+ * The bus calls beginWrite() when a write transfer is addressed to the
+ * device, then write() for each byte of it. Each byte of a read transfer is
+ * a call to read().
+ *****************************************************************************/
+class SimDevice {
+  public:
+    SimDevice(uint8_t addr) : _addr(addr) {}
+    virtual ~SimDevice() {}
+
+    uint8_t address(void) { return _addr; }
+
+    virtual void beginWrite(void) {}
+    virtual void write(uint8_t value) = 0;
+    virtual uint8_t read(void) = 0;
+
+  private:
+    uint8_t _addr;
+};
+
+/**************************************************************************//**
+ * @class RegisterMap
+ *
+ * @brief A device whose registers sit behind a register pointer
+ *
+ * That covers every sensor in the kit. The first byte of a write transfer
+ * sets the pointer, after masking off any command bits with `regMask`; the
+ * bytes after it are written to the registers. Reads start at the pointer.
+ *
+ * The pointer moves on after each byte. With `autoIncBit` set, it only does
+ * so when that bit was set in the pointer byte (like bit 7 on the LSM303
+ * accelerometer and L3GD20H); otherwise a read keeps returning the same
+ * register. Registers are `regWidth` bytes wide, for devices like the TMP102
+ * whose registers are 16 bits and addressed by number.
+ *
+ * Devices that act on a register write (e.g. starting a conversion) override
+ * registerWritten().
+ *****************************************************************************/
+class RegisterMap : public SimDevice {
+  public:
+    RegisterMap(uint8_t addr, uint8_t regMask = 0xFF, uint8_t autoIncBit = 0, uint8_t regWidth = 1);
+
+    void set8(uint8_t reg, uint8_t value);
+    void set16(uint8_t reg, uint16_t value);    // most significant byte first
+    void set16LE(uint8_t reg, uint16_t value);  // least significant byte first
+    uint8_t get8(uint8_t reg);
+
+    virtual void beginWrite(void);
+    virtual void write(uint8_t value);
+    virtual uint8_t read(void);
+
+  protected:
+    virtual void registerWritten(uint8_t reg, uint8_t value) { (void) reg; (void) value; }
+
+    uint8_t _regs[256];
+
+  private:
+    void _advance(void);
+
+    uint8_t _mask;
+    uint8_t _autoIncBit;
+    uint8_t _width;
+    uint8_t _pos;          // byte offset of the pointer in _regs
+    bool _increment;
+    bool _pointerNext;     // the next byte written sets the pointer
+};
+
+/**************************************************************************//**
+ * @class SimBus
+ *
+ * @brief The I2C bus behind the host build's Wire
+ *
+ * Counts each transfer and advances the simulated clock by the time it takes:
+ * 9 bit times per byte, address byte included, and one each for the START and
+ * STOP, at the clock Wire was last set to. Like the AVR TWI, a transfer whose
+ * address isn't acknowledged always ends with a STOP.
+ *****************************************************************************/
+class SimBus {
+  public:
+    SimBus();
+
+    void attach(SimDevice & device);
+    void detach(SimDevice & device);
+    void detachAll(void) { _numDevices = 0; }
+
+    void setClock(uint32_t clock) { _clock = clock; }
+    uint32_t clock(void) { return _clock; }
+
+    uint8_t transmit(uint8_t addr, const uint8_t *data, uint8_t length, bool sendStop);
+    uint8_t receive(uint8_t addr, uint8_t *data, uint8_t length, bool sendStop);
+
+    const sim_bus_counts_t & counts(void) { return _counts; }
+    void resetCounts(void);
+
+  private:
+    SimDevice * _find(uint8_t addr);
+    void _busy(uint32_t bits);
+
+    SimDevice * _devices[SIM_BUS_MAX_DEVICES];
+    uint8_t _numDevices;
+    uint32_t _clock;
+    sim_bus_counts_t _counts;
+};
+
+extern SimBus simBus;
+
+#endif
@@ -37,7 +37,7 @@ Adafruit_SI1145::Adafruit_SI1145() {
 
 
 boolean Adafruit_SI1145::begin(void) {
-  Wire.begin();
+  ArdusatBus.begin();
  
   uint8_t id;
   read8(SI1145_REG_PARTID, &id);
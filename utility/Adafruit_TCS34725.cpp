@@ -30,6 +30,19 @@
 #include "Adafruit_TCS34725.h"
 #include "common_utils.h"
 
+/* Integration times auto-ranging chooses from */
+static const uint8_t _tcs34725IntegrationTimes[] PROGMEM = {
+  TCS34725_INTEGRATIONTIME_2_4MS,
+  TCS34725_INTEGRATIONTIME_24MS,
+  TCS34725_INTEGRATIONTIME_50MS,
+  TCS34725_INTEGRATIONTIME_101MS,
+  TCS34725_INTEGRATIONTIME_154MS,
+  TCS34725_INTEGRATIONTIME_700MS,
+};
+
+/* Auto-ranging keeps the largest channel under this fraction of full scale */
+#define TCS34725_AUTORANGE_HEADROOM (0.8)
+
 #define read8(reg, val) readFromRegAddr(TCS34725_ADDRESS, TCS34725_COMMAND_BIT | reg, val, 1, BIG_ENDIAN)
 #define read16(reg, val) readFromRegAddr(TCS34725_ADDRESS, TCS34725_COMMAND_BIT | reg, val, 2, BIG_ENDIAN)
 #define write8(reg, val) writeToRegAddr(TCS34725_ADDRESS, TCS34725_COMMAND_BIT | reg, val, 1, BIG_ENDIAN)
@@ -63,6 +76,21 @@ void Adafruit_TCS34725::enable(void)
   write8(TCS34725_ENABLE, &buf);
 }
 
+/**************************************************************************/
+/*!
+    Restarts the ADC on a powered up device, throwing away the integration
+    in progress, so that the next completed cycle is all at the new range
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::restart(void)
+{
+  uint8_t buf = TCS34725_ENABLE_PON;
+  write8(TCS34725_ENABLE, &buf);
+
+  buf = TCS34725_ENABLE_PON | TCS34725_ENABLE_AEN;
+  write8(TCS34725_ENABLE, &buf);
+}
+
 /**************************************************************************/
 /*!
     Disables the device (putting it in lower power sleep mode)
@@ -90,8 +118,14 @@ void Adafruit_TCS34725::disable(void)
 Adafruit_TCS34725::Adafruit_TCS34725(tcs34725IntegrationTime_t it, tcs34725Gain_t gain) 
 {
   _tcs34725Initialised = false;
+  _tcs34725Continuous = true;
   _tcs34725IntegrationTime = it;
   _tcs34725Gain = gain;
+  _tcs34725AutoRange = false;
+  _tcs34725ConfigIntegrationTime = it;
+  _tcs34725ConfigGain = gain;
+  _tcs34725LastIntegrationTime = it;
+  _tcs34725LastGain = gain;
 }
 
 /*========================================================================*/
@@ -106,7 +140,7 @@ Adafruit_TCS34725::Adafruit_TCS34725(tcs34725IntegrationTime_t it, tcs34725Gain_
 /**************************************************************************/
 boolean Adafruit_TCS34725::begin(void) 
 {
-  Wire.begin();
+  ArdusatBus.begin();
   
   /* Make sure we're actually connected */
   uint8_t x = 0;
@@ -122,14 +156,19 @@ boolean Adafruit_TCS34725::begin(void)
   setGain(_tcs34725Gain);
 
   /* Note: by default, the device is in power down mode on bootup */
-  enable();
+  if (_tcs34725Continuous)
+  {
+    enable();
+  }
 
   return true;
 }
   
 /**************************************************************************/
 /*!
-    Sets the integration time for the TC34725
+    Sets the integration time for the TC34725. With auto-range enabled,
+    this is the longest integration time it will use, and readings are
+    scaled to it.
 */
 /**************************************************************************/
 void Adafruit_TCS34725::setIntegrationTime(tcs34725IntegrationTime_t it)
@@ -141,6 +180,7 @@ void Adafruit_TCS34725::setIntegrationTime(tcs34725IntegrationTime_t it)
 
   /* Update value placeholders */
   _tcs34725IntegrationTime = it;
+  _tcs34725ConfigIntegrationTime = it;
 }
 
 /**************************************************************************/
@@ -157,44 +197,310 @@ void Adafruit_TCS34725::setGain(tcs34725Gain_t gain)
 
   /* Update value placeholders */
   _tcs34725Gain = gain;
+  _tcs34725ConfigGain = gain;
+}
+
+/**************************************************************************/
+/*!
+    Sets the integration time and gain used for the next integration,
+    without changing the configured ones readings are scaled to. A cycle
+    in progress in continuous mode is restarted.
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::setRange(tcs34725IntegrationTime_t it, tcs34725Gain_t gain)
+{
+  if (!_tcs34725Initialised) begin();
+
+  if (it != _tcs34725IntegrationTime)
+  {
+    write8(TCS34725_ATIME, &it);
+    _tcs34725IntegrationTime = it;
+  }
+  if (gain != _tcs34725Gain)
+  {
+    write8(TCS34725_CONTROL, &gain);
+    _tcs34725Gain = gain;
+  }
+
+  if (_tcs34725Continuous)
+  {
+    restart();
+  }
 }
 
 /**************************************************************************/
 /*!
-    @brief  Reads the raw red, green, blue and clear channel values
+    @brief  Enables or disables choosing the gain and integration time for
+            each integration from the one before it. Goes back to the
+            configured range when disabled.
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::enableAutoRange(boolean enable)
+{
+  _tcs34725AutoRange = enable;
+
+  if (!enable)
+  {
+    setRange(_tcs34725ConfigIntegrationTime, _tcs34725ConfigGain);
+  }
+}
+
+/**************************************************************************/
+/*!
+    Returns the integration time and gain the last reading was taken at
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::getLastRange(tcs34725IntegrationTime_t *it, tcs34725Gain_t *gain)
+{
+  *it = _tcs34725LastIntegrationTime;
+  *gain = _tcs34725LastGain;
+}
+
+/**************************************************************************/
+/*!
+    Private function returning the sensitivity of a range, in counts per
+    count at 2.4ms and 1x
+*/
+/**************************************************************************/
+static float _tcs34725Sensitivity(uint8_t it, uint8_t gain)
+{
+  static const uint8_t gains[] = { 1, 4, 16, 60 };
+
+  return (float) (256 - it) * gains[gain & 0x03];
+}
+
+/**************************************************************************/
+/*!
+    Private function returning the largest count an integration time can
+    give
+*/
+/**************************************************************************/
+static uint16_t _tcs34725MaxCount(uint8_t it)
+{
+  uint16_t cycles = 256 - it;
+
+  return cycles >= 64 ? 65535 : cycles * 1024;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns what the last reading has to be multiplied by to give
+            the counts it would have had at the configured integration
+            time and gain
+*/
+/**************************************************************************/
+float Adafruit_TCS34725::lastRangeScale(void)
+{
+  return _tcs34725Sensitivity(_tcs34725ConfigIntegrationTime, _tcs34725ConfigGain) /
+         _tcs34725Sensitivity(_tcs34725LastIntegrationTime, _tcs34725LastGain);
+}
+
+/**************************************************************************/
+/*!
+    Private function that predicts the clear channel count (the largest
+    channel) the last reading would have given at each range, and switches
+    to the most sensitive one that keeps it under
+    TCS34725_AUTORANGE_HEADROOM of full scale, favouring the shorter
+    integration time of two equally sensitive ones. Integration times
+    longer than the configured one aren't used. A saturated reading can't
+    be predicted from, so it drops straight to the least sensitive range.
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::autoRange(uint16_t c)
+{
+  uint8_t bestTime = TCS34725_INTEGRATIONTIME_2_4MS;
+  uint8_t bestGain = TCS34725_GAIN_1X;
+  float best = 0;
+
+  if (c < _tcs34725MaxCount(_tcs34725IntegrationTime))
+  {
+    float counts = c / _tcs34725Sensitivity(_tcs34725IntegrationTime, _tcs34725Gain);
+
+    for (uint8_t i = 0; i < sizeof(_tcs34725IntegrationTimes); ++i)
+    {
+      uint8_t it = pgm_read_byte(&_tcs34725IntegrationTimes[i]);
+
+      /* Lower ATIME values integrate for longer */
+      if (it < _tcs34725ConfigIntegrationTime)
+      {
+        break;
+      }
+
+      for (uint8_t gain = TCS34725_GAIN_1X; gain <= TCS34725_GAIN_60X; ++gain)
+      {
+        float sensitivity = _tcs34725Sensitivity(it, gain);
+
+        if (sensitivity > best &&
+            counts * sensitivity <= TCS34725_AUTORANGE_HEADROOM * _tcs34725MaxCount(it))
+        {
+          best = sensitivity;
+          bestTime = it;
+          bestGain = gain;
+        }
+      }
+    }
+  }
+
+  if (bestTime != _tcs34725IntegrationTime || bestGain != _tcs34725Gain)
+  {
+    setRange((tcs34725IntegrationTime_t) bestTime, (tcs34725Gain_t) bestGain);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the raw red, green, blue and clear channel values. In
+            continuous mode this returns the last completed integration
+            cycle, only waiting if none has completed since power up.
 */
 /**************************************************************************/
 void Adafruit_TCS34725::getRawData (uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c)
 {
+  unsigned long started;
+
+  startIntegration();
+
+  /* Wait for the first cycle, giving up after one integration time */
+  started = millis();
+  while (!dataReady() && (millis() - started) <= integrationDelay())
+  {
+    delay(1);
+  }
+
+  finishIntegration(r, g, b, c);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true once an integration cycle has completed since the
+            device was powered up
+*/
+/**************************************************************************/
+boolean Adafruit_TCS34725::dataReady(void)
+{
+  uint8_t status = 0;
+
   if (!_tcs34725Initialised) begin();
 
-  read16(TCS34725_CDATAL, c);
-  read16(TCS34725_RDATAL, r);
-  read16(TCS34725_GDATAL, g);
-  read16(TCS34725_BDATAL, b);
-  
-  /* Set a delay for the integration time */
+  read8(TCS34725_STATUS, &status);
+  return (status & TCS34725_STATUS_AVALID) != 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Keeps the device powered and integrating (the default), or
+            powers it up only for each reading to save power
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::setContinuous(boolean continuous)
+{
+  if (!_tcs34725Initialised) begin();
+
+  _tcs34725Continuous = continuous;
+
+  if (continuous)
+  {
+    enable();
+  }
+  else
+  {
+    disable();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Powers the device up for a reading in low power mode. Pair with
+            finishIntegration() once dataReady() is true. Does nothing in
+            continuous mode.
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::startIntegration(void)
+{
+  if (!_tcs34725Initialised) begin();
+
+  if (!_tcs34725Continuous)
+  {
+    enable();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the integration cycle started with startIntegration(),
+            powering the device back down in low power mode. With
+            auto-range enabled, the reading then picks the range for the
+            next integration; lastRangeScale() scales it to the configured
+            range.
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::finishIntegration (uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c)
+{
+  readRawData(r, g, b, c);
+
+  if (!_tcs34725Continuous)
+  {
+    disable();
+  }
+
+  _tcs34725LastIntegrationTime = _tcs34725IntegrationTime;
+  _tcs34725LastGain = _tcs34725Gain;
+
+  if (_tcs34725AutoRange)
+  {
+    autoRange(*c);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the raw red, green, blue and clear channel values of the
+            last completed integration cycle without waiting for a new one
+*/
+/**************************************************************************/
+void Adafruit_TCS34725::readRawData (uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c)
+{
+  uint8_t buf[8];
+
+  if (!_tcs34725Initialised) begin();
+
+  /* CDATAL through BDATAH are contiguous, so read them all in one burst */
+  if (readFromRegAddr(TCS34725_ADDRESS, TCS34725_COMMAND_BIT | TCS34725_AUTOINC_BIT | TCS34725_CDATAL,
+                      buf, sizeof(buf), BIG_ENDIAN) != 0) {
+    return;
+  }
+
+  *c = buf[0] | ((uint16_t) buf[1] << 8);
+  *r = buf[2] | ((uint16_t) buf[3] << 8);
+  *g = buf[4] | ((uint16_t) buf[5] << 8);
+  *b = buf[6] | ((uint16_t) buf[7] << 8);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of ms an integration cycle takes at the
+            current integration time
+*/
+/**************************************************************************/
+uint16_t Adafruit_TCS34725::integrationDelay(void)
+{
   switch (_tcs34725IntegrationTime)
   {
     case TCS34725_INTEGRATIONTIME_2_4MS:
-      delay(3);
-      break;
+      return 3;
     case TCS34725_INTEGRATIONTIME_24MS:
-      delay(24);
-      break;
+      return 24;
     case TCS34725_INTEGRATIONTIME_50MS:
-      delay(50);
-      break;
+      return 50;
     case TCS34725_INTEGRATIONTIME_101MS:
-      delay(101);
-      break;
+      return 101;
     case TCS34725_INTEGRATIONTIME_154MS:
-      delay(154);
-      break;
+      return 154;
     case TCS34725_INTEGRATIONTIME_700MS:
-      delay(700);
-      break;
+      return 700;
   }
+
+  return 0;
 }
 
 /**************************************************************************/
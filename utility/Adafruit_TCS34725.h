@@ -47,6 +47,7 @@
 #define TCS34725_ADDRESS          (0x29)
 
 #define TCS34725_COMMAND_BIT      (0x80)
+#define TCS34725_AUTOINC_BIT      (0x20)    /* Auto-increment protocol for multi-byte reads */
 
 #define TCS34725_ENABLE           (0x00)
 #define TCS34725_ENABLE_AIEN      (0x10)    /* RGBC Interrupt Enable */
@@ -122,7 +123,18 @@ class Adafruit_TCS34725 {
   boolean  begin(void);
   void     setIntegrationTime(tcs34725IntegrationTime_t it);
   void     setGain(tcs34725Gain_t gain);
+  void     setRange(tcs34725IntegrationTime_t it, tcs34725Gain_t gain);
+  void     enableAutoRange(boolean enable);
+  void     getLastRange(tcs34725IntegrationTime_t *it, tcs34725Gain_t *gain);
+  float    lastRangeScale(void);
   void     getRawData(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c);
+  void     readRawData(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c);
+  uint16_t integrationDelay(void);
+  boolean  dataReady(void);
+  void     setContinuous(boolean continuous);
+  boolean  isContinuous(void) { return _tcs34725Continuous; }
+  void     startIntegration(void);
+  void     finishIntegration(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c);
   uint16_t calculateColorTemperature(uint16_t r, uint16_t g, uint16_t b);
   uint16_t calculateLux(uint16_t r, uint16_t g, uint16_t b);
   void setInterrupt(boolean flag);
@@ -132,10 +144,18 @@ class Adafruit_TCS34725 {
 
  private:
   boolean _tcs34725Initialised;
+  boolean _tcs34725Continuous;
   tcs34725Gain_t _tcs34725Gain;
   tcs34725IntegrationTime_t _tcs34725IntegrationTime; 
+  boolean _tcs34725AutoRange;
+  tcs34725Gain_t _tcs34725ConfigGain;
+  tcs34725IntegrationTime_t _tcs34725ConfigIntegrationTime;
+  tcs34725Gain_t _tcs34725LastGain;
+  tcs34725IntegrationTime_t _tcs34725LastIntegrationTime;
   
   void     disable(void);
+  void     restart(void);
+  void     autoRange(uint16_t c);
 };
 
 #endif
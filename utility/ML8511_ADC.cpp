@@ -26,7 +26,7 @@ bool ML8511_ADC::init()
 {
   uint8_t buf = 0x00;
 
-  Wire.begin();
+  ArdusatBus.begin();
 
   buf = ADC121_CONFIG_CYCLE_32 & ADC121_CONFIG_CYCLE_MASK;
   write8(ADC121_CONFIG_REG, &buf);
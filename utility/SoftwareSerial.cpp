@@ -161,6 +161,17 @@ SoftwareSerial *SoftwareSerial::active_object = 0;
 char SoftwareSerial::_receive_buffer[_SS_MAX_RX_BUFF]; 
 volatile uint8_t SoftwareSerial::_receive_buffer_tail = 0;
 volatile uint8_t SoftwareSerial::_receive_buffer_head = 0;
+volatile uint16_t SoftwareSerial::_receive_dropped = 0;
+volatile uint8_t SoftwareSerial::_receive_peak = 0;
+#if _SS_ASYNC_TX
+char SoftwareSerial::_transmit_buffer[_SS_MAX_TX_BUFF];
+volatile uint8_t SoftwareSerial::_transmit_buffer_tail = 0;
+volatile uint8_t SoftwareSerial::_transmit_buffer_head = 0;
+volatile uint8_t SoftwareSerial::_transmit_state = 0;
+volatile uint8_t SoftwareSerial::_transmit_byte = 0;
+volatile uint8_t SoftwareSerial::_transmit_current = 0;
+SoftwareSerial * volatile SoftwareSerial::transmit_object = 0;
+#endif
 
 //
 // Debugging
@@ -245,6 +256,11 @@ void SoftwareSerial::recv()
   // so interrupt is probably not for us
   if (_inverse_logic ? rx_pin_read() : !rx_pin_read())
   {
+#if _SS_ASYNC_TX
+    if (transmit_object)
+      transmit_object->pauseTX();
+#endif
+
     // Wait approximately 1/2 of a bit width to "center" the sample
     tunedDelay(_rx_delay_centering);
     DebugPulse(_DEBUG_PIN2, 1);
@@ -265,15 +281,25 @@ void SoftwareSerial::recv()
     tunedDelay(_rx_delay_stopbit);
     DebugPulse(_DEBUG_PIN2, 1);
 
+#if _SS_ASYNC_TX
+    if (transmit_object)
+      transmit_object->resumeTX();
+#endif
+
     if (_inverse_logic)
       d = ~d;
 
     // if buffer full, set the overflow flag and return
-    if ((_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF != _receive_buffer_head) 
+    uint8_t next = (_receive_buffer_tail + 1) & _SS_RX_BUFF_MASK;
+    if (next != _receive_buffer_head) 
     {
       // save new data in buffer: tail points to where byte goes
       _receive_buffer[_receive_buffer_tail] = d; // save new byte
-      _receive_buffer_tail = (_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF;
+      _receive_buffer_tail = next;
+
+      uint8_t level = (next - _receive_buffer_head) & _SS_RX_BUFF_MASK;
+      if (level > _receive_peak)
+        _receive_peak = level;
     } 
     else 
     {
@@ -281,6 +307,8 @@ void SoftwareSerial::recv()
       DebugPulse(_DEBUG_PIN1, 1);
 #endif
       _buffer_overflow = true;
+      if (_receive_dropped != 0xFFFF)
+        _receive_dropped++;
     }
   }
 
@@ -326,6 +354,139 @@ inline void SoftwareSerial::handle_interrupt()
   }
 }
 
+#if _SS_ASYNC_TX
+//
+// Background transmit
+//
+// Timer2 runs in CTC mode with one compare match per bit. Each interrupt puts
+// the next bit of the current byte on the pin: the start bit, 8 data bits, then
+// the stop bit. The interrupt is disabled once the buffer is empty.
+//
+// Receiving a byte keeps interrupts off for the whole byte, which would stretch
+// whatever transmit bit is on the pin. So recv() pauses transmitting as soon as
+// it sees a start bit, and no new byte is started while the receive pin is in a
+// start bit.
+//
+
+/* static */
+inline void SoftwareSerial::handle_tx_interrupt()
+{
+  if (transmit_object)
+  {
+    transmit_object->transmit();
+  }
+}
+
+ISR(TIMER2_COMPA_vect)
+{
+  SoftwareSerial::handle_tx_interrupt();
+}
+
+void SoftwareSerial::transmit()
+{
+  if (_transmit_state == 0 || _transmit_state == _SS_TX_RESTART)
+  {
+    // Idle: start the next byte, or stop the timer once everything is sent
+    if (_transmit_state == 0 && _transmit_buffer_head == _transmit_buffer_tail)
+    {
+      TIMSK2 &= ~_BV(OCIE2A);
+      return;
+    }
+
+    // Wait for a byte being received to finish first
+    if (active_object &&
+        (active_object->_inverse_logic ? active_object->rx_pin_read() : !active_object->rx_pin_read()))
+      return;
+
+    if (_transmit_state == 0)
+    {
+      _transmit_current = _transmit_buffer[_transmit_buffer_head];
+      _transmit_buffer_head = (_transmit_buffer_head + 1) & _SS_TX_BUFF_MASK;
+    }
+    _transmit_byte = _transmit_current;
+    tx_pin_write(_inverse_logic ? HIGH : LOW); // start bit
+    _transmit_state = 1;
+  }
+  else if (_transmit_state <= 8)
+  {
+    // Data bits, least significant first
+    if (_transmit_byte & 0x01)
+      tx_pin_write(_inverse_logic ? LOW : HIGH); // send 1
+    else
+      tx_pin_write(_inverse_logic ? HIGH : LOW); // send 0
+    _transmit_byte >>= 1;
+    _transmit_state++;
+  }
+  else
+  {
+    tx_pin_write(_inverse_logic ? LOW : HIGH); // stop bit
+    _transmit_state = 0;
+  }
+}
+
+// Called by recv() when a start bit comes in. A byte that's partly sent is cut
+// off with the pin back at idle, and sent again in full after the received
+// byte. The far end gets the cut off part as a corrupt byte, which is why
+// background transmit is only safe half duplex.
+void SoftwareSerial::pauseTX()
+{
+  if (_transmit_state != 0 && _transmit_state != _SS_TX_RESTART)
+  {
+    tx_pin_write(_inverse_logic ? LOW : HIGH);
+    _transmit_state = _SS_TX_RESTART;
+  }
+}
+
+// Called by recv() once the byte is in, so the next transmit bit gets a full
+// bit time rather than whatever was left of one when recv() started
+void SoftwareSerial::resumeTX()
+{
+  if (TIMSK2 & _BV(OCIE2A))
+  {
+    TCNT2 = 0;
+    TIFR2 = _BV(OCF2A);
+  }
+}
+
+// Picks the smallest Timer2 prescaler for which one bit time fits in 8 bits
+void SoftwareSerial::setTXTimer(long speed)
+{
+  static const uint8_t prescaler_bits[] = { 0, 3, 5, 6, 7, 8, 10 }; // 1, 8, 32, ..., 1024
+  unsigned long ticks = 0;
+
+  _tx_timer_prescaler = 0;
+  for (uint8_t i = 0; i < sizeof(prescaler_bits); ++i)
+  {
+    ticks = ((F_CPU >> prescaler_bits[i]) + speed / 2) / speed;
+    if (ticks <= 256)
+    {
+      _tx_timer_prescaler = i + 1; // CS22:0 value
+      break;
+    }
+  }
+
+  _tx_timer_compare = ticks - 1;
+}
+
+void SoftwareSerial::startTXTimer()
+{
+  TIMSK2 &= ~_BV(OCIE2A);
+  TCCR2A = _BV(WGM21); // CTC, TOP = OCR2A
+  TCCR2B = _tx_timer_prescaler;
+  OCR2A = _tx_timer_compare;
+  TCNT2 = 0;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 |= _BV(OCIE2A);
+}
+
+// Waits until the transmit buffer is empty and the last stop bit is out
+void SoftwareSerial::waitTX()
+{
+  while (transmit_object == this && (TIMSK2 & _BV(OCIE2A)))
+    ;
+}
+#endif
+
 #if defined(PCINT0_vect)
 ISR(PCINT0_vect)
 {
@@ -364,6 +525,11 @@ SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inv
   _tx_delay(0),
   _buffer_overflow(false),
   _inverse_logic(inverse_logic)
+#if _SS_ASYNC_TX
+  ,
+  _tx_timer_prescaler(0),
+  _tx_timer_compare(0)
+#endif
 {
   setTX(transmitPin);
   setRX(receivePin);
@@ -403,6 +569,9 @@ void SoftwareSerial::setRX(uint8_t rx)
 
 void SoftwareSerial::begin(long speed)
 {
+#if _SS_ASYNC_TX
+  waitTX();
+#endif
   _rx_delay_centering = _rx_delay_intrabit = _rx_delay_stopbit = _tx_delay = 0;
 
   for (unsigned i=0; i<sizeof(table)/sizeof(table[0]); ++i)
@@ -418,6 +587,11 @@ void SoftwareSerial::begin(long speed)
     }
   }
 
+#if _SS_ASYNC_TX
+  if (_tx_delay)
+    setTXTimer(speed);
+#endif
+
   // Set up RX interrupts, but only if we have a valid RX baud rate
   if (_rx_delay_stopbit)
   {
@@ -439,6 +613,9 @@ void SoftwareSerial::begin(long speed)
 
 void SoftwareSerial::end()
 {
+#if _SS_ASYNC_TX
+  waitTX();
+#endif
   if (digitalPinToPCMSK(_receivePin))
     *digitalPinToPCMSK(_receivePin) &= ~_BV(digitalPinToPCMSKbit(_receivePin));
 }
@@ -456,7 +633,7 @@ int SoftwareSerial::read()
 
   // Read from "head"
   uint8_t d = _receive_buffer[_receive_buffer_head]; // grab next byte
-  _receive_buffer_head = (_receive_buffer_head + 1) % _SS_MAX_RX_BUFF;
+  _receive_buffer_head = (_receive_buffer_head + 1) & _SS_RX_BUFF_MASK;
   return d;
 }
 
@@ -465,7 +642,34 @@ int SoftwareSerial::available()
   if (!isListening())
     return 0;
 
-  return (_receive_buffer_tail + _SS_MAX_RX_BUFF - _receive_buffer_head) % _SS_MAX_RX_BUFF;
+  return (_receive_buffer_tail - _receive_buffer_head) & _SS_RX_BUFF_MASK;
+}
+
+// Number of received bytes dropped because the RX buffer was full (saturates
+// at 65535), since the last resetRXStats()
+uint16_t SoftwareSerial::droppedBytes()
+{
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t dropped = _receive_dropped;
+  SREG = oldSREG;
+  return dropped;
+}
+
+// Most bytes that have been waiting in the RX buffer at once, since the last
+// resetRXStats(). Close to _SS_MAX_RX_BUFF - 1 means the buffer is too small.
+uint8_t SoftwareSerial::peakAvailable()
+{
+  return _receive_peak;
+}
+
+void SoftwareSerial::resetRXStats()
+{
+  uint8_t oldSREG = SREG;
+  cli();
+  _receive_dropped = 0;
+  _receive_peak = 0;
+  SREG = oldSREG;
 }
 
 size_t SoftwareSerial::write(uint8_t b)
@@ -475,6 +679,29 @@ size_t SoftwareSerial::write(uint8_t b)
     return 0;
   }
 
+#if _SS_ASYNC_TX
+  // Only one port can use the timer at a time, let the other one finish first
+  if (transmit_object != this)
+  {
+    if (transmit_object)
+      transmit_object->waitTX();
+    transmit_object = this;
+  }
+
+  // Wait for room in the buffer, like HardwareSerial does
+  uint8_t next = (_transmit_buffer_tail + 1) & _SS_TX_BUFF_MASK;
+  while (next == _transmit_buffer_head)
+    ;
+
+  _transmit_buffer[_transmit_buffer_tail] = b;
+  _transmit_buffer_tail = next;
+
+  if (!(TIMSK2 & _BV(OCIE2A)))
+    startTXTimer();
+
+  return 1;
+#else
+
   uint8_t oldSREG = SREG;
   cli();  // turn off interrupts for a clean txmit
 
@@ -516,6 +743,21 @@ size_t SoftwareSerial::write(uint8_t b)
   tunedDelay(_tx_delay);
   
   return 1;
+#endif
+}
+
+int SoftwareSerial::availableForWrite()
+{
+#if _SS_ASYNC_TX
+  if (transmit_object != this && transmit_object && (TIMSK2 & _BV(OCIE2A)))
+    return 0;
+
+  return _SS_MAX_TX_BUFF - 1 -
+    ((_transmit_buffer_tail - _transmit_buffer_head) & _SS_TX_BUFF_MASK);
+#else
+  // Every byte is sent right away, blocking until it's done
+  return 0;
+#endif
 }
 
 void SoftwareSerial::flush()
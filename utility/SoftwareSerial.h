@@ -33,13 +33,44 @@ http://arduiniana.org.
 #define SoftwareSerial_h
 
 #include <inttypes.h>
+#include <avr/io.h>
 #include <Stream.h>
 
 /******************************************************************************
 * Definitions
 ******************************************************************************/
 
+// Buffer sizes can be overridden with build flags or by editing the defaults
+// here. They must be powers of two no larger than 256, so that wrapping the
+// buffer indexes is a mask instead of a division in the interrupt handlers.
+#ifndef _SS_MAX_RX_BUFF
 #define _SS_MAX_RX_BUFF 64 // RX buffer size
+#endif
+#if _SS_MAX_RX_BUFF > 256 || (_SS_MAX_RX_BUFF & (_SS_MAX_RX_BUFF - 1))
+#error _SS_MAX_RX_BUFF must be a power of two no larger than 256
+#endif
+#define _SS_RX_BUFF_MASK (_SS_MAX_RX_BUFF - 1)
+
+// Set _SS_ASYNC_TX to 1 to transmit from a buffer in the background, one bit per
+// Timer2 compare interrupt, instead of blocking (with interrupts off) for every
+// byte. Timer2 is then no longer available for tone() or PWM on pins 3 and 11.
+// It's half duplex only: a byte being sent when one comes in is cut short and
+// sent again, so the far end gets a corrupt byte first.
+#ifndef _SS_ASYNC_TX
+#define _SS_ASYNC_TX 0
+#endif
+#if _SS_ASYNC_TX && !defined(TIMER2_COMPA_vect)
+#undef _SS_ASYNC_TX
+#define _SS_ASYNC_TX 0
+#endif
+#ifndef _SS_MAX_TX_BUFF
+#define _SS_MAX_TX_BUFF 64 // TX buffer size, only used with _SS_ASYNC_TX
+#endif
+#if _SS_MAX_TX_BUFF > 256 || (_SS_MAX_TX_BUFF & (_SS_MAX_TX_BUFF - 1))
+#error _SS_MAX_TX_BUFF must be a power of two no larger than 256
+#endif
+#define _SS_TX_BUFF_MASK (_SS_MAX_TX_BUFF - 1)
+#define _SS_TX_RESTART 0xFF // _transmit_state of a byte cut off by recv(), sent again
 #ifndef GCC_VERSION
 #define GCC_VERSION (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__)
 #endif
@@ -66,8 +97,30 @@ private:
   static char _receive_buffer[_SS_MAX_RX_BUFF]; 
   static volatile uint8_t _receive_buffer_tail;
   static volatile uint8_t _receive_buffer_head;
+  static volatile uint16_t _receive_dropped;
+  static volatile uint8_t _receive_peak;
   static SoftwareSerial *active_object;
 
+#if _SS_ASYNC_TX
+  uint8_t _tx_timer_prescaler;
+  uint8_t _tx_timer_compare;
+
+  static char _transmit_buffer[_SS_MAX_TX_BUFF];
+  static volatile uint8_t _transmit_buffer_tail;
+  static volatile uint8_t _transmit_buffer_head;
+  static volatile uint8_t _transmit_state;
+  static volatile uint8_t _transmit_byte;
+  static volatile uint8_t _transmit_current;
+  static SoftwareSerial * volatile transmit_object;
+
+  void setTXTimer(long speed);
+  void startTXTimer();
+  void waitTX();
+  void transmit();
+  void pauseTX();
+  void resumeTX();
+#endif
+
   // private methods
   void recv();
   uint8_t rx_pin_read();
@@ -87,9 +140,13 @@ public:
   void end();
   bool isListening() { return this == active_object; }
   bool overflow() { bool ret = _buffer_overflow; _buffer_overflow = false; return ret; }
+  uint16_t droppedBytes();
+  uint8_t peakAvailable();
+  void resetRXStats();
   int peek();
 
   virtual size_t write(uint8_t byte);
+  virtual int availableForWrite();
   virtual int read();
   virtual int available();
   virtual void flush();
@@ -98,6 +155,9 @@ public:
 
   // public only for easy access by interrupt handlers
   static inline void handle_interrupt();
+#if _SS_ASYNC_TX
+  static inline void handle_tx_interrupt();
+#endif
 };
 
 // Arduino 0012 workaround
@@ -48,7 +48,7 @@ bool SFE_ISL29125::init()
   uint8_t data = 0x00;
   
   // Start I2C
-  Wire.begin();
+  ArdusatBus.begin();
   
   // Check device ID
   read8(DEVICE_ID, &data);
@@ -177,6 +177,23 @@ uint16_t SFE_ISL29125::readBlue()
   return buf;
 }
 
+// Read the latest Sensor ADC readings for all three colors in one burst. The
+// data registers are contiguous: GREEN_L, GREEN_H, RED_L, RED_H, BLUE_L, BLUE_H
+bool SFE_ISL29125::readRGB(uint16_t *red, uint16_t *green, uint16_t *blue)
+{
+  uint8_t buf[6];
+
+  if (readFromRegAddr(_addr, GREEN_L, buf, sizeof(buf), BIG_ENDIAN) != 0)
+  {
+    return false;
+  }
+
+  *green = buf[0] | ((uint16_t) buf[1] << 8);
+  *red = buf[2] | ((uint16_t) buf[3] << 8);
+  *blue = buf[4] | ((uint16_t) buf[5] << 8);
+  return true;
+}
+
 // Check status flag register that allows for checking for interrupts, brownouts, and ADC conversion completions
 uint8_t SFE_ISL29125::readStatus()
 {
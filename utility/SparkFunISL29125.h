@@ -124,6 +124,7 @@ class SFE_ISL29125
   uint16_t readRed();
   uint16_t readGreen();
   uint16_t readBlue();
+  bool readRGB(uint16_t *red, uint16_t *green, uint16_t *blue);
   
   uint8_t readStatus();
   
@@ -48,6 +48,20 @@
 #define TSL2561_DELAY_INTTIME_101MS   (120)
 #define TSL2561_DELAY_INTTIME_402MS   (450)
 
+/* Ranges auto-ranging chooses from, most sensitive first. Relative to
+   402ms at 1x they are 16, 4, 1, 0.55, 0.25 and 0.034 times as sensitive, so
+   the steps are about 1/4, 1/4, 1/2, 1/2 and 1/7; these are all the ranges
+   the sensor has. */
+static const uint8_t _tsl2561Ranges[][2] PROGMEM = {
+  { TSL2561_INTEGRATIONTIME_402MS, TSL2561_GAIN_16X },
+  { TSL2561_INTEGRATIONTIME_101MS, TSL2561_GAIN_16X },
+  { TSL2561_INTEGRATIONTIME_402MS, TSL2561_GAIN_1X },
+  { TSL2561_INTEGRATIONTIME_13MS,  TSL2561_GAIN_16X },
+  { TSL2561_INTEGRATIONTIME_101MS, TSL2561_GAIN_1X },
+  { TSL2561_INTEGRATIONTIME_13MS,  TSL2561_GAIN_1X },
+};
+#define TSL2561_NUM_RANGES (sizeof(_tsl2561Ranges) / sizeof(_tsl2561Ranges[0]))
+
 #define read8(reg, val) readFromRegAddr(_addr, reg, val, 1, BIG_ENDIAN)
 #define read16(reg, val) readFromRegAddr(_addr, reg, val, 2, BIG_ENDIAN)
 #define write8(reg, val) writeToRegAddr(_addr, reg, val, 1, BIG_ENDIAN)
@@ -62,8 +76,13 @@ TSL2561::TSL2561(uint8_t addr)
   _addr = addr;
   _tsl2561Initialised = false;
   _tsl2561AutoGain = false;
+  _tsl2561Continuous = false;
+  _tsl2561IntegrationStart = 0;
   _tsl2561IntegrationTime = TSL2561_INTEGRATIONTIME_13MS;
   _tsl2561Gain = TSL2561_GAIN_1X;
+  _tsl2561MaxIntegrationTime = TSL2561_INTEGRATIONTIME_13MS;
+  _tsl2561LastIntegrationTime = TSL2561_INTEGRATIONTIME_13MS;
+  _tsl2561LastGain = TSL2561_GAIN_1X;
 
   // we cant do wire initialization till later, because we havent loaded Wire yet
 }
@@ -76,7 +95,7 @@ TSL2561::TSL2561(uint8_t addr)
 /**************************************************************************/
 boolean TSL2561::begin(void)
 {
-  Wire.begin();
+  ArdusatBus.begin();
 
   /* Make sure we're actually connected */
   uint8_t x = 0;
@@ -92,7 +111,10 @@ boolean TSL2561::begin(void)
   setGain(_tsl2561Gain);
 
   /* Note: by default, the device is in power down mode on bootup */
-  disable();
+  if (!_tsl2561Continuous)
+  {
+    disable();
+  }
 
   return true;
 }
@@ -107,6 +129,9 @@ void TSL2561::enable(void)
   /* Enable the device by setting the control bit to 0x03 */
   uint8_t buf = TSL2561_CONTROL_POWERON;
   write8(TSL2561_COMMAND_BIT | TSL2561_REGISTER_CONTROL, &buf);
+
+  /* A new integration cycle starts now */
+  _tsl2561IntegrationStart = millis();
 }
 
 /**************************************************************************/
@@ -129,30 +154,258 @@ void TSL2561::disable(void)
 void TSL2561::getData (uint16_t *broadband, uint16_t *ir)
 {
   /* Enable the device by setting the control bit to 0x03 */
-  enable();
+  startIntegration();
+
+  /* Wait x ms for ADC to complete (no time at all if a continuous
+     integration has already completed) */
+  delay(readyIn());
+
+  /* Reads both channels and turns the device off to save power */
+  finishIntegration(broadband, ir);
+}
+
+/**************************************************************************/
+/*!
+    Powers up the device so that it starts a new integration cycle. Pair
+    with finishIntegration() once readyIn() ms have passed. Does nothing
+    in continuous mode, where the device is already integrating.
+*/
+/**************************************************************************/
+void TSL2561::startIntegration(void)
+{
+  if (!_tsl2561Initialised) begin();
 
-  /* Wait x ms for ADC to complete */
+  if (!_tsl2561Continuous)
+  {
+    enable();
+  }
+}
+
+/**************************************************************************/
+/*!
+    Returns the number of ms an integration cycle takes to complete at the
+    current integration time
+*/
+/**************************************************************************/
+uint16_t TSL2561::integrationDelay(void)
+{
   switch (_tsl2561IntegrationTime)
   {
     case TSL2561_INTEGRATIONTIME_13MS:
-      delay(TSL2561_DELAY_INTTIME_13MS);  // KTOWN: Was 14ms
+      return TSL2561_DELAY_INTTIME_13MS;  // KTOWN: Was 14ms
+    case TSL2561_INTEGRATIONTIME_101MS:
+      return TSL2561_DELAY_INTTIME_101MS; // KTOWN: Was 102ms
+    default:
+      return TSL2561_DELAY_INTTIME_402MS; // KTOWN: Was 403ms
+  }
+}
+
+/**************************************************************************/
+/*!
+    Returns the number of ms until finishIntegration() has a complete
+    integration cycle to read. In continuous mode this is 0 except in the
+    first cycle after powering up or changing the gain or integration time.
+*/
+/**************************************************************************/
+uint16_t TSL2561::readyIn(void)
+{
+  uint16_t wait = integrationDelay();
+
+  if (_tsl2561Continuous)
+  {
+    unsigned long elapsed = millis() - _tsl2561IntegrationStart;
+    return elapsed >= wait ? 0 : wait - elapsed;
+  }
+
+  return wait;
+}
+
+/**************************************************************************/
+/*!
+    Reads both channels of an integration started with startIntegration()
+    and powers the device back down. In continuous mode the device is left
+    running, and the channels hold the last completed integration.
+*/
+/**************************************************************************/
+void TSL2561::finishIntegration(uint16_t *broadband, uint16_t *ir)
+{
+  uint8_t powerOff = TSL2561_CONTROL_POWEROFF;
+
+  /* Reads a two byte value from channel 0 (visible + infrared) and channel 1
+     (infrared), then turns the device off to save power, in one batch */
+  reg_op_t ops[] = {
+    REG_READ(TSL2561_COMMAND_BIT | TSL2561_WORD_BIT | TSL2561_REGISTER_CHAN0_LOW, broadband, 2),
+    REG_READ(TSL2561_COMMAND_BIT | TSL2561_WORD_BIT | TSL2561_REGISTER_CHAN1_LOW, ir, 2),
+    REG_WRITE(TSL2561_COMMAND_BIT | TSL2561_REGISTER_CONTROL, &powerOff, 1),
+  };
+  uint8_t count = sizeof(ops) / sizeof(ops[0]);
+  if (_tsl2561Continuous)
+  {
+    count--;
+  }
+  if (runRegOps(_addr, ops, count) != 0 && !_tsl2561Continuous)
+  {
+    disable();
+  }
+}
+
+/**************************************************************************/
+/*!
+    Reads an integration started with startIntegration() and converts it
+    to lux at the range it was taken at. With auto-range enabled, the
+    reading then picks the range for the next integration, so no
+    integration is ever thrown away.
+*/
+/**************************************************************************/
+uint32_t TSL2561::finishLux(void)
+{
+  uint16_t broadband = 0, ir = 0;
+  uint32_t lux;
+
+  finishIntegration(&broadband, &ir);
+  lux = calculateLux(broadband, ir);
+
+  _tsl2561LastIntegrationTime = _tsl2561IntegrationTime;
+  _tsl2561LastGain = _tsl2561Gain;
+
+  if (_tsl2561AutoGain)
+  {
+    autoRange(broadband, ir);
+  }
+
+  return lux;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the lux in one integration, then adjusts the range for
+            the next reading if auto-range is enabled
+*/
+/**************************************************************************/
+uint32_t TSL2561::getLux(void)
+{
+  startIntegration();
+  delay(readyIn());
+  return finishLux();
+}
+
+/**************************************************************************/
+/*!
+    Returns the integration time and gain that the last finishLux() or
+    getLux() reading was taken at
+*/
+/**************************************************************************/
+void TSL2561::getLastRange(tsl2561IntegrationTime_t *time, tsl2561Gain_t *gain)
+{
+  *time = _tsl2561LastIntegrationTime;
+  *gain = _tsl2561LastGain;
+}
+
+/**************************************************************************/
+/*!
+    Private function returning how sensitive a range is, in counts per
+    count at 402ms and 1x
+*/
+/**************************************************************************/
+static float _tsl2561Sensitivity(uint8_t time, uint8_t gain)
+{
+  float sensitivity;
+
+  switch (time)
+  {
+    case TSL2561_INTEGRATIONTIME_13MS:
+      sensitivity = (float) (1 << TSL2561_LUX_CHSCALE) / TSL2561_LUX_CHSCALE_TINT0;
       break;
     case TSL2561_INTEGRATIONTIME_101MS:
-      delay(TSL2561_DELAY_INTTIME_101MS); // KTOWN: Was 102ms
+      sensitivity = (float) (1 << TSL2561_LUX_CHSCALE) / TSL2561_LUX_CHSCALE_TINT1;
       break;
     default:
-      delay(TSL2561_DELAY_INTTIME_402MS); // KTOWN: Was 403ms
+      sensitivity = 1.0;
       break;
   }
 
-  /* Reads a two byte value from channel 0 (visible + infrared) */
-  read16(TSL2561_COMMAND_BIT | TSL2561_WORD_BIT | TSL2561_REGISTER_CHAN0_LOW, broadband);
+  return gain == TSL2561_GAIN_16X ? sensitivity * 16 : sensitivity;
+}
 
-  /* Reads a two byte value from channel 1 (infrared) */
-  read16(TSL2561_COMMAND_BIT | TSL2561_WORD_BIT | TSL2561_REGISTER_CHAN1_LOW, ir);
+/**************************************************************************/
+/*!
+    Private function that predicts the counts the last reading would have
+    given at each range, and switches to the most sensitive one that stays
+    under its auto-gain high threshold. Integration times longer than the
+    one set with setIntegrationTime() aren't used. A saturated reading
+    can't be predicted from, so it drops straight to the least sensitive
+    range.
+*/
+/**************************************************************************/
+void TSL2561::autoRange(uint16_t broadband, uint16_t ir)
+{
+  uint8_t time = TSL2561_INTEGRATIONTIME_13MS;
+  uint8_t gain = TSL2561_GAIN_1X;
 
-  /* Turn the device off to save power */
-  disable();
+  if (!IsSensorSaturated(broadband, ir))
+  {
+    float counts = broadband / _tsl2561Sensitivity(_tsl2561IntegrationTime, _tsl2561Gain);
+
+    for (uint8_t i = 0; i < TSL2561_NUM_RANGES; ++i)
+    {
+      uint8_t t = pgm_read_byte(&_tsl2561Ranges[i][0]);
+      uint8_t g = pgm_read_byte(&_tsl2561Ranges[i][1]);
+      uint16_t hi;
+
+      if (t > _tsl2561MaxIntegrationTime)
+      {
+        continue;
+      }
+
+      switch (t)
+      {
+        case TSL2561_INTEGRATIONTIME_13MS:
+          hi = TSL2561_AGC_THI_13MS;
+          break;
+        case TSL2561_INTEGRATIONTIME_101MS:
+          hi = TSL2561_AGC_THI_101MS;
+          break;
+        default:
+          hi = TSL2561_AGC_THI_402MS;
+          break;
+      }
+
+      if (counts * _tsl2561Sensitivity(t, g) <= hi)
+      {
+        time = t;
+        gain = g;
+        break;
+      }
+    }
+  }
+
+  if (time != _tsl2561IntegrationTime || gain != _tsl2561Gain)
+  {
+    setRange((tsl2561IntegrationTime_t) time, (tsl2561Gain_t) gain);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Keeps the device powered and integrating, so readings return
+            the last completed integration without waiting, or goes back
+            to powering it up for each reading (the default)
+*/
+/**************************************************************************/
+void TSL2561::setContinuous(boolean continuous)
+{
+  if (!_tsl2561Initialised) begin();
+
+  _tsl2561Continuous = continuous;
+
+  if (continuous)
+  {
+    enable();
+  }
+  else
+  {
+    disable();
+  }
 }
 
 /**************************************************************************/
@@ -174,29 +427,30 @@ void TSL2561::enableAutoRange(bool enable)
 
 void TSL2561::setGain(tsl2561Gain_t gain)
 {
-  if (!_tsl2561Initialised) begin();
-
-  /* Enable the device by setting the control bit to 0x03 */
-  enable();
-
-  /* Update the timing register */
-  uint8_t buf = _tsl2561IntegrationTime | gain;
-  write8(TSL2561_COMMAND_BIT | TSL2561_REGISTER_TIMING, &buf);
+  setRange(_tsl2561IntegrationTime, gain);
+}
 
-  /* Update value placeholders */
-  _tsl2561Gain = gain;
+/**************************************************************************/
+/*!
+    Sets the integration time for the TSL2561. With auto-range enabled,
+    this is the longest integration time it will use.
+*/
+/**************************************************************************/
 
-  /* Turn the device off to save power */
-  disable();
+void TSL2561::setIntegrationTime(tsl2561IntegrationTime_t time)
+{
+  _tsl2561MaxIntegrationTime = time;
+  setRange(time, _tsl2561Gain);
 }
 
 /**************************************************************************/
 /*!
-    Sets the integration time for the TSL2561
+    Sets the integration time and gain together, in one write of the
+    timing register
 */
 /**************************************************************************/
 
-void TSL2561::setIntegrationTime(tsl2561IntegrationTime_t time)
+void TSL2561::setRange(tsl2561IntegrationTime_t time, tsl2561Gain_t gain)
 {
   if (!_tsl2561Initialised) begin();
 
@@ -204,102 +458,39 @@ void TSL2561::setIntegrationTime(tsl2561IntegrationTime_t time)
   enable();
 
   /* Update the timing register */
-  uint8_t buf = time | _tsl2561Gain;
+  uint8_t buf = time | gain;
   write8(TSL2561_COMMAND_BIT | TSL2561_REGISTER_TIMING, &buf);
 
   /* Update value placeholders */
   _tsl2561IntegrationTime = time;
+  _tsl2561Gain = gain;
 
   /* Turn the device off to save power */
-  disable();
+  if (_tsl2561Continuous)
+  {
+    /* Power cycle so that the integration in progress, at the old range,
+       is thrown away and the next one starts now */
+    disable();
+    enable();
+  }
+  else
+  {
+    disable();
+  }
 }
 
 /**************************************************************************/
 /*!
     @brief  Gets the broadband (mixed lighting) and IR only values from
-            the TSL2561, adjusting gain if auto-gain is enabled
+            the TSL2561 in a single integration, at the current range.
+            Use getLux() to have auto-range follow the light.
 */
 /**************************************************************************/
 void TSL2561::getLuminosity (uint16_t *broadband, uint16_t *ir)
 {
-  bool valid = false;
-
   if (!_tsl2561Initialised) begin();
 
-  /* If Auto gain disabled get a single reading and continue */
-  if(!_tsl2561AutoGain)
-  {
-    getData (broadband, ir);
-    return;
-  }
-
-  /* Read data until we find a valid range */
-  bool _agcCheck = false;
-  do
-  {
-    uint16_t _b, _ir;
-    uint16_t _hi, _lo;
-    tsl2561IntegrationTime_t _it = _tsl2561IntegrationTime;
-
-    /* Get the hi/low threshold for the current integration time */
-    switch(_it)
-    {
-      case TSL2561_INTEGRATIONTIME_13MS:
-        _hi = TSL2561_AGC_THI_13MS;
-        _lo = TSL2561_AGC_TLO_13MS;
-        break;
-      case TSL2561_INTEGRATIONTIME_101MS:
-        _hi = TSL2561_AGC_THI_101MS;
-        _lo = TSL2561_AGC_TLO_101MS;
-        break;
-      default:
-        _hi = TSL2561_AGC_THI_402MS;
-        _lo = TSL2561_AGC_TLO_402MS;
-        break;
-    }
-
-    getData(&_b, &_ir);
-
-    /* Run an auto-gain check if we haven't already done so ... */
-    if (!_agcCheck)
-    {
-      if ((_b < _lo) && (_tsl2561Gain == TSL2561_GAIN_1X))
-      {
-        /* Increase the gain and try again */
-        setGain(TSL2561_GAIN_16X);
-        /* Drop the previous conversion results */
-        getData(&_b, &_ir);
-        /* Set a flag to indicate we've adjusted the gain */
-        _agcCheck = true;
-      }
-      else if ((_b > _hi) && (_tsl2561Gain == TSL2561_GAIN_16X))
-      {
-        /* Drop gain to 1x and try again */
-        setGain(TSL2561_GAIN_1X);
-        /* Drop the previous conversion results */
-        getData(&_b, &_ir);
-        /* Set a flag to indicate we've adjusted the gain */
-        _agcCheck = true;
-      }
-      else
-      {
-        /* Nothing to look at here, keep moving ....
-           Reading is either valid, or we're already at the chips limits */
-        *broadband = _b;
-        *ir = _ir;
-        valid = true;
-      }
-    }
-    else
-    {
-      /* If we've already adjusted the gain once, just return the new results.
-         This avoids endless loops where a value is at one extreme pre-gain,
-         and the the other extreme post-gain */
-      *broadband = _b;
-      *ir = _ir;
-      valid = true;
-    }
-  } while (!valid);
+  getData (broadband, ir);
 }
 
 /**************************************************************************/
@@ -175,28 +175,51 @@ tsl2561Gain_t;
 
 class TSL2561 {
  public:
-  TSL2561(uint8_t addr);
+  TSL2561(uint8_t addr = TSL2561_ADDR_FLOAT);
   boolean begin(void);
+  void setAddress(uint8_t addr) { _addr = addr; _tsl2561Initialised = false; }
 
   /* TSL2561 Functions */
   void enableAutoRange(bool enable);
   void setIntegrationTime(tsl2561IntegrationTime_t time);
   void setGain(tsl2561Gain_t gain);
+  void setRange(tsl2561IntegrationTime_t time, tsl2561Gain_t gain);
+  tsl2561IntegrationTime_t getIntegrationTime(void) { return _tsl2561IntegrationTime; }
+  tsl2561Gain_t getGain(void) { return _tsl2561Gain; }
   void getLuminosity (uint16_t *broadband, uint16_t *ir);
   uint32_t calculateLux(uint16_t broadband, uint16_t ir);
+  uint32_t getLux(void);
   boolean IsSensorSaturated(const uint16_t &broadband, const uint16_t &ir);
 
+  /* Split-phase reads */
+  void startIntegration(void);
+  uint16_t integrationDelay(void);
+  uint16_t readyIn(void);
+  void finishIntegration(uint16_t *broadband, uint16_t *ir);
+  uint32_t finishLux(void);
+  void getLastRange(tsl2561IntegrationTime_t *time, tsl2561Gain_t *gain);
+
+  /* Continuous conversion */
+  void setContinuous(boolean continuous);
+  boolean isContinuous(void) { return _tsl2561Continuous; }
+
  private:
   void enable(void);
   void disable(void);
   void getData (uint16_t *broadband, uint16_t *ir);
+  void autoRange(uint16_t broadband, uint16_t ir);
 
 
  private:
   int8_t _addr;
   boolean _tsl2561Initialised;
   boolean _tsl2561AutoGain;
+  boolean _tsl2561Continuous;
+  unsigned long _tsl2561IntegrationStart;
   tsl2561IntegrationTime_t _tsl2561IntegrationTime;
   tsl2561Gain_t _tsl2561Gain;
+  tsl2561IntegrationTime_t _tsl2561MaxIntegrationTime;
+  tsl2561IntegrationTime_t _tsl2561LastIntegrationTime;
+  tsl2561Gain_t _tsl2561LastGain;
 };
 #endif
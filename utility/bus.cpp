@@ -0,0 +1,409 @@
+/**
+ * @file   bus.cpp
+ * @date   October 14, 2026
+ * @brief  Owns the I2C bus setup and applies per-device clock speeds
+ */
+
+#include <string.h>
+#include <Wire.h>
+#include "bus.h"
+
+ArdusatBusClass ArdusatBus;
+
+ArdusatBusClass::ArdusatBusClass()
+{
+  _begun = false;
+  _scanned = false;
+  _restored = false;
+  _default_clock = BUS_DEFAULT_CLOCK;
+  _current_clock = 0;
+  _num_device_clocks = 0;
+  _timeout = BUS_TIMEOUT_US;
+  _mux_addr = BUS_MUX_ADDR;
+  _channel = BUS_NO_CHANNEL;
+  resetCounts();
+}
+
+/**
+ * Starts Wire and sets the default clock. Only the first call starts Wire;
+ * calling Wire.begin() again would reset the clock to 100 kHz, so drivers should
+ * always go through here.
+ */
+void ArdusatBusClass::begin()
+{
+  if (!_begun) {
+    Wire.begin();
+    _begun = true;
+    _current_clock = 0;
+    _applyTimeout();
+  }
+
+  _apply(_default_clock);
+}
+
+/**
+ * Sets the clock used by every device without an override.
+ *
+ * @param clock I2C clock in Hz (e.g. BUS_CLOCK_STANDARD or BUS_CLOCK_FAST)
+ */
+void ArdusatBusClass::setDefaultClock(uint32_t clock)
+{
+  _default_clock = clock;
+
+  if (_begun) {
+    _apply(_default_clock);
+  }
+}
+
+/**
+ * Sets the clock used for one device's transactions. Only needed for devices
+ * slower than the default clock.
+ *
+ * @param addr I2C Device address
+ * @param clock I2C clock in Hz
+ *
+ * @return true if set, false if there is no room for another override
+ */
+boolean ArdusatBusClass::setDeviceClock(uint8_t addr, uint32_t clock)
+{
+  for (uint8_t i = 0; i < _num_device_clocks; ++i) {
+    if (_device_clocks[i].addr == addr) {
+      _device_clocks[i].clock = clock;
+      return true;
+    }
+  }
+
+  if (_num_device_clocks >= BUS_MAX_DEVICE_CLOCKS) {
+    return false;
+  }
+
+  _device_clocks[_num_device_clocks].addr = addr;
+  _device_clocks[_num_device_clocks].clock = clock;
+  _num_device_clocks++;
+  return true;
+}
+
+/**
+ * @param addr I2C Device address
+ *
+ * @return the clock that transactions with this device run at
+ */
+uint32_t ArdusatBusClass::deviceClock(uint8_t addr)
+{
+  for (uint8_t i = 0; i < _num_device_clocks; ++i) {
+    if (_device_clocks[i].addr == addr) {
+      return _device_clocks[i].clock;
+    }
+  }
+
+  return _default_clock;
+}
+
+/**
+ * Sets the longest a single transaction may take before it's abandoned.
+ *
+ * @param timeout timeout in microseconds, 0 to wait forever
+ */
+void ArdusatBusClass::setTimeout(uint32_t timeout)
+{
+  _timeout = timeout;
+
+  if (_begun) {
+    _applyTimeout();
+  }
+}
+
+/**
+ * Checks every address on the bus once and records which ones answer. A device
+ * that holds the bus up ends the scan early, with only the addresses before it
+ * recorded.
+ *
+ * @return number of devices found
+ */
+uint8_t ArdusatBusClass::scan()
+{
+  uint8_t found = 0;
+  uint8_t status;
+
+  begin();
+  memset(_present, 0, sizeof(_present));
+
+  // 0x00-0x07 and 0x78-0x7F are reserved addresses
+  for (uint8_t addr = 0x08; addr < 0x78; ++addr) {
+    select(addr);
+    Wire.beginTransmission(addr);
+    status = Wire.endTransmission();
+    countTraffic(1);
+
+    if (status == 0) {
+      _present[addr >> 3] |= 1 << (addr & 0x07);
+      found++;
+    } else if (status >= 4) {
+      retry(status, BUS_RETRIES);
+      break;
+    }
+  }
+  release();
+
+  _scanned = true;
+  _restored = false;
+  return found;
+}
+
+/**
+ * Sensor drivers check this before talking to their device, so a sensor that
+ * didn't answer the scan fails to start without being probed. The scan only
+ * covers the main bus, so while a mux channel is selected every address counts
+ * as present.
+ *
+ * A map restored with setPresentMap() may be missing devices added since it
+ * was saved, so an address it doesn't list is checked with one empty write
+ * (and added to the map if it answers).
+ *
+ * @param addr I2C Device address
+ *
+ * @return true if the device answered the last scan or check, or if the bus
+ *         hasn't been scanned yet
+ */
+boolean ArdusatBusClass::present(uint8_t addr)
+{
+  uint8_t bit = 1 << (addr & 0x07);
+  uint8_t & mapped = _present[(addr >> 3) & 0x0F];
+
+  if (!_scanned || _channel != BUS_NO_CHANNEL) {
+    return true;
+  }
+
+  if (!(mapped & bit) && _restored) {
+    select(addr);
+    Wire.beginTransmission(addr);
+    if (Wire.endTransmission() == 0) {
+      mapped |= bit;
+    }
+    countTraffic(1);
+    release();
+  }
+
+  return (mapped & bit) != 0;
+}
+
+/**
+ * Restores the result of an earlier scan (e.g. one saved in EEPROM) instead of
+ * scanning again
+ *
+ * @param map BUS_PRESENT_MAP_SIZE bytes from presentMap()
+ */
+void ArdusatBusClass::setPresentMap(const uint8_t map[BUS_PRESENT_MAP_SIZE])
+{
+  memcpy(_present, map, sizeof(_present));
+  _scanned = true;
+  _restored = true;
+}
+
+/**
+ * Switches to the clock for a device before talking to it. Costs a table lookup
+ * when the clock doesn't change.
+ *
+ * @param addr I2C Device address
+ */
+void ArdusatBusClass::select(uint8_t addr)
+{
+  if (_num_device_clocks > 0) {
+    _apply(deviceClock(addr));
+  }
+}
+
+/**
+ * Goes back to the default clock after a transaction, so drivers that use Wire
+ * directly always see the default.
+ */
+void ArdusatBusClass::release()
+{
+  if (_current_clock != _default_clock) {
+    _apply(_default_clock);
+  }
+}
+
+/**
+ * Records a failed transaction and decides whether to try it again. Timeouts
+ * and bus errors recover the bus first. A device that doesn't acknowledge its
+ * address isn't retried, since it's most likely not there.
+ *
+ * @param status the failure, as returned by readFromRegAddr/writeToRegAddr
+ * @param attempt number of tries so far, minus one
+ *
+ * @return true if the transaction should be tried again
+ */
+boolean ArdusatBusClass::retry(int status, uint8_t attempt)
+{
+  boolean timedOut = (status == 4 || status == 5);
+
+#ifdef WIRE_HAS_TIMEOUT
+  if (Wire.getWireTimeoutFlag()) {
+    Wire.clearWireTimeoutFlag();
+    timedOut = true;
+  }
+#endif
+
+  if (timedOut) {
+    recover();
+  }
+
+  if (status == 2 || attempt >= BUS_RETRIES) {
+    _errors++;
+    return false;
+  }
+
+  _retries++;
+  return true;
+}
+
+/**
+ * Frees a bus left stuck by a device holding SDA low (e.g. after a reset in
+ * the middle of a read) by clocking SCL until it lets go, then sending a STOP
+ * and restarting Wire.
+ *
+ * @return true if SDA was released
+ */
+boolean ArdusatBusClass::recover()
+{
+  boolean released;
+
+  Wire.end();
+
+  pinMode(SDA, INPUT_PULLUP);
+  pinMode(SCL, INPUT_PULLUP);
+
+  // A device finishes the byte it's sending within 9 clocks
+  for (uint8_t i = 0; i < 9 && digitalRead(SDA) == LOW; ++i) {
+    digitalWrite(SCL, LOW);
+    pinMode(SCL, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(SCL, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+
+  released = (digitalRead(SDA) == HIGH);
+
+  // STOP: SDA rises while SCL is high
+  digitalWrite(SDA, LOW);
+  pinMode(SDA, OUTPUT);
+  delayMicroseconds(5);
+  pinMode(SDA, INPUT_PULLUP);
+  delayMicroseconds(5);
+
+  _recoveries++;
+
+  // The mux may have been reset too, so select the channel again next time
+  _channel = BUS_NO_CHANNEL;
+
+  if (_begun) {
+    Wire.begin();
+    _current_clock = 0;
+    _applyTimeout();
+    _apply(_default_clock);
+  }
+
+  return released;
+}
+
+/**
+ * Counts one transaction (a START or repeated START up to the next one, or the
+ * STOP) and the time it kept the bus busy at the current clock
+ *
+ * @param bytes bytes sent or received, including the address byte
+ */
+void ArdusatBusClass::countTraffic(uint8_t bytes)
+{
+  // 9 clocks per byte with the ACK, plus about 2 for the START and STOP
+  uint16_t bits = (uint16_t) bytes * 9 + 2;
+  uint32_t clock = _current_clock ? _current_clock : _default_clock;
+
+  _transactions++;
+  _bytes += bytes;
+
+  uint32_t ns = bits * (1000000000UL / clock) + _bus_ns;
+
+  _bus_us += ns / 1000;
+  _bus_ns = ns % 1000;
+}
+
+/**
+ * Sets the address of the TCA9548A mux that selectChannel() switches
+ *
+ * @param addr I2C address of the mux, 0x70-0x77
+ */
+void ArdusatBusClass::setMuxAddress(uint8_t addr)
+{
+  _mux_addr = addr;
+  _channel = BUS_NO_CHANNEL;
+}
+
+/**
+ * Connects one mux channel to the bus, disconnecting the rest. Costs nothing
+ * when the channel is already selected.
+ *
+ * @param channel mux channel, 0 to BUS_MUX_CHANNELS - 1
+ *
+ * @return true if the channel is selected
+ */
+boolean ArdusatBusClass::selectChannel(uint8_t channel)
+{
+  uint8_t status;
+
+  if (channel == _channel) {
+    return true;
+  }
+  if (channel >= BUS_MUX_CHANNELS) {
+    return false;
+  }
+
+  begin();
+
+  // The TCA9548A has no registers; the one byte written is the channel mask
+  for (uint8_t attempt = 0; ; ++attempt) {
+    select(_mux_addr);
+    Wire.beginTransmission(_mux_addr);
+    Wire.write((uint8_t) (1 << channel));
+    status = Wire.endTransmission();
+    countTraffic(2);
+    release();
+
+    if (status == 0) {
+      _channel = channel;
+      _switches++;
+      return true;
+    }
+    if (!retry(status, attempt)) {
+      _channel = BUS_NO_CHANNEL;
+      return false;
+    }
+  }
+}
+
+void ArdusatBusClass::resetCounts()
+{
+  _errors = 0;
+  _retries = 0;
+  _recoveries = 0;
+  _transactions = 0;
+  _bytes = 0;
+  _bus_us = 0;
+  _bus_ns = 0;
+  _switches = 0;
+}
+
+void ArdusatBusClass::_applyTimeout()
+{
+#ifdef WIRE_HAS_TIMEOUT
+  Wire.setWireTimeout(_timeout, true);
+#endif
+}
+
+void ArdusatBusClass::_apply(uint32_t clock)
+{
+  if (_begun && clock != _current_clock) {
+    Wire.setClock(clock);
+    _current_clock = clock;
+  }
+}
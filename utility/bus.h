@@ -0,0 +1,182 @@
+/**
+ * @file   bus.h
+ * @date   October 14, 2026
+ * @brief  Owns the I2C bus setup and applies per-device clock speeds
+ */
+
+#ifndef ARDUSAT_BUS_H_
+#define ARDUSAT_BUS_H_
+
+#include <Arduino.h>
+
+/**
+ * Clock speeds for the AVR TWI peripheral
+ */
+#define BUS_CLOCK_STANDARD 100000UL  /* Standard mode / SMBus */
+#define BUS_CLOCK_FAST     400000UL  /* Fast mode */
+
+/**
+ * Clock used for any device without an override. Every sensor in the kit and
+ * on the spaceboard supports fast mode except the MLX90614, which is handled
+ * with an override.
+ */
+#ifndef BUS_DEFAULT_CLOCK
+#define BUS_DEFAULT_CLOCK BUS_CLOCK_FAST
+#endif
+
+/**
+ * Maximum number of devices that can have their own clock speed
+ */
+#ifndef BUS_MAX_DEVICE_CLOCKS
+#define BUS_MAX_DEVICE_CLOCKS 4
+#endif
+
+/**
+ * Longest a single I2C transaction may take before it's abandoned, in
+ * microseconds. Needs an Arduino core whose Wire library supports timeouts
+ * (AVR core 1.8.3 or newer); older cores can still hang inside Wire.
+ */
+#ifndef BUS_TIMEOUT_US
+#define BUS_TIMEOUT_US 25000UL
+#endif
+
+/**
+ * Number of times a failed transaction is retried before it counts as an error
+ */
+#ifndef BUS_RETRIES
+#define BUS_RETRIES 1
+#endif
+
+/**
+ * Bytes in the map of which addresses answered a bus scan, one bit per address
+ */
+#define BUS_PRESENT_MAP_SIZE 16
+
+/**
+ * Default address of a TCA9548A I2C mux (A0-A2 tied low). Up to eight can be
+ * strapped to 0x70-0x77.
+ */
+#ifndef BUS_MUX_ADDR
+#define BUS_MUX_ADDR 0x70
+#endif
+
+/**
+ * Downstream channels on a TCA9548A
+ */
+#define BUS_MUX_CHANNELS 8
+
+/**
+ * Mux channel of a device on the main bus, which is reachable whatever channel
+ * is selected
+ */
+#define BUS_NO_CHANNEL 0xFF
+
+typedef struct {
+  uint8_t addr;
+  uint32_t clock;
+} _bus_device_clock_t;
+
+/**************************************************************************//**
+ * @class ArdusatBusClass
+ *
+ * @brief Initializes Wire once and sets the I2C clock for each device
+ *
+ * The bus runs at the default clock (fast mode unless changed). Devices that
+ * can't keep up get an override, which is switched in for just their
+ * transactions in readFromRegAddr, writeToRegAddr and runRegOps, after which
+ * the bus goes back to the default clock.
+ *
+ * Sensors call `ArdusatBus.begin()` themselves, so a sketch only needs to use
+ * this object to change the speeds, e.g. to drop to standard mode on long
+ * wires or weak pull-ups:
+ * @code
+ *     void setup(void) {
+ *       ArdusatBus.setDefaultClock(BUS_CLOCK_STANDARD);
+ *       accel.begin();
+ *     }
+ * @endcode
+ *
+ * Failed transactions are retried up to BUS_RETRIES times. A transaction
+ * that times out or hits a bus error also runs `recover()`, which clocks SCL
+ * until a device holding SDA low lets go. So a misbehaving sensor costs at
+ * most (BUS_RETRIES + 1) * BUS_TIMEOUT_US per transaction instead of hanging
+ * the sketch. The counters wrap at 65535; each Sensor also keeps its own
+ * count of the errors and retries seen during its reads.
+ *
+ * Transactions through readFromRegAddr, writeToRegAddr and runRegOps are also
+ * counted, with the bytes sent on the wire (including address bytes) and an
+ * estimate of the time the bus was busy, for measuring what each reading
+ * costs. Drivers that use Wire directly (the LSM303 and SI1132) aren't counted.
+ *
+ * Identical sensors with the same address can sit behind a TCA9548A mux, one
+ * per channel. `selectChannel()` switches the mux, and only writes to it when
+ * the channel changes; sensors given a channel with Sensor::setBusChannel()
+ * select it before each of their transactions.
+ *****************************************************************************/
+class ArdusatBusClass {
+  public:
+    ArdusatBusClass();
+
+    void begin();
+    void setDefaultClock(uint32_t clock);
+    uint32_t defaultClock() { return _default_clock; }
+    boolean setDeviceClock(uint8_t addr, uint32_t clock);
+    uint32_t deviceClock(uint8_t addr);
+
+    void setTimeout(uint32_t timeout);
+    uint32_t timeout() { return _timeout; }
+
+    uint8_t scan();
+    boolean present(uint8_t addr);
+    const uint8_t * presentMap() { return _present; }
+    void setPresentMap(const uint8_t map[BUS_PRESENT_MAP_SIZE]);
+
+    void select(uint8_t addr);
+    void release();
+    boolean retry(int status, uint8_t attempt);
+    boolean recover();
+    void noteError() { _errors++; }
+    void countTraffic(uint8_t bytes);
+
+    void setMuxAddress(uint8_t addr);
+    uint8_t muxAddress() { return _mux_addr; }
+    boolean selectChannel(uint8_t channel);
+    uint8_t channel() { return _channel; }
+    uint16_t channelSwitches() { return _switches; }
+
+    uint16_t errorCount() { return _errors; }
+    uint16_t retryCount() { return _retries; }
+    uint16_t recoveryCount() { return _recoveries; }
+    uint32_t transactionCount() { return _transactions; }
+    uint32_t byteCount() { return _bytes; }
+    uint32_t busMicros() { return _bus_us; }
+    void resetCounts();
+
+  private:
+    void _apply(uint32_t clock);
+    void _applyTimeout();
+
+    boolean _begun;
+    boolean _scanned;
+    boolean _restored;
+    uint8_t _present[BUS_PRESENT_MAP_SIZE];
+    uint32_t _timeout;
+    uint16_t _errors;
+    uint16_t _retries;
+    uint16_t _recoveries;
+    uint32_t _transactions;
+    uint32_t _bytes;
+    uint32_t _bus_us;
+    uint16_t _bus_ns;
+    uint32_t _default_clock;
+    uint32_t _current_clock;
+    uint8_t _num_device_clocks;
+    _bus_device_clock_t _device_clocks[BUS_MAX_DEVICE_CLOCKS];
+    uint8_t _mux_addr;
+    uint8_t _channel;
+    uint16_t _switches;
+};
+
+extern ArdusatBusClass ArdusatBus;
+
+#endif
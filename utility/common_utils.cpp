@@ -6,22 +6,18 @@
  */
 
 #include "common_utils.h"
+#include "timing.h"
 
-/**
- * Generic I2C Read function
- *
- * @param devAddr I2C Device address
- * @param reg Register address
- * @param val pointer to byte array to read into
- * @param length number of bytes to read
- *
- * @return 0 on success, other on failure
+/*
+ * Reads from a register, ending with a STOP if sendStop is true or leaving the
+ * bus held for a repeated START otherwise
  */
-int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endian_e endianness)
+static int _readRegs(uint8_t devAddr, uint8_t reg, void *val, size_t length,
+                     endian_e endianness, bool sendStop)
 {
   uint8_t *byteArray = (uint8_t *) val;
   int ret;
-  int readData = 0;
+  size_t readData = 0;
 
   Wire.beginTransmission(devAddr);
 
@@ -29,7 +25,9 @@ int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endi
     return -1;
   }
 
-  if ((ret = Wire.endTransmission(false)) != 0) {
+  ret = Wire.endTransmission(false);
+  ArdusatBus.countTraffic(2);
+  if (ret != 0) {
     return ret;
   }
 
@@ -37,23 +35,72 @@ int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endi
     return 0;
   }
 
-  Wire.beginTransmission(devAddr);
-  Wire.requestFrom(devAddr, (uint8_t) length);
+  // requestFrom is a transaction of its own, and sends the STOP if asked to
+  Wire.requestFrom(devAddr, (uint8_t) length, (uint8_t) sendStop);
 
   while (Wire.available() > 0 && readData < length) {
     byteArray[endianness == BIG_ENDIAN ? readData : length - 1 - readData] = Wire.read();
     readData++;
   }
+  ArdusatBus.countTraffic(1 + length);
 
-  if ((ret = Wire.endTransmission(true)) != 0) {
-    return ret;
+  return readData == length ? 0 : -1;
+}
+
+/*
+ * Writes to a register, ending with a STOP if sendStop is true or leaving the
+ * bus held for a repeated START otherwise
+ */
+static int _writeRegs(uint8_t devAddr, uint8_t reg, void *val, size_t length,
+                      endian_e endianness, bool sendStop)
+{
+  uint8_t *byteArray = (uint8_t *) val;
+  int ret;
+
+  Wire.beginTransmission(devAddr);
+
+  if (Wire.write(reg) < 1) {
+    return -1;
   }
 
-  return 0;
+  for (size_t i = 0; i < length; i++) {
+    if (Wire.write(byteArray[endianness == BIG_ENDIAN ? i : length - 1 - i]) < 1) {
+      return -1;
+    }
+  }
+
+  ret = Wire.endTransmission(sendStop);
+  ArdusatBus.countTraffic(2 + length);
+  return ret;
+}
+
+/**
+ * Generic I2C Read function. Failed reads are retried, see ArdusatBusClass.
+ *
+ * @param devAddr I2C Device address
+ * @param reg Register address
+ * @param val pointer to byte array to read into
+ * @param length number of bytes to read
+ *
+ * @return 0 on success, other on failure
+ */
+int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endian_e endianness)
+{
+  int ret;
+  uint8_t attempt = 0;
+  TIMING_START(start);
+
+  ArdusatBus.select(devAddr);
+  while ((ret = _readRegs(devAddr, reg, val, length, endianness, true)) != 0 &&
+         ArdusatBus.retry(ret, attempt++)) {
+  }
+  ArdusatBus.release();
+  TIMING_END(ArdusatTiming.bus, start);
+  return ret;
 }
 
 /**
- * Generic I2C Write function
+ * Generic I2C Write function. Failed writes are retried, see ArdusatBusClass.
  *
  * @param devAddr I2C Device address
  * @param reg Register address
@@ -64,24 +111,82 @@ int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endi
  */
 int writeToRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endian_e endianness)
 {
-  uint8_t *byteArray = (uint8_t *) val;
   int ret;
+  uint8_t attempt = 0;
+  TIMING_START(start);
 
-  Wire.beginTransmission(devAddr);
-
-  if (Wire.write(reg) < 1) {
-    return -1;
+  ArdusatBus.select(devAddr);
+  while ((ret = _writeRegs(devAddr, reg, val, length, endianness, true)) != 0 &&
+         ArdusatBus.retry(ret, attempt++)) {
   }
+  ArdusatBus.release();
+  TIMING_END(ArdusatTiming.bus, start);
+  return ret;
+}
 
-  for (int i = 0; i < length; i++) {
-    if (Wire.write(byteArray[endianness == BIG_ENDIAN ? i : length - 1 - i]) < 1) {
-      return -1;
+/*
+ * Runs one attempt at a batch of register operations
+ */
+static int _runRegOps(uint8_t devAddr, const reg_op_t *ops, uint8_t count)
+{
+  int ret = 0;
+
+  for (uint8_t i = 0; i < count && ret == 0; ++i) {
+    bool last = (i == count - 1);
+
+    if (ops[i].type == REG_OP_READ) {
+      ret = _readRegs(devAddr, ops[i].reg, ops[i].val, ops[i].length, BIG_ENDIAN, last);
+    } else {
+      ret = _writeRegs(devAddr, ops[i].reg, ops[i].val, ops[i].length, BIG_ENDIAN, last);
     }
   }
 
-  if ((ret = Wire.endTransmission()) != 0) {
-    return ret;
+  if (ret != 0) {
+    // Release the bus if an op failed before the last one sent its STOP
+    Wire.beginTransmission(devAddr);
+    Wire.endTransmission(true);
+    ArdusatBus.countTraffic(1);
   }
 
-  return 0;
+  return ret;
+}
+
+/**
+ * Runs a batch of register reads and writes on one device, joined by repeated
+ * STARTs so the bus is only released (STOP) once at the end. Combined with a
+ * device's register auto-increment, contiguous registers should be read as one
+ * multi-byte op rather than several small ones.
+ *
+ * Example Usage:
+ * @code
+ *     uint16_t ch0, ch1;
+ *     uint8_t off = 0x00;
+ *     reg_op_t ops[] = {
+ *       REG_READ(0xAC, &ch0, 2),
+ *       REG_READ(0xAE, &ch1, 2),
+ *       REG_WRITE(0x80, &off, 1),
+ *     };
+ *     runRegOps(0x39, ops, 3);
+ * @endcode
+ *
+ * @param devAddr I2C Device address
+ * @param ops register operations to run, in order
+ * @param count number of operations
+ *
+ * @return 0 on success, other on failure (the remaining ops are skipped, and
+ *         the whole batch is retried)
+ */
+int runRegOps(uint8_t devAddr, const reg_op_t *ops, uint8_t count)
+{
+  int ret;
+  uint8_t attempt = 0;
+  TIMING_START(start);
+
+  ArdusatBus.select(devAddr);
+  while ((ret = _runRegOps(devAddr, ops, count)) != 0 &&
+         ArdusatBus.retry(ret, attempt++)) {
+  }
+  ArdusatBus.release();
+  TIMING_END(ArdusatTiming.bus, start);
+  return ret;
 }
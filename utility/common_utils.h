@@ -9,6 +9,7 @@
 #define COMMON_UTILS_H_
 
 #include "Wire.h"
+#include "bus.h"
 
 typedef enum {
   BIG_ENDIAN,
@@ -17,4 +18,26 @@ typedef enum {
 
 int readFromRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endian_e endianness=BIG_ENDIAN);
 int writeToRegAddr(uint8_t devAddr, uint8_t reg, void *val, size_t length, endian_e endianness=BIG_ENDIAN);
+
+/**
+ * One register read or write in a batch run by runRegOps. Bytes are
+ * transferred in order (the same as BIG_ENDIAN for readFromRegAddr), so a
+ * little endian 16 bit register pair can be read straight into a uint16_t.
+ */
+typedef enum {
+  REG_OP_READ,
+  REG_OP_WRITE,
+} reg_op_type_e;
+
+typedef struct {
+  reg_op_type_e type;
+  uint8_t reg;
+  void *val;
+  uint8_t length;
+} reg_op_t;
+
+#define REG_READ(reg, val, length) { REG_OP_READ, (reg), (val), (length) }
+#define REG_WRITE(reg, val, length) { REG_OP_WRITE, (reg), (val), (length) }
+
+int runRegOps(uint8_t devAddr, const reg_op_t *ops, uint8_t count);
 #endif
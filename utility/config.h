@@ -0,0 +1,91 @@
+/**
+ * @file   config.h
+ * @date   October 14, 2026
+ * @brief  Compile-time board configuration
+ *
+ * By default the SDK works out whether it's running on a Space Kit or a
+ * SpaceBoard when the first sensor is started, and checks that on every read
+ * that differs between the two. Setting ARDUSAT_BOARD here (or with
+ * -DARDUSAT_BOARD=... in the build flags) fixes the board when the SDK is
+ * compiled instead: the detection is skipped, addresses become constants, and
+ * the code for the other board's sensors is left out.
+ */
+
+#ifndef ARDUSAT_CONFIG_H_
+#define ARDUSAT_CONFIG_H_
+
+#define ARDUSAT_BOARD_AUTO       0  /* Detect the board at run time */
+#define ARDUSAT_BOARD_SPACE_KIT  1
+#define ARDUSAT_BOARD_SPACEBOARD 2
+
+#ifndef ARDUSAT_BOARD
+#define ARDUSAT_BOARD ARDUSAT_BOARD_AUTO
+#endif
+
+/**
+ * BOARD_IS_SPACEBOARD() is a constant unless the board is detected at run time
+ */
+#if ARDUSAT_BOARD == ARDUSAT_BOARD_SPACEBOARD
+#define BOARD_IS_SPACEBOARD() (true)
+#elif ARDUSAT_BOARD == ARDUSAT_BOARD_SPACE_KIT
+#define BOARD_IS_SPACEBOARD() (false)
+#elif ARDUSAT_BOARD == ARDUSAT_BOARD_AUTO
+#define BOARD_IS_SPACEBOARD() (ARDUSAT_SPACEBOARD)
+#else
+#error "ARDUSAT_BOARD must be ARDUSAT_BOARD_AUTO, ARDUSAT_BOARD_SPACE_KIT or ARDUSAT_BOARD_SPACEBOARD"
+#endif
+
+/**
+ * Where detectBoard() (and so beginAll()) keeps its EEPROM cache of the board
+ * and the devices found on the bus, 19 bytes. Defaults to the end of the
+ * EEPROM, out of the way of sketches that use it from the start.
+ */
+#ifndef ARDUSAT_EEPROM_CACHE_ADDR
+#define ARDUSAT_EEPROM_CACHE_ADDR (E2END + 1 - 32)
+#endif
+
+/**
+ * Setting ARDUSAT_TIMING to 1 times sensor reads and formatting, bus
+ * transactions and serial writes with micros() (see utility/timing.h). Left at
+ * 0, the counters and the micros() calls aren't compiled in at all.
+ */
+#ifndef ARDUSAT_TIMING
+#define ARDUSAT_TIMING 0
+#endif
+
+/**
+ * Support for data-ready pins (Sensor::attachDataReady) and for report
+ * policies (Sensor::setReportPolicy). Setting either to 0 leaves its code out,
+ * along with its state in every sensor object: 1 byte for data-ready pins, 2
+ * bytes for report policies, plus a vtable entry per sensor class for
+ * data-ready pins.
+ */
+#ifndef ARDUSAT_DATA_READY
+#define ARDUSAT_DATA_READY 1
+#endif
+#ifndef ARDUSAT_REPORT_POLICY
+#define ARDUSAT_REPORT_POLICY 1
+#endif
+
+/**
+ * Setting ARDUSAT_STATIC_BUFFERS to 1 fixes all of the SDK's RAM when it's
+ * compiled: the output buffer becomes an array of ARDUSAT_OUTPUT_BUF_SIZE bytes
+ * (and OUTPUT_BUF_SIZE a constant), and ArdusatSerial builds its SoftwareSerial
+ * inside itself instead of on the heap. Nothing is allocated at run time, so the
+ * "Global variables use ..." figure from the Arduino IDE (or
+ * sram_report/sram_report.py) is everything the SDK uses.
+ */
+#ifndef ARDUSAT_STATIC_BUFFERS
+#define ARDUSAT_STATIC_BUFFERS 0
+#endif
+
+/**
+ * Bytes in the output buffer that toCSV/toJSON/toBinary return. Without
+ * ARDUSAT_STATIC_BUFFERS this is only the starting value of OUTPUT_BUF_SIZE,
+ * which a sketch may change before the first record is formatted.
+ */
+#ifndef ARDUSAT_OUTPUT_BUF_SIZE
+#define ARDUSAT_OUTPUT_BUF_SIZE 256
+#endif
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file   crc.h
+ * @date   October 14, 2026
+ * @brief  CRC functions used to protect binary output frames and text records
+ */
+
+#ifndef ARDUSAT_CRC_H_
+#define ARDUSAT_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF, no reflection
+ */
+#define CRC16_INIT 0xFFFF
+
+uint16_t crc16_update(uint16_t crc, uint8_t data);
+uint16_t crc16(const void *data, size_t length);
+
+/**
+ * CRC-8/SMBUS: polynomial 0x07, initial value 0x00, no reflection
+ */
+#define CRC8_INIT 0x00
+
+uint8_t crc8_update(uint8_t crc, uint8_t data);
+uint8_t crc8(const void *data, size_t length);
+
+#endif /* ARDUSAT_CRC_H_ */
@@ -0,0 +1,97 @@
+/**
+ * @file   dataready.cpp
+ * @date   October 14, 2026
+ * @brief  Flags new samples signalled on a sensor's data-ready pin
+ */
+
+#include "dataready.h"
+
+static volatile uint8_t _flags = 0;
+static volatile unsigned long _times[DATA_READY_MAX_INTERRUPTS];
+static uint8_t _attached = 0;
+
+static inline void _mark(uint8_t irq) {
+  _times[irq] = millis();
+  _flags |= 1 << irq;
+}
+
+// attachInterrupt doesn't pass an argument to the handler, so each interrupt
+// needs its own
+static void _isr0() { _mark(0); }
+static void _isr1() { _mark(1); }
+static void _isr2() { _mark(2); }
+static void _isr3() { _mark(3); }
+static void _isr4() { _mark(4); }
+static void _isr5() { _mark(5); }
+static void _isr6() { _mark(6); }
+static void _isr7() { _mark(7); }
+
+static void (* const _isrs[DATA_READY_MAX_INTERRUPTS])(void) = {
+  _isr0, _isr1, _isr2, _isr3, _isr4, _isr5, _isr6, _isr7
+};
+
+/**
+ * Starts flagging rising edges on a data-ready pin
+ *
+ * @param pin Arduino pin the sensor's data-ready output is wired to
+ *
+ * @return external interrupt number, or -1 if the pin has no external
+ *         interrupt or it's already in use
+ */
+int8_t dataReadyAttach(uint8_t pin) {
+  int irq = digitalPinToInterrupt(pin);
+
+  if (irq == NOT_AN_INTERRUPT || irq < 0 || irq >= DATA_READY_MAX_INTERRUPTS ||
+      (_attached & (1 << irq))) {
+    return -1;
+  }
+
+  pinMode(pin, INPUT);
+  _attached |= 1 << irq;
+
+  noInterrupts();
+  _flags &= ~(1 << irq);
+  interrupts();
+
+  attachInterrupt(irq, _isrs[irq], RISING);
+  return irq;
+}
+
+void dataReadyDetach(int8_t irq) {
+  if (irq < 0 || !(_attached & (1 << irq))) {
+    return;
+  }
+
+  detachInterrupt(irq);
+  _attached &= ~(1 << irq);
+}
+
+/**
+ * Checks for a new sample and clears the flag if there is one. The data-ready
+ * outputs stay high until the sample is read, so a pin that is already high
+ * counts too, in case its rising edge came before the interrupt was attached.
+ *
+ * @param irq interrupt number from dataReadyAttach
+ * @param pin the same data-ready pin
+ * @param at location to store the millis() at the rising edge in
+ *
+ * @return true if a new sample is waiting to be read
+ */
+boolean dataReadyTake(int8_t irq, uint8_t pin, unsigned long *at) {
+  boolean ready;
+
+  noInterrupts();
+  ready = (_flags & (1 << irq)) != 0;
+  if (ready) {
+    _flags &= ~(1 << irq);
+    *at = _times[irq];
+  }
+  interrupts();
+
+  if (!ready && digitalRead(pin) == HIGH) {
+    *at = millis();
+    ready = true;
+  }
+
+  return ready;
+}
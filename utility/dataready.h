@@ -0,0 +1,25 @@
+/**
+ * @file   dataready.h
+ * @date   October 14, 2026
+ * @brief  Flags new samples signalled on a sensor's data-ready pin
+ *
+ * Uses the external interrupts (INT0/INT1 on pins 2 and 3 of an Uno) rather
+ * than pin change interrupts, which SoftwareSerial already takes over for
+ * ArdusatSerial.
+ */
+
+#ifndef ARDUSAT_DATAREADY_H_
+#define ARDUSAT_DATAREADY_H_
+
+#include <Arduino.h>
+
+/**
+ * Most external interrupts any supported board has (the Mega has 6)
+ */
+#define DATA_READY_MAX_INTERRUPTS 8
+
+int8_t dataReadyAttach(uint8_t pin);
+void dataReadyDetach(int8_t irq);
+boolean dataReadyTake(int8_t irq, uint8_t pin, unsigned long *at);
+
+#endif
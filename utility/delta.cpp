@@ -0,0 +1,104 @@
+/**
+ * @file   delta.cpp
+ * @date   October 14, 2026
+ * @brief  Delta and zigzag-varint encoding of a stream of raw samples
+ */
+
+#include "delta.h"
+
+/**
+ * Writes a signed value as a zigzag-varint: 0, -1, 1, -2, ... become 0, 1, 2,
+ * 3, ..., sent 7 bits at a time, least significant first, with the top bit set
+ * on every byte but the last. Values within +-63 take a single byte.
+ *
+ * @param value value to write
+ * @param out at least DELTA_VARINT_MAX_SIZE bytes
+ *
+ * @return number of bytes written
+ */
+uint8_t deltaPutVarint(int32_t value, uint8_t *out)
+{
+  uint32_t zigzag = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+  uint8_t len = 0;
+
+  while (zigzag >= 0x80) {
+    out[len++] = (zigzag & 0x7F) | 0x80;
+    zigzag >>= 7;
+  }
+  out[len++] = zigzag;
+
+  return len;
+}
+
+/**
+ * @param keyframeInterval samples per keyframe, 1 for keyframes only
+ */
+DeltaEncoder::DeltaEncoder(uint8_t keyframeInterval)
+{
+  _seq = 0;
+  setKeyframeInterval(keyframeInterval);
+  reset();
+}
+
+/**
+ * Sets how often a keyframe is sent. Takes effect after the next keyframe.
+ *
+ * @param interval samples per keyframe, 1 for keyframes only
+ */
+void DeltaEncoder::setKeyframeInterval(uint8_t interval)
+{
+  _interval = interval == 0 ? 1 : interval;
+}
+
+/**
+ * Makes the next sample a keyframe, e.g. when a receiver has just joined
+ */
+void DeltaEncoder::reset(void)
+{
+  _count = 0;
+}
+
+/**
+ * Takes the next sample of the stream and works out how to send it. The
+ * sequence number moves on with every sample; sequence() is then the one to
+ * send it with.
+ *
+ * @param timestamp sample time
+ * @param scale unit per count; a change forces a keyframe
+ * @param count number of values, at most DELTA_MAX_VALUES
+ * @param values raw values
+ * @param deltas count + 1 differences from the last sample, the timestamp first
+ *
+ * @return true if the sample has to be sent as a keyframe, and deltas weren't set
+ */
+boolean DeltaEncoder::next(unsigned long timestamp, float scale, uint8_t count, const int16_t *values,
+                           int32_t *deltas)
+{
+  boolean keyframe;
+
+  if (count > DELTA_MAX_VALUES) {
+    count = DELTA_MAX_VALUES;
+  }
+
+  keyframe = (count != _count || scale != _scale || _since_key >= _interval);
+
+  if (keyframe) {
+    _since_key = 1;
+  } else {
+    _since_key++;
+    deltas[0] = (int32_t) (timestamp - _timestamp);
+    for (uint8_t i = 0; i < count; ++i) {
+      deltas[i + 1] = (int32_t) values[i] - _values[i];
+    }
+  }
+
+  _seq++;
+  _count = count;
+  _scale = scale;
+  _timestamp = timestamp;
+  for (uint8_t i = 0; i < count; ++i) {
+    _values[i] = values[i];
+  }
+
+  return keyframe;
+}
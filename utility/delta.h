@@ -0,0 +1,77 @@
+/**
+ * @file   delta.h
+ * @date   October 14, 2026
+ * @brief  Delta and zigzag-varint encoding of a stream of raw samples
+ *
+ * Consecutive samples from a sensor usually differ by a few counts, so after a
+ * keyframe with the full timestamp and values, each sample is sent as the
+ * difference from the one before, in as few bytes as it needs. See
+ * rawValuesToDelta() for the frames, and decode_binary/decode_binary.py for
+ * the matching decoder.
+ */
+
+#ifndef ARDUSAT_DELTA_H_
+#define ARDUSAT_DELTA_H_
+
+#include <Arduino.h>
+
+/**
+ * Most values per sample (x, y and z)
+ */
+#define DELTA_MAX_VALUES 3
+
+/**
+ * Keyframes sent per delta frame, so a decoder that missed a frame recovers
+ * within this many samples
+ */
+#ifndef DELTA_KEYFRAME_INTERVAL
+#define DELTA_KEYFRAME_INTERVAL 32
+#endif
+
+/**
+ * Longest zigzag-varint for a 32 bit value
+ */
+#define DELTA_VARINT_MAX_SIZE 5
+
+uint8_t deltaPutVarint(int32_t value, uint8_t *out);
+
+/**************************************************************************//**
+ * @class DeltaEncoder
+ * @ingroup sensor
+ *
+ * @brief Keeps the last sample of one stream, to encode the next as deltas
+ *
+ * Use one encoder per sensor stream, since it holds the previous sample.
+ *
+ * Example Usage:
+ * @code
+ *     DeltaEncoder accelStream(16); // a keyframe every 16 samples
+ *
+ *     void loop(void) {
+ *       accel.read();
+ *       accel.writeDeltaBinary(serialConnection, accelStream);
+ *     }
+ * @endcode
+ *****************************************************************************/
+class DeltaEncoder {
+  public:
+    DeltaEncoder(uint8_t keyframeInterval = DELTA_KEYFRAME_INTERVAL);
+
+    boolean next(unsigned long timestamp, float scale, uint8_t count, const int16_t *values,
+                 int32_t *deltas);
+    void reset(void);
+    void setKeyframeInterval(uint8_t interval);
+
+    uint8_t sequence(void) { return _seq; }
+
+  private:
+    uint8_t _interval;
+    uint8_t _since_key;
+    uint8_t _seq;
+    uint8_t _count;
+    float _scale;
+    unsigned long _timestamp;
+    int16_t _values[DELTA_MAX_VALUES];
+};
+
+#endif
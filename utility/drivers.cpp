@@ -9,56 +9,172 @@
  * generic interface uses to get data from individual sensors.
  */
 
+#include <avr/eeprom.h>
+#include <string.h>
 #include "ArdusatSDK.h"
 #include "drivers.h"
 #include <Wire.h>
+#include <utility/crc.h>
 
 static config_lsm303_accel_t _lsm303_d_accel_config;
 static config_lsm303_mag_t _lsm303_d_mag_config;
-static config_l3gd20_t _l3gd20_config;
+
+/*
+ * What detectBoard(true) saves in EEPROM
+ */
+typedef struct {
+  uint8_t magic;
+  uint8_t spaceboard;
+  uint8_t present[BUS_PRESENT_MAP_SIZE];
+  uint8_t crc;
+} _board_cache_t;
+#define _BOARD_CACHE_MAGIC 0xAD
+
+static boolean _board_checked = false;
+
+/*
+ * Checks the identify registers of the ISL29125 and TCS34725 RGB Light Sensors
+ * at their spaceboard addresses. They are only included with the spaceboard,
+ * not the space kit, so if they both reply, the user has a spaceboard.
+ */
+static boolean _probeSpaceboard() {
+  uint8_t islData = 0;
+  uint8_t tcsData = 0;
+
+  // Skip the reads if a scan already found nothing there
+  if (!ArdusatBus.present(DRIVER_SPACEBOARD_ISL29125_ADDR) ||
+      !ArdusatBus.present(DRIVER_SPACEBOARD_TCS34725_ADDR)) {
+    return false;
+  }
+
+  readFromRegAddr(DRIVER_SPACEBOARD_ISL29125_ADDR, 0x00, &islData, 1, BIG_ENDIAN);
+  readFromRegAddr(DRIVER_SPACEBOARD_TCS34725_ADDR, 0x80 | 0x12, &tcsData, 1, BIG_ENDIAN);
+
+  return islData == 0x7D && (tcsData == 0x44 || tcsData == 0x10);
+}
+
+/*
+ * Checks an address answers, without counting a missing device as a bus error
+ */
+static boolean _probeAddr(uint8_t addr) {
+  ArdusatBus.select(addr);
+  Wire.beginTransmission(addr);
+  boolean found = (Wire.endTransmission() == 0);
+  ArdusatBus.release();
+  return found;
+}
+
+/*
+ * Loads the EEPROM board cache, if there is a valid one that still matches the
+ * hardware: every device it lists must still answer, and the spaceboard's
+ * ISL29125 mustn't have appeared since.
+ */
+static boolean _loadBoardCache(_board_cache_t *cache) {
+  uint8_t addr;
+
+  eeprom_read_block(cache, (const void *) ARDUSAT_EEPROM_CACHE_ADDR, sizeof(*cache));
+
+  if (cache->magic != _BOARD_CACHE_MAGIC ||
+      crc8(cache, sizeof(*cache) - 1) != cache->crc) {
+    return false;
+  }
+
+  for (addr = 0x08; addr < 0x78; ++addr) {
+    if (((cache->present[addr >> 3] >> (addr & 0x07)) & 1) && !_probeAddr(addr)) {
+      return false;
+    }
+  }
+
+  addr = DRIVER_SPACEBOARD_ISL29125_ADDR;
+  return ((cache->present[addr >> 3] >> (addr & 0x07)) & 1) || !_probeAddr(addr);
+}
+
+static void _saveBoardCache(boolean spaceboard) {
+  _board_cache_t cache;
+
+  cache.magic = _BOARD_CACHE_MAGIC;
+  cache.spaceboard = spaceboard;
+  memcpy(cache.present, ArdusatBus.presentMap(), sizeof(cache.present));
+  cache.crc = crc8(&cache, sizeof(cache) - 1);
+
+  // update only writes the bytes that changed, sparing the EEPROM
+  eeprom_update_block(&cache, (void *) ARDUSAT_EEPROM_CACHE_ADDR, sizeof(cache));
+}
 
 /**
- * Check to see if both the ISL29125 and TCS34725 RGB Light Sensors
- * exists. They are only included with the spaceboard, not the space
- * kit, so if they do exist, the user has a spaceboard.
+ * Works out if the user has a spaceboard the first time a sensor is started.
+ * Does nothing after that, when MANUAL_CONFIG is set, or when ARDUSAT_BOARD
+ * fixes the board at compile time.
  */
 void catchSpaceboard() {
+#if ARDUSAT_BOARD == ARDUSAT_BOARD_AUTO
   // Only need to check once, as `catchSpaceboard` is called by all
   // sensor `begin` functions
-  if (!ARDUSAT_SPACEBOARD && !MANUAL_CONFIG) {
-    uint8_t islData;
-    uint8_t tcsData;
-    Wire.begin();
-
-    // Here, we are checking to see if the sensor replies with the
-    // correct response at its expected address on the spaceboard
-    readFromRegAddr(DRIVER_SPACEBOARD_ISL29125_ADDR, 0x00, &islData, 1, BIG_ENDIAN);
-    readFromRegAddr(DRIVER_SPACEBOARD_TCS34725_ADDR, 0x80 | 0x12, &tcsData, 1, BIG_ENDIAN);
-
-    // Checking the responses from the identify registers of each
-    // sensor to make sure it's what we expect for both
-    if (islData == 0x7D && (tcsData == 0x44 || tcsData == 0x10)) {
-      ARDUSAT_SPACEBOARD = true;
+  if (!_board_checked && !ARDUSAT_SPACEBOARD && !MANUAL_CONFIG) {
+    ArdusatBus.begin();
+    ARDUSAT_SPACEBOARD = _probeSpaceboard();
+  }
+  _board_checked = true;
+#endif
+}
+
+/**
+ * Scans the bus once, recording which devices are present (see
+ * ArdusatBusClass::present) and which board is in use. With useCache the
+ * result is kept in EEPROM at ARDUSAT_EEPROM_CACHE_ADDR, and on later boots is
+ * checked against the hardware and reused instead of scanning.
+ *
+ * @param useCache true to load and save the EEPROM cache
+ *
+ * @return true if a valid EEPROM cache was used
+ */
+boolean detectBoard(boolean useCache) {
+  _board_cache_t cache;
+  boolean cached = false;
+  boolean spaceboard;
+
+  ArdusatBus.begin();
+
+  if (useCache && _loadBoardCache(&cache)) {
+    ArdusatBus.setPresentMap(cache.present);
+    spaceboard = cache.spaceboard;
+    cached = true;
+  } else {
+    ArdusatBus.scan();
+    spaceboard = _probeSpaceboard();
+
+    if (useCache) {
+      _saveBoardCache(spaceboard);
     }
   }
+
+#if ARDUSAT_BOARD == ARDUSAT_BOARD_AUTO
+  if (!MANUAL_CONFIG) {
+    ARDUSAT_SPACEBOARD = spaceboard;
+  }
+#endif
+  _board_checked = true;
+
+  return cached;
 }
 
 /*
  * L3GD20 Gyro Sensor
  */
-boolean l3gd20h_init(uint8_t range) {
+boolean l3gd20h_init(uint8_t addr, uint8_t range) {
   uint8_t buf;
-  Wire.begin();
+  ArdusatBus.begin();
 
   // Check WHO_AM_I register
-  if (readFromRegAddr(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_WHO_AM_I, &buf, 1) ||
+  if (!ArdusatBus.present(addr) ||
+      readFromRegAddr(addr, L3GD20_GYRO_REGISTER_WHO_AM_I, &buf, 1) ||
       ((buf != L3GD20_ID) && buf != L3GD20H_ID)) {
     return false;
   }
 
   // Sets switch to normal mode & enables 3 channels
   buf = 0x0F;
-  if (writeToRegAddr(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_CTRL_REG1, &buf, 1)) {
+  if (writeToRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG1, &buf, 1)) {
     return false;
   }
 
@@ -72,22 +188,11 @@ boolean l3gd20h_init(uint8_t range) {
   // 0x10 = 500 DPS
   // 0x20 = 2000 DPS
 
-  switch(range) {
-    case 0x00:
-      _l3gd20_config.sensitivity = L3GD20_GYRO_SENSITIVITY_250DPS;
-      break;
-    case 0x10:
-      _l3gd20_config.sensitivity = L3GD20_GYRO_SENSITIVITY_500DPS;
-      break;
-    case 0x20:
-      _l3gd20_config.sensitivity = L3GD20_GYRO_SENSITIVITY_2000DPS;
-      break;
-    default:
-      range = 0x20;
-      _l3gd20_config.sensitivity = L3GD20_GYRO_SENSITIVITY_2000DPS;
+  if (range != 0x00 && range != 0x10) {
+    range = 0x20;
   }
 
-  if (writeToRegAddr(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_CTRL_REG4, &range, 1))
+  if (writeToRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG4, &range, 1))
     return false;
 
   return true;
@@ -121,14 +226,84 @@ int _2bit_xyz_read(uint8_t addr, uint8_t reg, int16_t *x, int16_t *y, int16_t *z
   return ret;
 }
 
-void l3gd20h_getOrientation(float *x, float *y, float *z) {
+/*
+ * The L3GD20H and LSM303 FIFOs are drained with burst reads of the output
+ * registers. While the FIFO is enabled the register address wraps from OUT_Z_H
+ * back to OUT_X_L, so consecutive samples come out of a single read. Wire can
+ * only buffer BUFFER_LENGTH bytes per transaction, which limits each burst to
+ * 5 samples.
+ */
+#define _FIFO_SAMPLES_PER_READ (BUFFER_LENGTH / 6)
+
+static uint8_t _fifo_level(uint8_t fifoSrc) {
+  // OVRN is set once the FIFO is full and the oldest samples are being overwritten
+  if (fifoSrc & 0x40) {
+    return DRIVER_FIFO_DEPTH;
+  }
+  return fifoSrc & 0x1F;
+}
+
+static uint8_t _fifo_drain(uint8_t addr, uint8_t reg, uint8_t level,
+                           raw_xyz_t *samples, uint8_t maxSamples) {
+  uint8_t buf[_FIFO_SAMPLES_PER_READ * 6];
+  uint8_t *sample;
+  uint8_t count = 0;
+  uint8_t chunk;
+
+  if (level > maxSamples) {
+    level = maxSamples;
+  }
+
+  while (count < level) {
+    chunk = level - count;
+    if (chunk > _FIFO_SAMPLES_PER_READ) {
+      chunk = _FIFO_SAMPLES_PER_READ;
+    }
+
+    if (readFromRegAddr(addr, reg, buf, chunk * 6)) {
+      break;
+    }
+
+    for (sample = buf; chunk > 0; --chunk, sample += 6, ++count) {
+      samples[count].x = (int16_t)(sample[0] | (((int16_t) sample[1]) << 8));
+      samples[count].y = (int16_t)(sample[2] | (((int16_t) sample[3]) << 8));
+      samples[count].z = (int16_t)(sample[4] | (((int16_t) sample[5]) << 8));
+    }
+  }
+
+  return count;
+}
+
+void l3gd20h_getOrientation(uint8_t addr, uint8_t range, float *x, float *y, float *z) {
   int16_t vals[3];
-  if (_2bit_xyz_read(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_OUT_X_L | 0x80,
+  float scale = l3gd20h_getScale(range);
+
+  if (_2bit_xyz_read(addr, L3GD20_GYRO_REGISTER_OUT_X_L | 0x80,
                      &vals[0], &vals[1], &vals[2], false) == 0) {
 
-    *x = vals[0] * _l3gd20_config.sensitivity * SENSORS_DPS_TO_RADS;
-    *y = vals[1] * _l3gd20_config.sensitivity * SENSORS_DPS_TO_RADS;
-    *z = vals[2] * _l3gd20_config.sensitivity * SENSORS_DPS_TO_RADS;
+    *x = vals[0] * scale;
+    *y = vals[1] * scale;
+    *z = vals[2] * scale;
+  }
+}
+
+/**
+ * Gets the scale that converts raw l3gd20h angular rates to rad/s for a range
+ * passed to l3gd20h_init.
+ *
+ * @param range range register value (0x00, 0x10 or 0x20)
+ *
+ * @return rad/s per raw count
+ */
+float l3gd20h_getScale(uint8_t range)
+{
+  switch (range) {
+    case 0x00:
+      return L3GD20_GYRO_SENSITIVITY_250DPS * SENSORS_DPS_TO_RADS;
+    case 0x10:
+      return L3GD20_GYRO_SENSITIVITY_500DPS * SENSORS_DPS_TO_RADS;
+    default:
+      return L3GD20_GYRO_SENSITIVITY_2000DPS * SENSORS_DPS_TO_RADS;
   }
 }
 
@@ -140,11 +315,11 @@ void l3gd20h_getOrientation(float *x, float *y, float *z) {
  * @param pY value to store y-axis data in
  * @param pZ value to store z-axis data in
  */
-void l3gd20h_getRawAngularRates(int16_t *pX, int16_t *pY, int16_t *pZ)
+void l3gd20h_getRawAngularRates(uint8_t addr, int16_t *pX, int16_t *pY, int16_t *pZ)
 {
   if((NULL != pX) && (NULL != pY) && (NULL != pZ))
   {
-    _2bit_xyz_read(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_OUT_X_L | 0x80,
+    _2bit_xyz_read(addr, L3GD20_GYRO_REGISTER_OUT_X_L | 0x80,
                      pX, pY, pZ, false);
   }
 }
@@ -155,12 +330,82 @@ void l3gd20h_getRawAngularRates(int16_t *pX, int16_t *pY, int16_t *pZ)
  *
  * @param pRawTemperature location to store temp reading in
  */
-void l3gd20h_getRawTemperature(int8_t *pRawTemperature)
+void l3gd20h_getRawTemperature(uint8_t addr, int8_t *pRawTemperature)
 {
   if(NULL != pRawTemperature)
   {
-    readFromRegAddr(L3GD20_ADDRESS, L3GD20_GYRO_REGISTER_OUT_TEMP, pRawTemperature, sizeof(*pRawTemperature));
+    readFromRegAddr(addr, L3GD20_GYRO_REGISTER_OUT_TEMP, pRawTemperature, sizeof(*pRawTemperature));
+  }
+}
+
+/**
+ * Enables or disables the L3GD20H FIFO in stream mode. While the FIFO is enabled
+ * the output registers return the oldest stored sample, so samples should be read
+ * with l3gd20h_readFifo.
+ *
+ * @param enable true for stream mode, false for bypass mode (single samples)
+ *
+ * @return true on success
+ */
+boolean l3gd20h_setFifo(uint8_t addr, boolean enable) {
+  uint8_t ctrl5;
+  uint8_t fifoCtrl = enable ? 0x40 : 0x00; // FM2-0: 010 stream, 000 bypass
+
+  if (readFromRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG5, &ctrl5, 1)) {
+    return false;
+  }
+
+  // FIFO_EN
+  ctrl5 = enable ? (ctrl5 | 0x40) : (ctrl5 & ~0x40);
+
+  if (writeToRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG5, &ctrl5, 1) ||
+      writeToRegAddr(addr, L3GD20_GYRO_REGISTER_FIFO_CTRL_REG, &fifoCtrl, 1)) {
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Reads the raw angular rates stored in the L3GD20H FIFO, oldest first. The FIFO
+ * must have been enabled with l3gd20h_setFifo.
+ *
+ * @param samples array to store samples in
+ * @param maxSamples maximum number of samples to read
+ *
+ * @return number of samples read
+ */
+uint8_t l3gd20h_readFifo(uint8_t addr, raw_xyz_t *samples, uint8_t maxSamples) {
+  uint8_t fifoSrc;
+
+  if (samples == NULL ||
+      readFromRegAddr(addr, L3GD20_GYRO_REGISTER_FIFO_SRC_REG, &fifoSrc, 1)) {
+    return 0;
+  }
+
+  return _fifo_drain(addr, L3GD20_GYRO_REGISTER_OUT_X_L | 0x80,
+                     _fifo_level(fifoSrc), samples, maxSamples);
+}
+
+/**
+ * Turns the L3GD20H DRDY/INT2 pin's data-ready signal on or off. The pin goes
+ * high when a new sample is ready and low once it's read.
+ *
+ * @param enable true to signal new samples on the pin
+ *
+ * @return true if set
+ */
+boolean l3gd20h_setDataReady(uint8_t addr, boolean enable) {
+  uint8_t ctrl3;
+
+  if (readFromRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG3, &ctrl3, 1)) {
+    return false;
   }
+
+  // I2_DRDY, active high (H_Lactive = 0)
+  ctrl3 = enable ? ((ctrl3 | 0x08) & ~0x20) : (ctrl3 & ~0x08);
+
+  return writeToRegAddr(addr, L3GD20_GYRO_REGISTER_CTRL_REG3, &ctrl3, 1) == 0;
 }
 
 /*
@@ -172,7 +417,32 @@ void l3gd20h_getRawTemperature(int8_t *pRawTemperature)
  * LSM303_DLHC Datasheet:
  * https://www.adafruit.com/datasheets/LSM303DLHC.PDF
  */
-LSM303 lsm;
+// Driver objects are built on first use rather than as globals, so the ones a
+// sketch never uses (and their constructors) are dropped by the linker
+static LSM303 & _lsm303() {
+  static LSM303 device;
+  return device;
+}
+
+/*
+ * The LSM303 driver uses Wire directly, so its failures are counted here. A
+ * read that times out leaves the previous values in place.
+ */
+static void _lsm303_readAcc() {
+  _lsm303().readAcc();
+
+  if (_lsm303().timeoutOccurred() || _lsm303().last_status != 0) {
+    ArdusatBus.noteError();
+  }
+}
+
+static void _lsm303_readMag() {
+  _lsm303().readMag();
+
+  if (_lsm303().timeoutOccurred() || _lsm303().last_status != 0) {
+    ArdusatBus.noteError();
+  }
+}
 
 // LSM303 Accelerometer Configurations
 void _lsm303_accel_config(lsm303_accel_gain_e gGain) {
@@ -180,7 +450,7 @@ void _lsm303_accel_config(lsm303_accel_gain_e gGain) {
   _lsm303_d_accel_config.gain = gGain;
 
   // LSM303 D (Spaceboard variant)
-  if (lsm.getDeviceType() == LSM303::device_D) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
     // Adjustable gain:
     //   AFS = 0b00000000 (+/-  2 g full scale) = 0x00
     //   AFS = 0b00001000 (+/-  4 g full scale) = 0x08
@@ -204,11 +474,11 @@ void _lsm303_accel_config(lsm303_accel_gain_e gGain) {
         gain = 0x20;
         break;
     }
-    lsm.writeReg(CTRL2, gain);
+    _lsm303().writeReg(CTRL2, gain);
 
     // 0x57 = 0b01010111
     // AODR = 0101 (50 Hz ODR); AZEN = AYEN = AXEN = 1 (all axes enabled)
-    lsm.writeReg(CTRL1, 0x57);
+    _lsm303().writeReg(CTRL1, 0x57);
   }
   else // LSM303 DLHC (Breakout Space Kit variant)
   {
@@ -234,11 +504,11 @@ void _lsm303_accel_config(lsm303_accel_gain_e gGain) {
         gain = 0x38;
         break;
     }
-    lsm.writeAccReg(CTRL_REG4_A, gain);
+    _lsm303().writeAccReg(CTRL_REG4_A, gain);
 
     // 0x47 = 0b01000111
     // ODR = 0100 (50 Hz ODR); LPen = 0 (normal mode); Zen = Yen = Xen = 1 (all axes enabled)
-    lsm.writeAccReg(CTRL_REG1_A, 0x47);
+    _lsm303().writeAccReg(CTRL_REG1_A, 0x47);
   }
 }
 
@@ -248,10 +518,10 @@ void _lsm303_mag_config(lsm303_mag_scale_e gaussScale) {
   _lsm303_d_mag_config.scale = gaussScale;
 
   // LSM303 D (Spaceboard variant)
-  if (lsm.getDeviceType() == LSM303::device_D) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
     // 0x64 = 0b01100100
     // M_RES = 11 (high resolution mode); M_ODR = 001 (6.25 Hz ODR)
-    lsm.writeReg(CTRL5, 0x64);
+    _lsm303().writeReg(CTRL5, 0x64);
 
     // Adjustable gauss scale:
     //   MFS = 0b00000000 (+/-  2 gauss full scale) = 0x00
@@ -280,17 +550,17 @@ void _lsm303_mag_config(lsm303_mag_scale_e gaussScale) {
         scale = 0x60;
         break;
     }
-    lsm.writeReg(CTRL6, scale);
+    _lsm303().writeReg(CTRL6, scale);
 
     // 0x00 = 0b00000000
     // MLP = 0 (low power mode off); MD = 00 (continuous-conversion mode)
-    lsm.writeReg(CTRL7, 0x00);
+    _lsm303().writeReg(CTRL7, 0x00);
   }
   else // LSM303 DLHC (Breakout Space Kit variant)
   {
     // 0x0C = 0b00001100
     // DO = 011 (7.5 Hz ODR)
-    lsm.writeMagReg(CRA_REG_M, 0x0C);
+    _lsm303().writeMagReg(CRA_REG_M, 0x0C);
 
     // Adjustable gauss scale:
     //   MFS = 0b00100000 (+/- 1.3 gauss full scale) = 0x20
@@ -325,35 +595,68 @@ void _lsm303_mag_config(lsm303_mag_scale_e gaussScale) {
         scale = 0xE0;
         break;
     }
-    lsm.writeMagReg(CRB_REG_M, scale);
+    _lsm303().writeMagReg(CRB_REG_M, scale);
 
     // 0x00 = 0b00000000
     // MD = 00 (continuous-conversion mode)
-    lsm.writeMagReg(MR_REG_M, 0x00);
+    _lsm303().writeMagReg(MR_REG_M, 0x00);
   }
 }
 
+/*
+ * Checks the bus scan found an LSM303D (accelerometer and magnetometer at one
+ * address) or the accelerometer of an LSM303DLHC
+ */
+static boolean _lsm303_present(void) {
+  return ArdusatBus.present(DRIVER_LSM303_D_SA0_HIGH_ADDR) ||
+    ArdusatBus.present(DRIVER_LSM303_ADDR) ||
+    ArdusatBus.present(DRIVER_LSM303_DLHC_ACCEL_ADDR);
+}
+
 boolean lsm303_accel_init(lsm303_accel_gain_e gain) {
-  Wire.begin();
-  lsm.init();
+  ArdusatBus.begin();
+  if (!_lsm303_present()) {
+    return false;
+  }
+  _lsm303().setTimeout((ArdusatBus.timeout() + 999) / 1000);
+  _lsm303().init();
   _lsm303_accel_config(gain);
   return true;
 }
 
 boolean lsm303_mag_init(lsm303_mag_scale_e scale) {
-  Wire.begin();
-  lsm.init();
+  ArdusatBus.begin();
+  if (!_lsm303_present()) {
+    return false;
+  }
+  _lsm303().setTimeout((ArdusatBus.timeout() + 999) / 1000);
+  _lsm303().init();
   _lsm303_mag_config(scale);
   return true;
 }
 
 void lsm303_getAccel(float *x, float *y, float *z)
 {
-  float sensitivity;
+  float scale = lsm303_getAccelScale();
+
+  _lsm303_readAcc();
 
-  lsm.readAcc();
+  *x = _lsm303().a.x * scale;
+  *y = _lsm303().a.y * scale;
+  *z = _lsm303().a.z * scale;
+}
+
+/**
+ * Gets the scale that converts raw LSM303 accelerations to m/s^2 for the gain set
+ * in lsm303_accel_init.
+ *
+ * @return m/s^2 per raw count
+ */
+float lsm303_getAccelScale()
+{
+  float sensitivity;
 
-  if (lsm.getDeviceType() == LSM303::device_D) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
     switch(_lsm303_d_accel_config.gain) {
         case LSM303_ACCEL_GAIN2G:
             sensitivity = 0.061;
@@ -371,9 +674,7 @@ void lsm303_getAccel(float *x, float *y, float *z)
             sensitivity = 0.732;
             break;
     }
-    *x = lsm.a.x * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
-    *y = lsm.a.y * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
-    *z = lsm.a.z * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
+    return sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
   } else {
     switch(_lsm303_d_accel_config.gain) {
         case LSM303_ACCEL_GAIN2G:
@@ -389,10 +690,8 @@ void lsm303_getAccel(float *x, float *y, float *z)
             sensitivity = 12.0;
             break;
     }
-    // need to right shift 4 b/c we've got 12 bit resolution, left-justified
-    *x = (lsm.a.x >> 4) * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
-    *y = (lsm.a.y >> 4) * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
-    *z = (lsm.a.z >> 4) * sensitivity / 1000 * SENSORS_GRAVITY_STANDARD;
+    // divide by 16 b/c we've got 12 bit resolution, left-justified
+    return sensitivity / 16 / 1000 * SENSORS_GRAVITY_STANDARD;
   }
 }
 
@@ -406,10 +705,10 @@ void lsm303_getAccel(float *x, float *y, float *z)
 void lsm303_getRawAcceleration(int16_t *pX, int16_t *pY, int16_t *pZ)
 {
   if((NULL != pX) && (NULL != pY) && (NULL != pZ)) {
-    lsm.readAcc();
-    *pX = lsm.a.x;
-    *pY = lsm.a.y;
-    *pZ = lsm.a.z;
+    _lsm303_readAcc();
+    *pX = _lsm303().a.x;
+    *pY = _lsm303().a.y;
+    *pZ = _lsm303().a.z;
   }
 }
 
@@ -424,25 +723,139 @@ void lsm303_getRawTemperature(int16_t *pRawTemperature)
   uint8_t raw_temp[2];
 
   if(NULL != pRawTemperature) {
-    if (lsm.getDeviceType() == LSM303::device_D) {
-      raw_temp[0] = lsm.readReg(TEMP_OUT_L);
-      raw_temp[1] = lsm.readReg(TEMP_OUT_H);
+    if (_lsm303().getDeviceType() == LSM303::device_D) {
+      raw_temp[0] = _lsm303().readReg(TEMP_OUT_L);
+      raw_temp[1] = _lsm303().readReg(TEMP_OUT_H);
       *pRawTemperature = raw_temp[0] | (raw_temp[1] << 8);
     } else {
-      raw_temp[0] = lsm.readMagReg(TEMP_OUT_L_M);
-      raw_temp[1] = lsm.readMagReg(TEMP_OUT_H_M);
+      raw_temp[0] = _lsm303().readMagReg(TEMP_OUT_L_M);
+      raw_temp[1] = _lsm303().readMagReg(TEMP_OUT_H_M);
       *pRawTemperature = (raw_temp[0] | (raw_temp[1] << 8)) >> 4;
     }
   }
 }
 
+/**
+ * Enables or disables the LSM303 accelerometer FIFO in stream mode. While the FIFO
+ * is enabled the output registers return the oldest stored sample, so samples
+ * should be read with lsm303_accel_readFifo.
+ *
+ * @param enable true for stream mode, false for bypass mode (single samples)
+ *
+ * @return true on success, false if the LSM303 variant doesn't have a FIFO
+ */
+boolean lsm303_accel_setFifo(boolean enable) {
+  uint8_t ctrlReg;
+  uint8_t fifoCtrlReg;
+  uint8_t fifoCtrl;
+  uint8_t ctrl;
+
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
+    ctrlReg = CTRL0;
+    fifoCtrlReg = FIFO_CTRL;
+    fifoCtrl = enable ? 0x40 : 0x00; // FM2-0: 010 stream, 000 bypass
+  } else if (_lsm303().getDeviceType() == LSM303::device_DLHC) {
+    ctrlReg = CTRL_REG5_A;
+    fifoCtrlReg = FIFO_CTRL_REG_A;
+    fifoCtrl = enable ? 0x80 : 0x00; // FM1-0: 10 stream, 00 bypass
+  } else {
+    return false;
+  }
+
+  // FIFO_EN
+  ctrl = _lsm303().readAccReg(ctrlReg);
+  ctrl = enable ? (ctrl | 0x40) : (ctrl & ~0x40);
+  _lsm303().writeAccReg(ctrlReg, ctrl);
+  if (_lsm303().last_status != 0) {
+    return false;
+  }
+
+  _lsm303().writeAccReg(fifoCtrlReg, fifoCtrl);
+  return _lsm303().last_status == 0;
+}
+
+/**
+ * Reads the raw accelerations stored in the LSM303 FIFO, oldest first. The FIFO
+ * must have been enabled with lsm303_accel_setFifo.
+ *
+ * @param samples array to store samples in
+ * @param maxSamples maximum number of samples to read
+ *
+ * @return number of samples read
+ */
+uint8_t lsm303_accel_readFifo(raw_xyz_t *samples, uint8_t maxSamples) {
+  uint8_t fifoSrc;
+
+  if (samples == NULL) {
+    return 0;
+  }
+
+  fifoSrc = _lsm303().readAccReg(_lsm303().getDeviceType() == LSM303::device_D ? FIFO_SRC : FIFO_SRC_REG_A);
+  if (_lsm303().last_status != 0) {
+    return 0;
+  }
+
+  // assert the MSB of the address to get subaddress updating
+  return _fifo_drain(_lsm303().getAccAddress(), OUT_X_L_A | (1 << 7),
+                     _fifo_level(fifoSrc), samples, maxSamples);
+}
+
+/*
+ * Sets or clears bits in an LSM303 accelerometer register
+ */
+static boolean _lsm303_updateAccReg(uint8_t reg, uint8_t bits, boolean set) {
+  uint8_t value = _lsm303().readAccReg(reg);
+
+  if (_lsm303().last_status != 0) {
+    return false;
+  }
+
+  _lsm303().writeAccReg(reg, set ? (value | bits) : (value & ~bits));
+  return _lsm303().last_status == 0;
+}
+
+/**
+ * Turns the LSM303 accelerometer data-ready signal on INT1 on or off. The pin
+ * goes high when a new sample is ready and low once it's read.
+ *
+ * @param enable true to signal new samples on the pin
+ *
+ * @return true if set
+ */
+boolean lsm303_accel_setDataReady(boolean enable) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
+    // INT1_DRDY_A, and IEA for active high interrupts. The D has a single
+    // address, so its magnetometer registers are written the same way.
+    return (!enable || _lsm303_updateAccReg(INT_CTRL_M, 0x08, true)) &&
+      _lsm303_updateAccReg(CTRL3, 0x04, enable);
+  }
+
+  // I1_DRDY1 (DLHC interrupts are active high by default)
+  return _lsm303_updateAccReg(CTRL_REG3_A, 0x10, enable);
+}
+
 void lsm303_getMag(float *x, float *y, float *z)
 {
-  float sensitivity, z_sensitivity;
+  float scale = lsm303_getMagScale();
+
+  _lsm303_readMag();
+
+  *x = _lsm303().m.x * scale;
+  *y = _lsm303().m.y * scale;
+  *z = _lsm303().m.z * scale;
+}
 
-  lsm.readMag();
+/**
+ * Gets the scale that converts raw LSM303 magnetometer readings to uT for the
+ * scale set in lsm303_mag_init.
+ *
+ * @return uT per raw count
+ */
+float lsm303_getMagScale()
+{
+  float sensitivity;
 
-  if (lsm.getDeviceType() == LSM303::device_D) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
     switch(_lsm303_d_mag_config.scale) {
         case LSM303_MAG_SCALE2GAUSS:
             sensitivity = 0.080;
@@ -457,43 +870,34 @@ void lsm303_getMag(float *x, float *y, float *z)
             sensitivity = 0.479;
             break;
     }
-    *x = lsm.m.x * sensitivity * SENSORS_MGAUSS_TO_UTESLA;
-    *y = lsm.m.y * sensitivity * SENSORS_MGAUSS_TO_UTESLA;
-    *z = lsm.m.z * sensitivity * SENSORS_MGAUSS_TO_UTESLA;
+    return sensitivity * SENSORS_MGAUSS_TO_UTESLA;
   } else {
+    // NOTE: The DLHC's z axis sensitivity is slightly lower (e.g. 400 vs 450
+    //       LSB/gauss at 4 gauss), but all axes have always been scaled the same
     switch(_lsm303_d_mag_config.scale) {
         case LSM303_MAG_SCALE1_3GAUSS:
             sensitivity = 1100;
-            z_sensitivity = 980;
             break;
         case LSM303_MAG_SCALE2GAUSS:
             sensitivity = 855;
-            z_sensitivity = 760;
             break;
         case LSM303_MAG_SCALE2_5GAUSS:
             sensitivity = 670;
-            z_sensitivity = 600;
             break;
         case LSM303_MAG_SCALE4GAUSS:
             sensitivity = 450;
-            z_sensitivity = 400;
             break;
         case LSM303_MAG_SCALE4_7GAUSS:
             sensitivity = 400;
-            z_sensitivity = 355;
             break;
         case LSM303_MAG_SCALE5_6GAUSS:
             sensitivity = 330;
-            z_sensitivity = 295;
             break;
         case LSM303_MAG_SCALE8GAUSS:
             sensitivity = 230;
-            z_sensitivity = 205;
             break;
     }
-    *x = lsm.m.x / sensitivity * SENSORS_GAUSS_TO_MICROTESLA;
-    *y = lsm.m.y / sensitivity * SENSORS_GAUSS_TO_MICROTESLA;
-    *z = lsm.m.z / sensitivity * SENSORS_GAUSS_TO_MICROTESLA;
+    return SENSORS_GAUSS_TO_MICROTESLA / sensitivity;
   }
 }
 
@@ -507,13 +911,31 @@ void lsm303_getMag(float *x, float *y, float *z)
 void lsm303_getRawMag(int16_t *pX, int16_t *pY, int16_t *pZ)
 {
   if((NULL != pX) && (NULL != pY) && (NULL != pZ)) {
-    lsm.readMag();
-    *pX = lsm.m.x;
-    *pY = lsm.m.y;
-    *pZ = lsm.m.z;
+    _lsm303_readMag();
+    *pX = _lsm303().m.x;
+    *pY = _lsm303().m.y;
+    *pZ = _lsm303().m.z;
   }
 }
 
+/**
+ * Turns the LSM303 magnetometer data-ready signal on or off. The LSM303D
+ * signals it on INT2; the DLHC has a DRDY pin that is always on.
+ *
+ * @param enable true to signal new samples on the pin
+ *
+ * @return true if set
+ */
+boolean lsm303_mag_setDataReady(boolean enable) {
+  if (_lsm303().getDeviceType() == LSM303::device_D) {
+    // INT2_DRDY_M, and IEA for active high interrupts
+    return (!enable || _lsm303_updateAccReg(INT_CTRL_M, 0x08, true)) &&
+      _lsm303_updateAccReg(CTRL4, 0x04, enable);
+  }
+
+  return true;
+}
+
 /*
  * BMP180 Barometeric Altimeter
  */
@@ -521,6 +943,13 @@ void lsm303_getRawMag(int16_t *pX, int16_t *pY, int16_t *pZ)
 static bmp085_calibration _bmp180_calibration;
 static uint8_t _bmp180_mode;
 
+// The temperature compensation (B5) is refreshed every _bmp180_temp_interval
+// pressure samples, or on the next sample when the last refresh moved it by
+// more than _bmp180_b5_threshold (0 to turn that off)
+static uint8_t _bmp180_temp_interval = 1;
+static int32_t _bmp180_b5_threshold = 0;
+static uint8_t _bmp180_samples_since_temp = 0xFF;
+
 /*
  * Reads the factory configuration from the BMP180
  */
@@ -575,9 +1004,10 @@ boolean bmp180_init(bmp085_mode_t mode)
 {
   uint8_t res;
 
-  Wire.begin();
+  ArdusatBus.begin();
 
-  if (readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CHIPID, &res, 1) ||
+  if (!ArdusatBus.present(DRIVER_BMP180_ADDR) ||
+      readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CHIPID, &res, 1) ||
       res != 0x55) {
     return false;
   }
@@ -587,9 +1017,99 @@ boolean bmp180_init(bmp085_mode_t mode)
   }
 
   _bmp180_mode = mode;
+  _bmp180_samples_since_temp = 0xFF;
   return true;
 }
 
+/*
+ * Returns the pressure conversion time in ms for the resolution mode set in begin
+ */
+static unsigned int _bmp180_pressure_delay(void)
+{
+  switch(_bmp180_mode) {
+    case BMP085_MODE_ULTRALOWPOWER:
+      return 5;
+    case BMP085_MODE_STANDARD:
+      return 8;
+    case BMP085_MODE_HIGHRES:
+      return 14;
+    case BMP085_MODE_ULTRAHIGHRES:
+    default:
+      return 26;
+  }
+}
+
+/*
+ * Reads the result of a temperature conversion started with bmp180_startTemperature
+ */
+static int _bmp180_read_raw_temperature(uint16_t *temp)
+{
+  uint8_t reg[2];
+
+  if (readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_TEMPDATA, reg, 2)) {
+    return -1;
+  }
+
+  *temp = (reg[0] << 8) + reg[1];
+  return 0;
+}
+
+/*
+ * Reads the result of a pressure conversion started with bmp180_startPressure
+ */
+static int _bmp180_read_raw_pressure(uint32_t *pressure)
+{
+  uint8_t reg[3];
+  uint32_t temp32;
+
+  if (readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_PRESSUREDATA, reg, 3)) {
+    return -1;
+  }
+
+  temp32 = (uint32_t) reg[0] << 16;
+  temp32 += reg[1] << 8;
+  temp32 += reg[2];
+  temp32 >>= (8 - _bmp180_mode);
+
+  *pressure = temp32;
+  return 0;
+}
+
+/*
+ * Applies the datasheet pressure compensation to a raw pressure reading
+ */
+static float _bmp180_compensate_pressure(int32_t b5, int32_t up)
+{
+  int32_t pressure_i = 0;
+  int32_t x1, x2, b6, x3, b3, p;
+  uint32_t b4, b7;
+
+  // Pressure compensation
+  b6 = b5 - 4000;
+  x1 = (_bmp180_calibration.b2 * ((b6 * b6) >> 12)) >> 11;
+  x2 = (_bmp180_calibration.ac2 * b6) >> 11;
+  x3 = x1 + x2;
+  b3 = (((((int32_t) _bmp180_calibration.ac1) * 4 + x3) << _bmp180_mode) + 2) >> 2;
+  x1 = (_bmp180_calibration.ac3 * b6) >> 13;
+  x2 = (_bmp180_calibration.b1 * ((b6 * b6) >> 12)) >> 16;
+  x3 = ((x1 + x2) + 2) >> 2;
+  b4 = (_bmp180_calibration.ac4 * (uint32_t) (x3 + 32768)) >> 15;
+  b7 = ((uint32_t) (up - b3) * (50000 >> _bmp180_mode));
+
+  if (b7 < 0x80000000) {
+    p = (b7 << 1) / b4;
+  } else {
+    p = (b7 / b4) << 1;
+  }
+
+  x1 = (p >> 8) * (p >> 8);
+  x1 = (x1 * 3038) >> 16;
+  x2 = (-7357 * p) >> 16;
+  pressure_i = p + ((x1 + x2 + 3791) >> 4);
+
+  return pressure_i / 100.0F;
+}
+
 /**
  * Gets raw 16 bit temperature from the BMP180. See datasheet for instructions on
  * calculating calibrated value.
@@ -598,19 +1118,14 @@ boolean bmp180_init(bmp085_mode_t mode)
  */
 void bmp180_getRawTemperature(uint16_t *temp)
 {
-  uint8_t reg[2];
-  reg[0] = BMP085_REGISTER_READTEMPCMD;
-  if (writeToRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CONTROL, reg, 1)) {
-    return;
-  }
+  unsigned int wait = bmp180_startTemperature();
 
-  delay(5);
-
-  if (readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_TEMPDATA, reg, 2)) {
+  if (wait == 0) {
     return;
   }
 
-  *temp = (reg[0] << 8) + reg[1];
+  delay(wait);
+  _bmp180_read_raw_temperature(temp);
 }
 
 /**
@@ -640,88 +1155,166 @@ void bmp180_getTemperature(float *temp)
  */
 void bmp180_getRawPressure(uint32_t *pressure)
 {
-  uint8_t reg[3];
-  uint32_t temp32;
-  reg[0] = BMP085_REGISTER_READPRESSURECMD + (_bmp180_mode << 6);
+  unsigned int wait = bmp180_startPressure();
 
-  if (writeToRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CONTROL, &reg, 1)) {
+  if (wait == 0) {
     return;
   }
 
-  // read delay is based on resolution mode set in begin
-  switch(_bmp180_mode) {
-    case BMP085_MODE_ULTRALOWPOWER:
-      delay(5);
-      break;
-    case BMP085_MODE_STANDARD:
-      delay(8);
-      break;
-    case BMP085_MODE_HIGHRES:
-      delay(14);
-      break;
-    case BMP085_MODE_ULTRAHIGHRES:
-    default:
-      delay(26);
-      break;
+  delay(wait);
+  _bmp180_read_raw_pressure(pressure);
+}
+
+/**
+ * Get calibrated pressure from BMP180.
+ *
+ * @param pressure location to write to
+ *
+ * @return true if the pressure was read, false if a conversion couldn't be
+ *         started or read
+ */
+boolean bmp180_getPressure(float *pressure) {
+  unsigned int wait;
+
+  if (bmp180_temperatureDue()) {
+    wait = bmp180_startTemperature();
+    if (wait == 0) {
+      return false;
+    }
+    delay(wait);
+    if (!bmp180_finishTemperature()) {
+      return false;
+    }
   }
 
-  if (readFromRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_PRESSUREDATA, reg, 3)) {
-    return;
+  wait = bmp180_startPressure();
+  if (wait == 0) {
+    return false;
   }
+  delay(wait);
+  return bmp180_finishPressure(pressure);
+}
 
-  temp32 = (uint32_t) reg[0] << 16;
-  temp32 += reg[1] << 8;
-  temp32 += reg[2];
-  temp32 >>= (8 - _bmp180_mode);
+/*
+ * Split-phase BMP180 reads. A full pressure reading is:
+ *
+ *   wait = bmp180_startTemperature();   // ...come back after `wait` ms
+ *   bmp180_finishTemperature();
+ *   wait = bmp180_startPressure();      // ...come back after `wait` ms
+ *   bmp180_finishPressure(&pressure);
+ *
+ * The temperature compensation coefficient (B5) is kept between calls, so the
+ * temperature steps can be skipped while bmp180_temperatureDue() is false.
+ */
+static int32_t _bmp180_b5;
 
-  *pressure = temp32;
+/**
+ * Sets how often pressure readings refresh the temperature compensation. Each
+ * refresh costs a 5 ms temperature conversion.
+ *
+ * @param samples pressure samples per temperature conversion (1 for every sample)
+ * @param threshold temperature change in degrees C between two refreshes that
+ *        makes the next sample refresh too, 0 to only use samples
+ */
+void bmp180_setTemperatureRefresh(uint8_t samples, float threshold)
+{
+  _bmp180_temp_interval = samples ? samples : 1;
+
+  // B5 is in 1/16ths of 0.1 degrees C
+  _bmp180_b5_threshold = (int32_t) (threshold * 160);
 }
 
 /**
- * Get calibrated pressure from BMP180.
+ * @return true if the next pressure reading needs a temperature conversion first
+ */
+boolean bmp180_temperatureDue(void)
+{
+  return _bmp180_samples_since_temp >= _bmp180_temp_interval;
+}
+
+/**
+ * Starts a temperature conversion on the BMP180
  *
- * @param pressure location to write to
+ * @return ms until the conversion is done, or 0 if it could not be started
  */
-void bmp180_getPressure(float *pressure) {
-  int32_t ut = 0;
-  int32_t up = 0;
-  int32_t pressure_i = 0;
-  int32_t x1, x2, b5, b6, x3, b3, p;
-  uint32_t b4, b7;
-  uint16_t raw_temp;
+unsigned int bmp180_startTemperature(void)
+{
+  uint8_t cmd = BMP085_REGISTER_READTEMPCMD;
 
-  bmp180_getRawTemperature(&raw_temp);
-  ut = (int32_t) raw_temp;
-  bmp180_getRawPressure((uint32_t *) &up);
-  up = (int32_t) up;
+  if (writeToRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CONTROL, &cmd, 1)) {
+    return 0;
+  }
 
-  // Temp compensation
-  b5 = _bmp180_compute_b5(ut);
+  return 5;
+}
 
-  // Pressure compensation
-  b6 = b5 - 4000;
-  x1 = (_bmp180_calibration.b2 * ((b6 * b6) >> 12)) >> 11;
-  x2 = (_bmp180_calibration.ac2 * b6) >> 11;
-  x3 = x1 + x2;
-  b3 = (((((int32_t) _bmp180_calibration.ac1) * 4 + x3) << _bmp180_mode) + 2) >> 2;
-  x1 = (_bmp180_calibration.ac3 * b6) >> 13;
-  x2 = (_bmp180_calibration.b1 * ((b6 * b6) >> 12)) >> 16;
-  x3 = ((x1 + x2) + 2) >> 2;
-  b4 = (_bmp180_calibration.ac4 * (uint32_t) (x3 + 32768)) >> 15;
-  b7 = ((uint32_t) (up - b3) * (50000 >> _bmp180_mode));
+/**
+ * Reads a temperature conversion started with bmp180_startTemperature and
+ * updates the temperature compensation used for the following pressure reads.
+ *
+ * @return true if the conversion was read successfully
+ */
+boolean bmp180_finishTemperature(void)
+{
+  uint16_t raw_temp;
 
-  if (b7 < 0x80000000) {
-    p = (b7 << 1) / b4;
+  if (_bmp180_read_raw_temperature(&raw_temp)) {
+    return false;
+  }
+
+  int32_t b5 = _bmp180_compute_b5((int32_t) raw_temp);
+  int32_t change = b5 - _bmp180_b5;
+
+  // Temperature is changing quickly, so refresh it on the next sample as well
+  if (_bmp180_samples_since_temp != 0xFF && _bmp180_b5_threshold > 0 &&
+      (change > _bmp180_b5_threshold || -change > _bmp180_b5_threshold)) {
+    _bmp180_samples_since_temp = _bmp180_temp_interval - 1;
   } else {
-    p = (b7 / b4) << 1;
+    _bmp180_samples_since_temp = 0;
   }
 
-  x1 = (p >> 8) * (p >> 8);
-  x1 = (x1 * 3038) >> 16;
-  x2 = (-7357 * p) >> 16;
-  pressure_i = p + ((x1 + x2 + 3791) >> 4);
+  _bmp180_b5 = b5;
+  return true;
+}
+
+/**
+ * Starts a pressure conversion on the BMP180 using the mode set in bmp180_init
+ *
+ * @return ms until the conversion is done, or 0 if it could not be started
+ */
+unsigned int bmp180_startPressure(void)
+{
+  uint8_t cmd = BMP085_REGISTER_READPRESSURECMD + (_bmp180_mode << 6);
 
-  *pressure = pressure_i / 100.0F;
+  if (writeToRegAddr(DRIVER_BMP180_ADDR, BMP085_REGISTER_CONTROL, &cmd, 1)) {
+    return 0;
+  }
+
+  return _bmp180_pressure_delay();
+}
+
+/**
+ * Reads a pressure conversion started with bmp180_startPressure and applies
+ * the temperature compensation from the last bmp180_finishTemperature.
+ *
+ * @param pressure location to write the calibrated pressure (hPa) to
+ *
+ * @return true if the conversion was read successfully
+ */
+boolean bmp180_finishPressure(float *pressure)
+{
+  uint32_t up = 0;
+
+  if (_bmp180_read_raw_pressure(&up)) {
+    return false;
+  }
+
+  *pressure = _bmp180_compensate_pressure(_bmp180_b5, (int32_t) up);
+
+  if (_bmp180_samples_since_temp < 0xFF) {
+    _bmp180_samples_since_temp++;
+  }
+  return true;
 }
 
 /*
@@ -755,17 +1348,20 @@ float map_float(float x, float in_min, float in_max, float out_min, float out_ma
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
+static ML8511_ADC & _ml8511() {
+  static ML8511_ADC device(DRIVER_ML8511_ADDR);
+  return device;
+}
+
 /**
  * Inits the ML8511 breakout board UV sensor
  *
  * @return true
  */
-ML8511_ADC ml8511_uv_adc = ML8511_ADC(DRIVER_ML8511_ADDR);
-
 boolean ml8511_init()
 {
-  if (ARDUSAT_SPACEBOARD) {
-    return ml8511_uv_adc.init();
+  if (BOARD_IS_SPACEBOARD()) {
+    return ArdusatBus.present(DRIVER_ML8511_ADDR) && _ml8511().init();
   } else {
     pinMode(DRIVER_ML8511_UV_PIN, INPUT);
     pinMode(DRIVER_ML8511_REF_PIN, INPUT);
@@ -786,8 +1382,8 @@ boolean ml8511_init()
 float ml8511_getUV(int pin)
 {
   float scaled_uv_v;
-  if (ARDUSAT_SPACEBOARD) {
-    scaled_uv_v = ml8511_uv_adc.read_uv();
+  if (BOARD_IS_SPACEBOARD()) {
+    scaled_uv_v = _ml8511().read_uv();
   } else {
     int uv_v = average_analog_read(pin);
     int ref_v = average_analog_read(DRIVER_ML8511_REF_PIN);
@@ -800,12 +1396,12 @@ float ml8511_getUV(int pin)
 /*
  * MLX90614 IR Temperature
  */
-float _mlx90614_readTemp(uint8_t reg) {
+float _mlx90614_readTemp(uint8_t addr, uint8_t reg) {
   uint32_t data;
 
   // Reads 3 bytes, but the third byte is a Packet Error Code (PEC)
   // and is unused.
-  readFromRegAddr(DRIVER_MLX90614_ADDR, reg, &data, 3, LITTLE_ENDIAN);
+  readFromRegAddr(addr, reg, &data, 3, LITTLE_ENDIAN);
   float temp = (data & 0xFFFF); // Get rid of PEC byte from read
 
   temp *= .02;
@@ -813,52 +1409,58 @@ float _mlx90614_readTemp(uint8_t reg) {
   return temp;
 }
 
-float _mlx90614_readObjectTempF(void) {
-  return (_mlx90614_readTemp(MLX90614_TOBJ1) * 9 / 5) + 32;
+float _mlx90614_readObjectTempF(uint8_t addr) {
+  return (_mlx90614_readTemp(addr, MLX90614_TOBJ1) * 9 / 5) + 32;
 }
 
-float _mlx90614_readAmbientTempF(void) {
-  return (_mlx90614_readTemp(MLX90614_TA) * 9 / 5) + 32;
+float _mlx90614_readAmbientTempF(uint8_t addr) {
+  return (_mlx90614_readTemp(addr, MLX90614_TA) * 9 / 5) + 32;
 }
 
-float _mlx90614_readObjectTempC(void) {
-  return _mlx90614_readTemp(MLX90614_TOBJ1);
+float _mlx90614_readObjectTempC(uint8_t addr) {
+  return _mlx90614_readTemp(addr, MLX90614_TOBJ1);
 }
 
-float _mlx90614_readAmbientTempC(void) {
-  return _mlx90614_readTemp(MLX90614_TA);
+float _mlx90614_readAmbientTempC(uint8_t addr) {
+  return _mlx90614_readTemp(addr, MLX90614_TA);
 }
 
-boolean mlx90614_init() {
-  Wire.begin();
-  return true;
+/**
+ * @param addr SMBus address, or 0 for the factory default
+ */
+boolean mlx90614_init(uint8_t addr) {
+  // The MLX90614 is an SMBus device, rated for 100 kHz at most
+  ArdusatBus.setDeviceClock(addr ? addr : DRIVER_MLX90614_ADDR, BUS_CLOCK_STANDARD);
+  ArdusatBus.begin();
+  return ArdusatBus.present(addr ? addr : DRIVER_MLX90614_ADDR);
 }
 
-float mlx90614_getTempCelsius() {
-  return _mlx90614_readObjectTempC();
+float mlx90614_getTempCelsius(uint8_t addr) {
+  return _mlx90614_readObjectTempC(addr ? addr : DRIVER_MLX90614_ADDR);
 }
 
 /*
  * TMP102 Temperature
  */
-boolean tmp102_init() {
-  Wire.begin();
-  return true;
+
+/**
+ * @param addr I2C address, or 0 for the board's default
+ */
+boolean tmp102_init(uint8_t addr) {
+  ArdusatBus.begin();
+  return ArdusatBus.present(addr ? addr : BOARD_TMP102_ADDR);
 }
 
-float tmp102_getTempCelsius() {
+/**
+ * @param addr I2C address, or 0 for the board's default
+ */
+float tmp102_getTempCelsius(uint8_t addr) {
   int16_t val;
   uint8_t * bytes = (uint8_t *) &val;
   uint8_t temp_byte;
   float tmp;
 
-  if (ARDUSAT_SPACEBOARD) {
-    temp_byte = DRIVER_SPACEBOARD_TMP102_ADDR;
-  } else {
-    temp_byte = DRIVER_TMP102_ADDR;
-  }
-
-  readFromRegAddr(temp_byte, 0x00, bytes, 2);
+  readFromRegAddr(addr ? addr : BOARD_TMP102_ADDR, 0x00, bytes, 2);
   temp_byte = bytes[0];
   bytes[0] = bytes[1];
   bytes[1] = temp_byte;
@@ -869,94 +1471,210 @@ float tmp102_getTempCelsius() {
 
 /*
  * TSL2561 Luminosity
+ *
+ * Each Luminosity owns its TSL2561, so several can be read side by side (at
+ * different addresses, or on different mux channels).
  */
-TSL2561 *tsl2561;
 
-boolean tsl2561_init(tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain) {
-  uint8_t addr;
-  if (!tsl2561) {
-    if (ARDUSAT_SPACEBOARD) {
-      addr = DRIVER_SPACEBOARD_TSL2561_ADDR;
-    } else {
-      addr = DRIVER_TSL2561_ADDR;
-    }
-    tsl2561 = new TSL2561(addr);
-  }
-  boolean result = tsl2561->begin();
+/**
+ * @param device driver state for this sensor
+ * @param addr I2C address, or 0 for the board's default (known once the board
+ *        has been detected)
+ */
+boolean tsl2561_init(TSL2561 & device, uint8_t addr, tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain) {
+  device.setAddress(addr ? addr : BOARD_TSL2561_ADDR);
+  boolean result = ArdusatBus.present(addr ? addr : BOARD_TSL2561_ADDR) && device.begin();
 
   if(result)
   {
-    tsl2561->setIntegrationTime(intTime);
-    tsl2561->setGain(gain);
-    tsl2561->enableAutoRange(true);
+    device.setIntegrationTime(intTime);
+    device.setGain(gain);
+    device.enableAutoRange(true);
   }
 
   return result;
 }
 
-float tsl2561_getLux() {
-  uint16_t broadband, ir;
+/**
+ * Reads the lux in a single integration. Auto-range picks the range of the
+ * next reading from this one.
+ */
+float tsl2561_getLux(TSL2561 & device) {
+  return device.getLux();
+}
+
+/**
+ * @param intTime location to write the integration time of the last reading to
+ * @param gain location to write the gain of the last reading to
+ */
+void tsl2561_getRange(TSL2561 & device, tsl2561IntegrationTime_t *intTime, tsl2561Gain_t *gain) {
+  device.getLastRange(intTime, gain);
+}
+
+/**
+ * Keeps the TSL2561 powered and integrating, so readings don't wait for an
+ * integration cycle, or goes back to powering it up for each reading
+ */
+void tsl2561_setContinuous(TSL2561 & device, boolean continuous) {
+  device.setContinuous(continuous);
+}
+
+/**
+ * Powers up the TSL2561 and starts an integration cycle (unless it's already
+ * integrating continuously)
+ *
+ * @return ms until tsl2561_finishLux can be called
+ */
+unsigned int tsl2561_startLux(TSL2561 & device) {
+  device.startIntegration();
+  return device.readyIn();
+}
 
-  tsl2561->getLuminosity(&broadband, &ir);
-  return tsl2561->calculateLux(broadband, ir);
+/**
+ * Reads an integration cycle started with tsl2561_startLux
+ *
+ * @param lux location to write the calculated lux to
+ *
+ * @return 0; every integration gives a reading, and auto-range applies from
+ *         the next one
+ */
+unsigned int tsl2561_finishLux(TSL2561 & device, float *lux) {
+  *lux = device.finishLux();
+  return 0;
 }
 
 
 /*
  * ISL29125 RGB Light Sensor
  */
-SFE_ISL29125 isl29125 = SFE_ISL29125(DRIVER_SPACEBOARD_ISL29125_ADDR);
+static SFE_ISL29125 & _isl29125() {
+  static SFE_ISL29125 device(DRIVER_SPACEBOARD_ISL29125_ADDR);
+  return device;
+}
 
 // intensity == CFG1_375LUX if dark
 //              CFG1_10KLUX if bright (default)
 boolean isl29125_init(uint8_t intensity) {
-  boolean initialized = isl29125.init();
+  boolean initialized = ArdusatBus.present(DRIVER_SPACEBOARD_ISL29125_ADDR) && _isl29125().init();
   if (initialized && (intensity == CFG1_375LUX || intensity == CFG1_10KLUX)) {
-    initialized = isl29125.config(CFG1_MODE_RGB | intensity, CFG2_IR_ADJUST_HIGH, CFG_DEFAULT);
+    initialized = _isl29125().config(CFG1_MODE_RGB | intensity, CFG2_IR_ADJUST_HIGH, CFG_DEFAULT);
   }
   return initialized;
 }
 
 void isl29125_getRGB(float *red, float *green, float *blue) {
-  *red = isl29125.readRed();
-  *green = isl29125.readGreen();
-  *blue = isl29125.readBlue();
+  uint16_t r, g, b;
+
+  if (_isl29125().readRGB(&r, &g, &b)) {
+    *red = r;
+    *green = g;
+    *blue = b;
+  }
 }
 
 
 /*
  * TCS34725 RGB Light Sensor
+ *
+ * Each RGBLight owns its TCS34725. It only has the one address, so more than
+ * one need a mux.
  */
-Adafruit_TCS34725 tcs34725 = Adafruit_TCS34725();
-
-boolean tcs34725_init(tcs34725IntegrationTime_t it, tcs34725Gain_t gain) {
-  boolean init = tcs34725.begin();
-  tcs34725.setIntegrationTime(it);
-  tcs34725.setGain(gain);
+boolean tcs34725_init(Adafruit_TCS34725 & device, tcs34725IntegrationTime_t it, tcs34725Gain_t gain) {
+  boolean init = ArdusatBus.present(TCS34725_ADDRESS) && device.begin();
+  device.setIntegrationTime(it);
+  device.setGain(gain);
   return init;
 }
 
-void tcs34725_getRGB(float *red, float *green, float *blue) {
-  uint16_t r, g, b, clear;
+/*
+ * Scales raw counts to the configured integration time and gain, so readings
+ * keep the same units whatever range auto-range took them at
+ */
+static void _tcs34725_scale(Adafruit_TCS34725 & device, uint16_t r, uint16_t g, uint16_t b,
+                            float *red, float *green, float *blue) {
+  float scale = device.lastRangeScale();
 
-  tcs34725.getRawData(&r, &g, &b, &clear);
-  *red = r;
-  *green = g;
-  *blue = b;
+  *red = r * scale;
+  *green = g * scale;
+  *blue = b * scale;
+}
+
+void tcs34725_getRGB(Adafruit_TCS34725 & device, float *red, float *green, float *blue) {
+  uint16_t r = 0, g = 0, b = 0, clear = 0;
+
+  device.getRawData(&r, &g, &b, &clear);
+  _tcs34725_scale(device, r, g, b, red, green, blue);
+}
+
+/**
+ * Chooses the gain and integration time of each TCS34725 integration from the
+ * one before it, never integrating for longer than the configured time.
+ * Readings are still scaled to the configured range.
+ */
+void tcs34725_setAutoRange(Adafruit_TCS34725 & device, boolean enable) {
+  device.enableAutoRange(enable);
+}
+
+/**
+ * @param it location to write the integration time of the last reading to
+ * @param gain location to write the gain of the last reading to
+ */
+void tcs34725_getRange(Adafruit_TCS34725 & device, tcs34725IntegrationTime_t *it, tcs34725Gain_t *gain) {
+  device.getLastRange(it, gain);
+}
+
+/**
+ * Keeps the TCS34725 powered and integrating (the default), or powers it up
+ * only for each reading
+ */
+void tcs34725_setContinuous(Adafruit_TCS34725 & device, boolean continuous) {
+  device.setContinuous(continuous);
+}
+
+/**
+ * Powers up the TCS34725 for a reading in low power mode; does nothing in
+ * continuous mode
+ *
+ * @return ms until tcs34725_finishRGB can be called
+ */
+unsigned int tcs34725_startRGB(Adafruit_TCS34725 & device) {
+  device.startIntegration();
+  return device.isContinuous() ? 0 : device.integrationDelay();
+}
+
+/**
+ * Reads the last completed integration cycle from the TCS34725 without waiting
+ *
+ * @return 0 if the values were written, otherwise no integration cycle has
+ *         completed yet; call again after the returned number of ms
+ */
+unsigned int tcs34725_finishRGB(Adafruit_TCS34725 & device, float *red, float *green, float *blue) {
+  uint16_t r = 0, g = 0, b = 0, clear = 0;
+
+  if (!device.dataReady()) {
+    return 1;
+  }
+
+  device.finishIntegration(&r, &g, &b, &clear);
+  _tcs34725_scale(device, r, g, b, red, green, blue);
+  return 0;
 }
 
 
 /*
  * SI1132 UV Light Sensor
  */
-Adafruit_SI1145 si1132_uv = Adafruit_SI1145();
+static Adafruit_SI1145 & _si1132() {
+  static Adafruit_SI1145 device;
+  return device;
+}
 
 boolean si1132_init() {
-  return si1132_uv.begin();
+  return ArdusatBus.present(DRIVER_SI1132_ADDR) && _si1132().begin();
 }
 
 float si1132_getUVIndex() {
-  float UVindex = si1132_uv.readUV();
+  float UVindex = _si1132().readUV();
 
   // the index is multiplied by 100 so to get the integer index, divide by 100
   UVindex /= 100.0;
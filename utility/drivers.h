@@ -23,6 +23,7 @@
 #include <utility/TSL2561.h>
 #include <utility/common_utils.h>
 #include <utility/pololu_LSM303.h>
+#include <utility/config.h>
 
 
 /**
@@ -48,11 +49,17 @@
 #define DRIVER_ML8511_REF_PIN           A1
 #define DRIVER_ML8511_ADDR              0x51  /* Lapis UV light sensor through LTC2451 */
 #define DRIVER_LSM303_ADDR              0x1E  /* ST 3-axis accelerometer & magnetometer */
+#define DRIVER_LSM303_D_SA0_HIGH_ADDR   0x1D  /* LSM303D with SA0 pulled high */
+#define DRIVER_LSM303_DLHC_ACCEL_ADDR   0x19  /* LSM303DLHC accelerometer (magnetometer at 0x1E) */
 //#define DRIVER_L3GD20_ADDR            0x6B  /* ST 3-axis digital gyroscope (Already defined by 'L3GD20_ADDRESS') */
 #define DRIVER_TMP102_ADDR              0x48  /* Texas Instrument Temperature */
 #define DRIVER_BMP180_ADDR              0x77  /* Barometric Pressure (Not available on Spaceboard) */
 #define DRIVER_SI1132_ADDR              0x60  /* Ultraviolet Index and Ambient light sensor */
 
+/* Addresses that depend on the board, see utility/config.h */
+#define BOARD_TSL2561_ADDR (BOARD_IS_SPACEBOARD() ? DRIVER_SPACEBOARD_TSL2561_ADDR : DRIVER_TSL2561_ADDR)
+#define BOARD_TMP102_ADDR  (BOARD_IS_SPACEBOARD() ? DRIVER_SPACEBOARD_TMP102_ADDR : DRIVER_TMP102_ADDR)
+
 
 /* Constants */
 #define SENSORS_GRAVITY_EARTH           (9.80665F)              /* Earth's gravity in m/s^2 */
@@ -104,24 +111,41 @@ typedef struct {
   lsm303_mag_scale_e scale;
 } config_lsm303_mag_t;
 
+/**
+ * One raw 3-axis sample, as read from the L3GD20H and LSM303 accelerometer FIFOs
+ */
 typedef struct {
-  float sensitivity;
-} config_l3gd20_t;
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} raw_xyz_t;
+#define DRIVER_FIFO_DEPTH 32  /* Samples held by the L3GD20H and LSM303 FIFOs */
 
 void catchSpaceboard();
+boolean detectBoard(boolean useCache);
 
-boolean l3gd20h_init(uint8_t range);
-void l3gd20h_getOrientation(float *x, float *y, float *z);
-void l3gd20h_getRawAngularRates(int16_t *pX, int16_t *pY, int16_t *pZ);
-void l3gd20h_getRawTemperature(int8_t *pRawTemperature);
+boolean l3gd20h_init(uint8_t addr, uint8_t range);
+void l3gd20h_getOrientation(uint8_t addr, uint8_t range, float *x, float *y, float *z);
+float l3gd20h_getScale(uint8_t range);
+void l3gd20h_getRawAngularRates(uint8_t addr, int16_t *pX, int16_t *pY, int16_t *pZ);
+void l3gd20h_getRawTemperature(uint8_t addr, int8_t *pRawTemperature);
+boolean l3gd20h_setFifo(uint8_t addr, boolean enable);
+uint8_t l3gd20h_readFifo(uint8_t addr, raw_xyz_t *samples, uint8_t maxSamples);
+boolean l3gd20h_setDataReady(uint8_t addr, boolean enable);
 
 boolean lsm303_accel_init(lsm303_accel_gain_e gain);
 boolean lsm303_mag_init(lsm303_mag_scale_e scale);
 void lsm303_getAccel(float * x, float * y, float * z);
+float lsm303_getAccelScale();
 void lsm303_getRawAcceleration(int16_t *pX, int16_t *pY, int16_t *pZ);
 void lsm303_getRawTemperature(int16_t *pRawTemperature);
+boolean lsm303_accel_setFifo(boolean enable);
+uint8_t lsm303_accel_readFifo(raw_xyz_t *samples, uint8_t maxSamples);
+boolean lsm303_accel_setDataReady(boolean enable);
 void lsm303_getMag(float * x, float * y, float * z);
+float lsm303_getMagScale();
 void lsm303_getRawMag(int16_t *pX, int16_t *pY, int16_t *pZ);
+boolean lsm303_mag_setDataReady(boolean enable);
 
 /**
  * BMP180 Barometric altimeter is on Adafruit 10DOF, gives atmospheric pressure/altitude.
@@ -132,7 +156,13 @@ boolean bmp180_init(bmp085_mode_t mode);
 void bmp180_getRawTemperature(uint16_t *temp);
 void bmp180_getTemperature(float *temp);
 void bmp180_getRawPressure(uint32_t *pressure);
-void bmp180_getPressure(float *pressure);
+boolean bmp180_getPressure(float *pressure);
+unsigned int bmp180_startTemperature(void);
+boolean bmp180_finishTemperature(void);
+unsigned int bmp180_startPressure(void);
+boolean bmp180_finishPressure(float *pressure);
+void bmp180_setTemperatureRefresh(uint8_t samples, float threshold);
+boolean bmp180_temperatureDue(void);
 
 /**
  * ML8511 breakout board contains an MP8511 UV light sensor
@@ -147,24 +177,28 @@ float ml8511_getUV(int pin);
  *
  * https://www.sparkfun.com/products/9570
  */
-boolean mlx90614_init();
-float mlx90614_getTempCelsius();
+boolean mlx90614_init(uint8_t addr);
+float mlx90614_getTempCelsius(uint8_t addr);
 
 /**
  * TMP102 Temperature sensor
  *
  * https://www.sparkfun.com/products/11931
  */
-boolean tmp102_init();
-float tmp102_getTempCelsius();
+boolean tmp102_init(uint8_t addr);
+float tmp102_getTempCelsius(uint8_t addr);
 
 /**
  * TSL2561 Luminosity Sensor
  *
  * http://www.adafruit.com/product/439
  */
-boolean tsl2561_init(tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain);
-float tsl2561_getLux();
+boolean tsl2561_init(TSL2561 & device, uint8_t addr, tsl2561IntegrationTime_t intTime, tsl2561Gain_t gain);
+float tsl2561_getLux(TSL2561 & device);
+void tsl2561_setContinuous(TSL2561 & device, boolean continuous);
+unsigned int tsl2561_startLux(TSL2561 & device);
+unsigned int tsl2561_finishLux(TSL2561 & device, float *lux);
+void tsl2561_getRange(TSL2561 & device, tsl2561IntegrationTime_t *intTime, tsl2561Gain_t *gain);
 
 /**
  * ISL29125 RGB Sensor
@@ -179,8 +213,13 @@ void isl29125_getRGB(float * red, float * green, float * blue);
  *
  * https://learn.adafruit.com/adafruit-color-sensors
  */
-boolean tcs34725_init(tcs34725IntegrationTime_t it, tcs34725Gain_t gain);
-void tcs34725_getRGB(float * red, float * green, float * blue);
+boolean tcs34725_init(Adafruit_TCS34725 & device, tcs34725IntegrationTime_t it, tcs34725Gain_t gain);
+void tcs34725_getRGB(Adafruit_TCS34725 & device, float * red, float * green, float * blue);
+void tcs34725_setContinuous(Adafruit_TCS34725 & device, boolean continuous);
+unsigned int tcs34725_startRGB(Adafruit_TCS34725 & device);
+unsigned int tcs34725_finishRGB(Adafruit_TCS34725 & device, float * red, float * green, float * blue);
+void tcs34725_setAutoRange(Adafruit_TCS34725 & device, boolean enable);
+void tcs34725_getRange(Adafruit_TCS34725 & device, tcs34725IntegrationTime_t *it, tcs34725Gain_t *gain);
 
 /**
  * SI1132 UV/Light sensor uses the SI1145 driver provided by Adafruit.
@@ -0,0 +1,165 @@
+/**
+ * @file   filter.cpp
+ * @date   October 14, 2026
+ * @brief  Integer low-pass filters that decimate raw 3-axis samples
+ */
+
+#include <string.h>
+#include "filter.h"
+
+/**
+ * @param type FILTER_BOXCAR, FILTER_CIC or FILTER_IIR
+ * @param ratio inputs per output (1 to not decimate)
+ * @param param CIC stages or IIR shift, unused by the boxcar
+ */
+DecimationFilter::DecimationFilter(filter_type_t type, uint8_t ratio, uint8_t param)
+{
+  _type = type;
+  _ratio = ratio ? ratio : 1;
+  _param = param ? param : 1;
+
+  if (type == FILTER_CIC) {
+    if (_param > FILTER_CIC_MAX_STAGES) {
+      _param = FILTER_CIC_MAX_STAGES;
+    }
+
+    // Keep ratio^stages within 16 bits
+    while (true) {
+      _gain = 1;
+      for (uint8_t i = 0; i < _param; ++i) {
+        _gain *= _ratio;
+      }
+      if (_gain <= 0xFFFF) {
+        break;
+      }
+      _ratio--;
+    }
+  } else if (type == FILTER_IIR) {
+    if (_param > FILTER_IIR_MAX_SHIFT) {
+      _param = FILTER_IIR_MAX_SHIFT;
+    }
+    _gain = 1UL << _param;
+  } else {
+    _gain = _ratio;
+  }
+
+  reset();
+}
+
+/**
+ * Clears the filter state, e.g. after a gap in the samples
+ */
+void DecimationFilter::reset(void)
+{
+  memset(_acc, 0, sizeof(_acc));
+  memset(_comb, 0, sizeof(_comb));
+  memset(&output, 0, sizeof(output));
+  _count = 0;
+  _primed = false;
+}
+
+/*
+ * Divides with rounding to nearest and clamps to int16
+ */
+int16_t DecimationFilter::_output(int32_t value, uint32_t divisor)
+{
+  int32_t half = (int32_t) (divisor >> 1);
+
+  value = (value >= 0) ? (value + half) / (int32_t) divisor :
+                         -((-value + half) / (int32_t) divisor);
+
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  } else if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t) value;
+}
+
+/**
+ * Adds one sample
+ *
+ * @return true if a new output is ready in `output`
+ */
+boolean DecimationFilter::add(int16_t x, int16_t y, int16_t z)
+{
+  int16_t in[3] = {x, y, z};
+  int16_t out[3];
+  uint8_t axis, stage;
+
+  for (axis = 0; axis < 3; ++axis) {
+    switch (_type) {
+      case FILTER_CIC:
+        // Integrators wrap modulo 2^32, which the combs undo exactly
+        _acc[0][axis] = (int32_t) ((uint32_t) _acc[0][axis] + (uint32_t) (int32_t) in[axis]);
+        for (stage = 1; stage < _param; ++stage) {
+          _acc[stage][axis] = (int32_t) ((uint32_t) _acc[stage][axis] + (uint32_t) _acc[stage - 1][axis]);
+        }
+        break;
+      case FILTER_IIR:
+        // Start from the first sample rather than from 0
+        if (!_primed) {
+          _acc[0][axis] = (int32_t) in[axis] << _param;
+        } else {
+          _acc[0][axis] += in[axis] - (_acc[0][axis] >> _param);
+        }
+        break;
+      default:
+        _acc[0][axis] += in[axis];
+        break;
+    }
+  }
+  _primed = true;
+
+  if (++_count < _ratio) {
+    return false;
+  }
+  _count = 0;
+
+  for (axis = 0; axis < 3; ++axis) {
+    switch (_type) {
+      case FILTER_CIC: {
+        uint32_t value = (uint32_t) _acc[_param - 1][axis];
+        uint32_t delayed;
+
+        for (stage = 0; stage < _param; ++stage) {
+          delayed = (uint32_t) _comb[stage][axis];
+          _comb[stage][axis] = (int32_t) value;
+          value -= delayed;
+        }
+        out[axis] = _output((int32_t) value, _gain);
+        break;
+      }
+      case FILTER_IIR:
+        out[axis] = _output(_acc[0][axis], _gain);
+        break;
+      default:
+        out[axis] = _output(_acc[0][axis], _gain);
+        _acc[0][axis] = 0;
+        break;
+    }
+  }
+
+  output.x = out[0];
+  output.y = out[1];
+  output.z = out[2];
+  return true;
+}
+
+/**
+ * Adds samples in order, e.g. from a sensor's readBatch()
+ *
+ * @return true if at least one new output is ready; `output` holds the latest
+ */
+boolean DecimationFilter::addBatch(const raw_xyz_t *samples, uint8_t count)
+{
+  boolean ready = false;
+
+  for (uint8_t i = 0; i < count; ++i) {
+    if (add(samples[i].x, samples[i].y, samples[i].z)) {
+      ready = true;
+    }
+  }
+
+  return ready;
+}
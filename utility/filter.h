@@ -0,0 +1,77 @@
+/**
+ * @file   filter.h
+ * @date   October 14, 2026
+ * @brief  Integer low-pass filters that decimate raw 3-axis samples
+ *
+ * Sampling fast and averaging down to the output rate gives cleaner values and
+ * less telemetry than sampling at the output rate. All of the math is on the
+ * raw int16 counts, with 32 bit accumulators.
+ */
+
+#ifndef ARDUSAT_FILTER_H_
+#define ARDUSAT_FILTER_H_
+
+#include <Arduino.h>
+#include <utility/drivers.h>
+
+typedef enum {
+  FILTER_BOXCAR,  /* mean of each `ratio` samples */
+  FILTER_CIC,     /* cascaded integrator-comb, `param` stages (1-3) */
+  FILTER_IIR,     /* single pole, y += (x - y) / 2^param, param 1-12 */
+} filter_type_t;
+
+/**
+ * Most CIC stages. The CIC gain, ratio^stages, must fit in 16 bits so that the
+ * 32 bit accumulators can't overflow, which limits 3 stages to a ratio of 40.
+ */
+#define FILTER_CIC_MAX_STAGES 3
+#define FILTER_IIR_MAX_SHIFT 12
+
+/**************************************************************************//**
+ * @class DecimationFilter
+ * @ingroup sensor
+ *
+ * @brief Filters raw samples and keeps one output for every `ratio` inputs
+ *
+ * Example Usage:
+ * @code
+ *     DecimationFilter filter(FILTER_CIC, 20, 2); // 200 Hz in, 10 Hz out
+ *
+ *     void setup(void) {
+ *       gyro.begin();
+ *       gyro.setFilter(&filter);
+ *     }
+ * @endcode
+ *
+ * The ratio and parameter are clamped to the supported ranges. A CIC filter
+ * starts from 0, so its first `param` outputs are still settling.
+ *****************************************************************************/
+class DecimationFilter {
+  public:
+    DecimationFilter(filter_type_t type, uint8_t ratio, uint8_t param = 1);
+
+    boolean add(int16_t x, int16_t y, int16_t z);
+    boolean addBatch(const raw_xyz_t *samples, uint8_t count);
+    void reset(void);
+
+    filter_type_t type(void) { return _type; }
+    uint8_t ratio(void) { return _ratio; }
+
+    raw_xyz_t output;  /* the latest filtered sample */
+
+  private:
+    filter_type_t _type;
+    uint8_t _ratio;
+    uint8_t _param;
+    uint8_t _count;
+    boolean _primed;
+    uint32_t _gain;
+
+    // boxcar: _acc[0] is the sum; CIC: integrators; IIR: _acc[0] is y * 2^param
+    int32_t _acc[FILTER_CIC_MAX_STAGES][3];
+    int32_t _comb[FILTER_CIC_MAX_STAGES][3];
+
+    int16_t _output(int32_t value, uint32_t divisor);
+};
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @file   format.cpp
+ * @date   October 14, 2026
+ * @brief  Fixed-point number formatting for the CSV and JSON output
+ */
+
+#include <avr/pgmspace.h>
+#include <math.h>
+#include "format.h"
+
+/*
+ * Powers of ten that are exact as floats
+ */
+static const float _pow10[] PROGMEM = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+/*
+ * Returns value * 10^exp
+ */
+static float _scale(float value, int8_t exp)
+{
+  while (exp > 10) {
+    value *= 1e10f;
+    exp -= 10;
+  }
+  while (exp < -10) {
+    value /= 1e10f;
+    exp += 10;
+  }
+
+  if (exp >= 0) {
+    return value * pgm_read_float(&_pow10[exp]);
+  }
+  return value / pgm_read_float(&_pow10[-exp]);
+}
+
+static const uint16_t _pow5[] PROGMEM = {
+  1, 5, 25, 125, 625, 3125, 15625,
+};
+
+/*
+ * Returns value * 10^exp rounded to the nearest integer, halves rounding up
+ * like avr-libc. value must not be negative, exp must be at most
+ * FORMAT_FIXED_MAX_PREC and the result must fit in 31 bits.
+ *
+ * Scaling the float directly would round twice (once in the multiply), which
+ * gets the last digit wrong for about 1 in 50 values. Instead this works on
+ * the float's mantissa and exponent, which is exact for any value below 2^32.
+ * It sticks to 32 bit arithmetic, as 64 bit multiplies and shifts are slow
+ * library calls on AVR.
+ */
+static uint32_t _scaleRound(float value, int8_t exp)
+{
+  union {
+    float f;
+    uint32_t u;
+  } bits;
+  uint32_t mantissa, hi, lo;
+  uint16_t pow5;
+  int16_t shift;
+
+  if (exp < 0) {
+    if (value < 4294967296.0f && exp >= -9) {
+      uint32_t whole = (uint32_t) value;
+      uint32_t div = (uint32_t) pgm_read_float(&_pow10[-exp]);
+
+      return whole / div + ((whole % div) * 2 >= div ? 1 : 0);
+    }
+    return (uint32_t) (_scale(value, exp) + 0.5f);
+  }
+
+  // value = mantissa * 2^(shift - 150), so value * 10^exp is
+  // mantissa * 5^exp * 2^(shift - 150 + exp)
+  bits.f = value;
+  shift = (bits.u >> 23) & 0xFF;
+  mantissa = bits.u & 0x7FFFFFUL;
+  if (shift == 0) {
+    shift = 1;
+  } else {
+    mantissa |= 0x800000UL;
+  }
+  shift += exp - 150;
+
+  // mantissa * 5^exp takes up to 38 bits, so it's kept as hi * 2^12 + lo
+  pow5 = pgm_read_word(&_pow5[exp]);
+  hi = (mantissa >> 12) * pow5;
+  lo = (mantissa & 0xFFF) * pow5;
+  if (shift >= 0) {
+    return ((hi << 12) + lo) << shift;
+  }
+  if (shift < -40) {
+    return 0;
+  }
+
+  // Rounded by shifting one bit less, adding 1 and dropping the last bit
+  shift = -shift - 1;
+  if (shift >= 12) {
+    hi = (hi + (lo >> 12)) >> (shift - 12);
+  } else {
+    hi = (hi << (12 - shift)) + (lo >> shift);
+  }
+  return (hi + 1) >> 1;
+}
+
+/**
+ * Formats a float with a fixed number of decimal places, the same as
+ * dtostrf(value, width, prec, buf).
+ *
+ * @param buf buffer to write to, at least FORMAT_FIXED_MAX_LEN + 1 bytes
+ * @param value value to format
+ * @param width minimum width, padded on the left with spaces
+ * @param prec number of decimal places, up to FORMAT_FIXED_MAX_PREC
+ *
+ * @return length of the string written to buf
+ */
+uint8_t formatFixed(char *buf, float value, uint8_t width, uint8_t prec)
+{
+  char digits[FORMAT_FIXED_MAX_LEN];
+  char *p = digits + sizeof(digits);
+  boolean neg = signbit(value);
+  uint8_t len, total;
+
+  if (prec > FORMAT_FIXED_MAX_PREC) {
+    prec = FORMAT_FIXED_MAX_PREC;
+  }
+
+  if (width > FORMAT_FIXED_MAX_LEN) {
+    width = FORMAT_FIXED_MAX_LEN;
+  }
+
+  if (isnan(value)) {
+    neg = false;
+    *--p = 'n';
+    *--p = 'a';
+    *--p = 'n';
+  } else if (isinf(value)) {
+    *--p = 'f';
+    *--p = 'n';
+    *--p = 'i';
+  } else {
+    int8_t exp = prec;
+    int8_t place = -prec;
+    float x;
+    uint32_t d;
+
+    // Scale to an integer of at most 7 significant digits. The last digit of
+    // d is the 10^-exp place.
+    value = fabs(value);
+    x = _scale(value, exp);
+    while (x >= 9999999.5f) {
+      x = _scale(value, --exp);
+    }
+
+    d = _scaleRound(value, exp);
+
+    // Written from the least significant place up, in front of p
+    while (place <= 0 || place < -exp || d > 0) {
+      if (place < -exp) {
+        *--p = '0';
+      } else {
+        *--p = '0' + (d % 10);
+        d /= 10;
+      }
+
+      if (place == -1) {
+        *--p = '.';
+      }
+      place++;
+    }
+  }
+
+  if (neg) {
+    *--p = '-';
+  }
+
+  len = digits + sizeof(digits) - p;
+  total = len > width ? len : width;
+
+  memset(buf, ' ', total - len);
+  memcpy(buf + total - len, p, len);
+  buf[total] = '\0';
+
+  return total;
+}
+
+/**
+ * Prints a float with a fixed number of decimal places, the same as printing
+ * the result of dtostrf(value, width, prec, buf).
+ *
+ * @param out where to print
+ * @param value value to print
+ * @param width minimum width, padded on the left with spaces
+ * @param prec number of decimal places, up to FORMAT_FIXED_MAX_PREC
+ *
+ * @return number of bytes written
+ */
+size_t printFixed(Print &out, float value, uint8_t width, uint8_t prec)
+{
+  char buf[FORMAT_FIXED_MAX_LEN + 1];
+  uint8_t len = formatFixed(buf, value, width, prec);
+
+  return out.write((const uint8_t *) buf, len);
+}
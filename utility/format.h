@@ -0,0 +1,31 @@
+/**
+ * @file   format.h
+ * @date   October 14, 2026
+ * @brief  Fixed-point number formatting for the CSV and JSON output
+ *
+ * Formats floats with integer math, avoiding dtostrf and the AVR printf/float
+ * libraries it pulls in. The output matches dtostrf(value, width, prec): like
+ * avr-libc, no more than 7 significant digits are printed, and any digits
+ * past those are printed as 0.
+ */
+
+#ifndef ARDUSAT_FORMAT_H_
+#define ARDUSAT_FORMAT_H_
+
+#include <Arduino.h>
+
+/**
+ * Longest string formatFixed() writes, not counting the null terminator.
+ * Wider widths are cut down to this.
+ */
+#define FORMAT_FIXED_MAX_LEN 48
+
+/**
+ * Most decimal places formatFixed() supports
+ */
+#define FORMAT_FIXED_MAX_PREC 6
+
+uint8_t formatFixed(char *buf, float value, uint8_t width, uint8_t prec);
+size_t printFixed(Print &out, float value, uint8_t width, uint8_t prec);
+
+#endif
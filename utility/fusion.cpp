@@ -0,0 +1,354 @@
+/**
+ * @file   fusion.cpp
+ * @date   October 14, 2026
+ * @brief  Fixed-point complementary filter that fuses gyro, accel and mag samples
+ */
+
+#include <math.h>
+#include "fusion.h"
+
+/*
+ * Q30 multiplies. AVR has no 32 bit multiply, so avr-gcc does the 64 bit
+ * product and shift with libgcc calls (__mulsidi3 or __muldi3, and
+ * __ashrdi3), a few hundred cycles each time.
+ */
+static inline int32_t _mul(int32_t a, int32_t b) {
+  return (int32_t) (((int64_t) a * b) >> 30);
+}
+
+static inline int32_t _mul2(int32_t a, int32_t b) {
+  return (int32_t) (((int64_t) a * b) >> 29);
+}
+
+static uint16_t _isqrt(uint32_t x) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return (uint16_t) root;
+}
+
+/*
+ * Scales a vector of raw counts to a Q30 unit vector with a single division
+ *
+ * Since |x| <= floor(|v|), x * (2^30 / floor(|v|)) can't overflow.
+ */
+static boolean _unit(int16_t x, int16_t y, int16_t z, int32_t out[3]) {
+  uint32_t sum = (uint32_t) ((int32_t) x * x) + (uint32_t) ((int32_t) y * y) +
+                 (uint32_t) ((int32_t) z * z);
+  uint16_t norm = _isqrt(sum);
+  int32_t r;
+
+  if (norm == 0) {
+    return false;
+  }
+
+  r = FUSION_ONE / norm;
+  out[0] = x * r;
+  out[1] = y * r;
+  out[2] = z * r;
+  return true;
+}
+
+FusionFilter::FusionFilter(void)
+{
+  _gyroScale = 0;
+  setGains(FUSION_DEFAULT_KP, FUSION_DEFAULT_KI);
+  reset();
+}
+
+/**
+ * @param radPerCount gyro scale, e.g. Gyro::rawScale()
+ */
+void FusionFilter::setGyroScale(float radPerCount)
+{
+  _gyroScale = (int32_t) (radPerCount * 16777216.0 + 0.5);
+}
+
+/**
+ * Sets how hard the accelerometer and magnetometer pull the attitude. A
+ * higher kp converges faster but lets more accelerometer noise and motion
+ * through; ki > 0 also learns a constant gyro bias.
+ *
+ * @param kp proportional gain, rad/s per unit of error
+ * @param ki integral gain, rad/s^2 per unit of error
+ */
+void FusionFilter::setGains(float kp, float ki)
+{
+  _kp = (int32_t) (kp * 65536.0 + 0.5);
+  _ki = (int32_t) (ki * 65536.0 + 0.5);
+
+  if (_ki == 0) {
+    _bias[0] = _bias[1] = _bias[2] = 0;
+  }
+}
+
+/**
+ * Forgets the attitude, gyro bias and vectors. The next update with an
+ * accelerometer vector aligns the filter again.
+ */
+void FusionFilter::reset(void)
+{
+  q[0] = FUSION_ONE;
+  q[1] = q[2] = q[3] = 0;
+  _bias[0] = _bias[1] = _bias[2] = 0;
+  _hasAccel = false;
+  _hasMag = false;
+  _aligned = false;
+}
+
+/**
+ * Sets the accelerometer vector used by the following updates
+ */
+void FusionFilter::setAccel(int16_t x, int16_t y, int16_t z)
+{
+  if (_unit(x, y, z, _accel)) {
+    _hasAccel = true;
+  }
+}
+
+/**
+ * Sets the magnetometer vector used by the following updates, which then also
+ * correct the heading
+ */
+void FusionFilter::setMag(int16_t x, int16_t y, int16_t z)
+{
+  if (_unit(x, y, z, _mag)) {
+    _hasMag = true;
+  }
+}
+
+/**
+ * Stops correcting the heading, e.g. while the magnetometer can't be read
+ */
+void FusionFilter::clearMag(void)
+{
+  _hasMag = false;
+}
+
+/**
+ * Advances the attitude by one gyro sample
+ *
+ * @param gx raw gyro x count
+ * @param gy raw gyro y count
+ * @param gz raw gyro z count
+ * @param dtMicros time the sample covers, normally the gyro sample period
+ */
+void FusionFilter::update(int16_t gx, int16_t gy, int16_t gz, uint32_t dtMicros)
+{
+  int32_t rate[3];
+
+  if (!_aligned && _hasAccel) {
+    _align();
+  }
+
+  if (dtMicros > FUSION_MAX_DT_US) {
+    dtMicros = FUSION_MAX_DT_US;
+  }
+
+  rate[0] = gx * _gyroScale;
+  rate[1] = gy * _gyroScale;
+  rate[2] = gz * _gyroScale;
+
+  while (dtMicros > FUSION_MAX_STEP_US) {
+    _step(rate, FUSION_MAX_STEP_US);
+    dtMicros -= FUSION_MAX_STEP_US;
+  }
+  if (dtMicros > 0) {
+    _step(rate, dtMicros);
+  }
+}
+
+/**
+ * Converts the attitude to Euler angles (z-y-x order), the same angles that the
+ * Orientation sensor works out from a single accelerometer and magnetometer
+ * reading
+ *
+ * @param roll rotation around x in radians, -pi to pi
+ * @param pitch rotation around y in radians, -pi/2 to pi/2
+ * @param yaw rotation around z (heading) in radians, -pi to pi
+ */
+void FusionFilter::getEuler(float *roll, float *pitch, float *yaw)
+{
+  float w = q[0] / (float) FUSION_ONE;
+  float x = q[1] / (float) FUSION_ONE;
+  float y = q[2] / (float) FUSION_ONE;
+  float z = q[3] / (float) FUSION_ONE;
+  float sinPitch = 2 * (w * y - x * z);
+
+  if (sinPitch > 1) {
+    sinPitch = 1;
+  } else if (sinPitch < -1) {
+    sinPitch = -1;
+  }
+
+  *roll = atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y));
+  *pitch = asin(sinPitch);
+  *yaw = atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z));
+}
+
+/*
+ * Sets the attitude straight from the accelerometer and magnetometer, the same
+ * way as Orientation does. Only done once, so float is fine here.
+ */
+void FusionFilter::_align(void)
+{
+  float ax = _accel[0];
+  float ay = _accel[1];
+  float az = _accel[2];
+  float yz = sqrt(ay * ay + az * az);
+  float roll = atan2(ay, az);
+  float pitch = atan2(-ax, yz);
+  float yaw = 0;
+  float cr;
+  float sr;
+  float cp;
+  float sp;
+  float cy;
+  float sy;
+
+  if (_hasMag) {
+    float mx = _mag[0];
+    float my = _mag[1];
+    float mz = _mag[2];
+
+    yaw = atan2(mz * sin(roll) - my * cos(roll),
+                mx * cos(pitch) + (my * sin(roll) + mz * cos(roll)) * sin(pitch));
+  }
+
+  cr = cos(roll / 2);
+  sr = sin(roll / 2);
+  cp = cos(pitch / 2);
+  sp = sin(pitch / 2);
+  cy = cos(yaw / 2);
+  sy = sin(yaw / 2);
+
+  q[0] = (int32_t) ((cr * cp * cy + sr * sp * sy) * FUSION_ONE);
+  q[1] = (int32_t) ((sr * cp * cy - cr * sp * sy) * FUSION_ONE);
+  q[2] = (int32_t) ((cr * sp * cy + sr * cp * sy) * FUSION_ONE);
+  q[3] = (int32_t) ((cr * cp * sy - sr * sp * cy) * FUSION_ONE);
+  _normalize();
+
+  _aligned = true;
+}
+
+/*
+ * One filter step: feeds back the vector errors, then integrates
+ * q += q * (0, w dt / 2)
+ *
+ * The rotation matrix terms below are all at most 1, and each sum is ordered
+ * so that no partial sum goes past 2 either.
+ */
+void FusionFilter::_step(const int32_t rate[3], uint32_t dtMicros)
+{
+  // dt / 2 in seconds, Q30 (2^30 / 2e6 = 34359.74 / 64)
+  int32_t halfDt = (int32_t) (((uint32_t) dtMicros * 34360UL) >> 6);
+  int32_t w[3];
+  int32_t h[3];
+  int32_t q0 = q[0];
+  int32_t q1 = q[1];
+  int32_t q2 = q[2];
+  int32_t q3 = q[3];
+
+  for (uint8_t i = 0; i < 3; ++i) {
+    w[i] = rate[i] + _bias[i];
+  }
+
+  if (_hasAccel) {
+    int32_t q0q1 = _mul2(q0, q1);
+    int32_t q0q2 = _mul2(q0, q2);
+    int32_t q1q1 = _mul2(q1, q1);
+    int32_t q1q3 = _mul2(q1, q3);
+    int32_t q2q2 = _mul2(q2, q2);
+    int32_t q2q3 = _mul2(q2, q3);
+    // Bottom row of the rotation matrix: gravity as the body should see it
+    int32_t r20 = q1q3 - q0q2;
+    int32_t r21 = q2q3 + q0q1;
+    int32_t r22 = (FUSION_ONE - q1q1) - q2q2;
+    int32_t e[3];
+
+    e[0] = _mul(_accel[1], r22) - _mul(_accel[2], r21);
+    e[1] = _mul(_accel[2], r20) - _mul(_accel[0], r22);
+    e[2] = _mul(_accel[0], r21) - _mul(_accel[1], r20);
+
+    if (_hasMag) {
+      int32_t q0q3 = _mul2(q0, q3);
+      int32_t q1q2 = _mul2(q1, q2);
+      int32_t q3q3 = _mul2(q3, q3);
+      int32_t r00 = (FUSION_ONE - q2q2) - q3q3;
+      int32_t r01 = q1q2 - q0q3;
+      int32_t r02 = q1q3 + q0q2;
+      int32_t r10 = q1q2 + q0q3;
+      int32_t r11 = (FUSION_ONE - q1q1) - q3q3;
+      int32_t r12 = q2q3 - q0q1;
+      int32_t hx = _mul(r00, _mag[0]) + _mul(r01, _mag[1]) + _mul(r02, _mag[2]);
+      int32_t hy = _mul(r10, _mag[0]) + _mul(r11, _mag[1]) + _mul(r12, _mag[2]);
+      // The field in the earth frame, turned to point north: (bx, 0, bz)
+      int32_t bz = _mul(r20, _mag[0]) + _mul(r21, _mag[1]) + _mul(r22, _mag[2]);
+      int32_t bx = (int32_t) _isqrt((uint32_t) (_mul(hx, hx) + _mul(hy, hy))) << 15;
+      // ... and back in the body frame
+      int32_t mx = _mul(r00, bx) + _mul(r20, bz);
+      int32_t my = _mul(r01, bx) + _mul(r21, bz);
+      int32_t mz = _mul(r02, bx) + _mul(r22, bz);
+
+      e[0] += _mul(_mag[1], mz) - _mul(_mag[2], my);
+      e[1] += _mul(_mag[2], mx) - _mul(_mag[0], mz);
+      e[2] += _mul(_mag[0], my) - _mul(_mag[1], mx);
+    }
+
+    for (uint8_t i = 0; i < 3; ++i) {
+      // Q30 error * Q16 gain = Q24 rad/s
+      if (_ki != 0) {
+        int32_t integral = (int32_t) (((int64_t) e[i] * _ki) >> 22);
+        _bias[i] += (int32_t) (((int64_t) integral * halfDt) >> 29);
+      }
+      w[i] += (int32_t) (((int64_t) e[i] * _kp) >> 22);
+    }
+  }
+
+  // Q24 rad/s * Q30 s = Q30 half angle
+  for (uint8_t i = 0; i < 3; ++i) {
+    h[i] = (int32_t) (((int64_t) w[i] * halfDt) >> 24);
+  }
+
+  q[0] += -_mul(q1, h[0]) - _mul(q2, h[1]) - _mul(q3, h[2]);
+  q[1] += _mul(q0, h[0]) + _mul(q2, h[2]) - _mul(q3, h[1]);
+  q[2] += _mul(q0, h[1]) - _mul(q1, h[2]) + _mul(q3, h[0]);
+  q[3] += _mul(q0, h[2]) + _mul(q1, h[1]) - _mul(q2, h[0]);
+
+  _normalize();
+}
+
+/*
+ * Scales q back to unit length. Each step only stretches q by about
+ * (w dt / 2)^2, so a Newton step for 1 / sqrt(n) around 1 is enough; a long
+ * step gets a second one.
+ */
+void FusionFilter::_normalize(void)
+{
+  for (uint8_t pass = 0; pass < 2; ++pass) {
+    int32_t n = _mul(q[0], q[0]) + _mul(q[1], q[1]) + _mul(q[2], q[2]) + _mul(q[3], q[3]);
+    int32_t d = FUSION_ONE - n;
+    int32_t s = FUSION_ONE + d / 2;
+
+    for (uint8_t i = 0; i < 4; ++i) {
+      q[i] = _mul(q[i], s);
+    }
+
+    if (d < (FUSION_ONE >> 12) && d > -(FUSION_ONE >> 12)) {
+      break;
+    }
+  }
+}
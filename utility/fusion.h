@@ -0,0 +1,119 @@
+/**
+ * @file   fusion.h
+ * @date   October 14, 2026
+ * @brief  Fixed-point complementary filter that fuses gyro, accel and mag samples
+ *
+ * The filter is Mahony's explicit complementary filter: the gyro rates are
+ * integrated into an attitude quaternion, and the error between the measured
+ * and predicted directions of gravity and of the magnetic field is fed back as
+ * a correction to the rates. Every filter step is done in 32 bit fixed point,
+ * with the quaternion in Q30, so there is no soft-float in the per-sample path.
+ * Floats are only used to convert settings and to align the filter at start.
+ */
+
+#ifndef ARDUSAT_FUSION_H_
+#define ARDUSAT_FUSION_H_
+
+#include <Arduino.h>
+
+/**
+ * 1.0 in the Q30 format of the quaternion and unit vectors
+ */
+#define FUSION_ONE (1L << 30)
+
+/**
+ * Longest single filter step. Longer intervals are split into steps of this
+ * length, and intervals over FUSION_MAX_DT_US are cut short, since the gyro
+ * rate can't be trusted over a gap that long.
+ */
+#define FUSION_MAX_STEP_US 20000UL
+#ifndef FUSION_MAX_DT_US
+#define FUSION_MAX_DT_US 100000UL
+#endif
+
+/**
+ * Gyro sample period FusedOrientation assumes until it has measured it: the
+ * 100 Hz that l3gd20h_init sets
+ */
+#define FUSION_GYRO_PERIOD_US 10000UL
+
+/**
+ * How often FusedOrientation reads the magnetometer, and how many FIFO samples
+ * it reads at a time (6 bytes of stack each)
+ */
+#ifndef FUSION_MAG_INTERVAL_MS
+#define FUSION_MAG_INTERVAL_MS 100
+#endif
+#ifndef FUSION_BATCH_SAMPLES
+#define FUSION_BATCH_SAMPLES 8
+#endif
+
+/**
+ * Default proportional and integral gains, in rad/s of correction per unit of
+ * error. These are the usual Mahony values: converges in a few seconds and
+ * doesn't estimate the gyro bias.
+ */
+#define FUSION_DEFAULT_KP 0.5
+#define FUSION_DEFAULT_KI 0.0
+
+/**************************************************************************//**
+ * @class FusionFilter
+ * @ingroup sensor
+ *
+ * @brief Tracks attitude from raw gyro, accelerometer and magnetometer counts
+ *
+ * Example Usage:
+ * @code
+ *     FusionFilter filter;
+ *
+ *     filter.setGyroScale(gyro.rawScale());
+ *     ...
+ *     filter.setAccel(accel.rawX, accel.rawY, accel.rawZ);
+ *     filter.setMag(mag.rawX, mag.rawY, mag.rawZ);   // less often is fine
+ *     filter.update(gyro.rawX, gyro.rawY, gyro.rawZ, 10000);
+ * @endcode
+ *
+ * The accelerometer and magnetometer only need the same axes as the gyro;
+ * their scale doesn't matter, since only their directions are used. Each new
+ * vector costs one division; each update about 65 Q30 multiplies with a
+ * magnetometer vector, and about 40 without. Each of those is a 64 bit libgcc
+ * multiply and shift of a few hundred cycles, so an update takes on the order
+ * of a millisecond at 16 MHz. The first update with an
+ * accelerometer vector sets the attitude straight from it (and from the
+ * magnetometer, if set) instead of waiting for the filter to converge.
+ *****************************************************************************/
+class FusionFilter {
+  public:
+    FusionFilter(void);
+
+    void setGyroScale(float radPerCount);
+    void setGains(float kp, float ki);
+    void reset(void);
+
+    void setAccel(int16_t x, int16_t y, int16_t z);
+    void setMag(int16_t x, int16_t y, int16_t z);
+    void clearMag(void);
+    void update(int16_t gx, int16_t gy, int16_t gz, uint32_t dtMicros);
+
+    boolean aligned(void) { return _aligned; }
+    void getEuler(float *roll, float *pitch, float *yaw);
+
+    int32_t q[4];  /* attitude quaternion w, x, y, z in Q30, body to earth */
+
+  private:
+    int32_t _gyroScale;   // rad/s per count, Q24
+    int32_t _kp;          // Q16
+    int32_t _ki;          // Q16
+    int32_t _bias[3];     // integral feedback, rad/s in Q24
+    int32_t _accel[3];    // unit vector, Q30
+    int32_t _mag[3];      // unit vector, Q30
+    boolean _hasAccel;
+    boolean _hasMag;
+    boolean _aligned;
+
+    void _align(void);
+    void _step(const int32_t rate[3], uint32_t dtMicros);
+    void _normalize(void);
+};
+
+#endif /* ARDUSAT_FUSION_H_ */
@@ -0,0 +1,106 @@
+/**
+ * @file   output_sink.cpp
+ * @date   October 14, 2026
+ * @brief  Destinations that sensor data can be written into directly, instead
+ *         of being formatted into the shared output buffer first.
+ */
+
+#include "output_sink.h"
+
+/**
+ * @brief   Constructs an empty ring buffer using the provided storage
+ * @ingroup sensor
+ *
+ * @param buffer storage for the ring buffer, must outlive the sink
+ * @param size size of the storage in bytes
+ */
+RingBufferSink::RingBufferSink(uint8_t * buffer, size_t size) :
+  buffer(buffer),
+  size(size),
+  head(0),
+  count(0),
+  overflowCount(0)
+{
+}
+
+/**
+ * @brief   Adds a byte to the ring buffer
+ * @ingroup sensor
+ *
+ * @param b byte to add
+ * @return 1 if the byte was added, 0 if the ring buffer is full
+ */
+size_t RingBufferSink::write(uint8_t b) {
+  if (this->count >= this->size) {
+    this->overflowCount++;
+    return 0;
+  }
+
+  this->buffer[(this->head + this->count) % this->size] = b;
+  this->count++;
+  return 1;
+}
+
+/**
+ * @brief   Gets the number of bytes waiting to be read
+ * @ingroup sensor
+ */
+int RingBufferSink::available(void) {
+  return this->count;
+}
+
+/**
+ * @brief   Removes and returns the oldest byte in the ring buffer
+ * @ingroup sensor
+ *
+ * @return the oldest byte, or -1 if the ring buffer is empty
+ */
+int RingBufferSink::read(void) {
+  int b = this->peek();
+
+  if (b >= 0) {
+    this->head = (this->head + 1) % this->size;
+    this->count--;
+  }
+
+  return b;
+}
+
+/**
+ * @brief   Returns the oldest byte in the ring buffer without removing it
+ * @ingroup sensor
+ *
+ * @return the oldest byte, or -1 if the ring buffer is empty
+ */
+int RingBufferSink::peek(void) {
+  if (this->count == 0) {
+    return -1;
+  }
+
+  return this->buffer[this->head];
+}
+
+/**
+ * @brief   Nothing to do; data stays in the ring buffer until it is read
+ * @ingroup sensor
+ */
+void RingBufferSink::flush(void) {
+}
+
+/**
+ * @brief   Discards everything in the ring buffer and resets the overflow count
+ * @ingroup sensor
+ */
+void RingBufferSink::clear(void) {
+  this->head = 0;
+  this->count = 0;
+  this->overflowCount = 0;
+}
+
+/**
+ * @brief   Gets the number of bytes dropped because the ring buffer was full
+ * @ingroup sensor
+ */
+unsigned int RingBufferSink::overflows(void) {
+  return this->overflowCount;
+}
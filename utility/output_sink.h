@@ -0,0 +1,67 @@
+/**
+ * @file   output_sink.h
+ * @date   October 14, 2026
+ * @brief  Destinations that sensor data can be written into directly, instead
+ *         of being formatted into the shared output buffer first.
+ */
+
+#ifndef ARDUSAT_OUTPUT_SINK_H_
+#define ARDUSAT_OUTPUT_SINK_H_
+
+#include <Arduino.h>
+#include <Stream.h>
+
+/**
+ * Anything sensor data can be written to a chunk at a time. This is Arduino's
+ * Print interface, so ArdusatSerial, HardwareSerial, SD library Files and
+ * RingBufferSink can all be used as sinks.
+ */
+typedef Print OutputSink;
+
+/**************************************************************************//**
+ * @class RingBufferSink
+ * @ingroup sensor
+ *
+ * @brief Sink that keeps sensor data in a RAM ring buffer until it is read back
+ *
+ * Useful for collecting records while a radio or SD card is busy and sending
+ * them later. The caller provides the storage, so no heap memory is used.
+ * Writes that don't fit are dropped and counted in `overflows()`.
+ *
+ * Example Usage:
+ * @code
+ *     uint8_t storage[128];
+ *     RingBufferSink ring(storage, sizeof(storage));
+ *
+ *     accel.read();
+ *     accel.writeCSV(ring, "accel");
+ *
+ *     while (ring.available()) {
+ *       Serial.write(ring.read());
+ *     }
+ * @endcode
+ *****************************************************************************/
+class RingBufferSink : public Stream {
+  protected:
+    uint8_t * buffer;
+    size_t size;
+    size_t head;
+    size_t count;
+    unsigned int overflowCount;
+
+  public:
+    RingBufferSink(uint8_t * buffer, size_t size);
+
+    size_t write(uint8_t b);
+    using Print::write;
+
+    int available(void);
+    int read(void);
+    int peek(void);
+    void flush(void);
+
+    void clear(void);
+    unsigned int overflows(void);
+};
+
+#endif /* ARDUSAT_OUTPUT_SINK_H_ */
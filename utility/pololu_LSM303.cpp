@@ -311,6 +311,24 @@ byte LSM303::readReg(int reg)
   }
 }
 
+// Did a timeout occur in readAcc() or readMag() since the last call to timeoutOccurred()?
+bool LSM303::timeoutOccurred()
+{
+  bool tmp = did_timeout;
+  did_timeout = false;
+  return tmp;
+}
+
+void LSM303::setTimeout(unsigned int timeout)
+{
+  io_timeout = timeout;
+}
+
+unsigned int LSM303::getTimeout()
+{
+  return io_timeout;
+}
+
 // Reads the 3 accelerometer channels and stores them in vector a
 void LSM303::readAcc(void)
 {
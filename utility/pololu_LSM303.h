@@ -169,6 +169,7 @@ class LSM303
 
     bool init(deviceType device = device_auto, sa0State sa0 = sa0_auto);
     deviceType getDeviceType(void) { return _device; }
+    byte getAccAddress(void) { return acc_address; }
 
     void enableDefault(void);
 
@@ -184,6 +185,10 @@ class LSM303
     void readMag(void);
     void read(void);
 
+    void setTimeout(unsigned int timeout);
+    unsigned int getTimeout(void);
+    bool timeoutOccurred(void);
+
   private:
     deviceType _device; // chip type (D, DLHC, DLM, or DLH)
     byte acc_address;
@@ -0,0 +1,111 @@
+/**
+ * @file   report.cpp
+ * @date   October 14, 2026
+ * @brief  Deadband reporting, so readings that haven't changed aren't sent
+ */
+
+#include "report.h"
+
+/**
+ * @param absolute deadband in the sensor's units, 0 for none
+ * @param relative deadband as a fraction of the last value sent, 0 for none
+ * @param heartbeat longest time in ms between readings sent, 0 for no limit
+ */
+ReportPolicy::ReportPolicy(float absolute, float relative, unsigned long heartbeat)
+{
+  setDeadband(absolute, relative);
+  setHeartbeat(heartbeat);
+  _count = 0;
+  _forced = true;
+  _sent = 0;
+  _suppressed = 0;
+}
+
+/**
+ * Sets the deadband. Negative values are taken as their size.
+ *
+ * @param absolute deadband in the sensor's units, 0 for none
+ * @param relative deadband as a fraction of the last value sent, 0 for none
+ */
+void ReportPolicy::setDeadband(float absolute, float relative)
+{
+  _absolute = fabs(absolute);
+  _relative = fabs(relative);
+}
+
+/**
+ * @param heartbeat longest time in ms between readings sent, 0 for no limit
+ */
+void ReportPolicy::setHeartbeat(unsigned long heartbeat)
+{
+  _heartbeat = heartbeat;
+}
+
+/**
+ * Sends the next reading whatever its values, e.g. when a receiver has just
+ * joined. The first reading is always sent.
+ */
+void ReportPolicy::force(void)
+{
+  _forced = true;
+}
+
+/*
+ * Checks one value against the deadband
+ */
+boolean ReportPolicy::_moved(float value, float last)
+{
+  float change = fabs(value - last);
+
+  if (_absolute == 0 && _relative == 0) {
+    return change != 0;
+  }
+
+  return (_absolute > 0 && change > _absolute) ||
+         (_relative > 0 && change > _relative * fabs(last));
+}
+
+/**
+ * Decides whether a reading should be sent, and if so remembers it as the last
+ * one sent
+ *
+ * @param values the reading
+ * @param count number of values, at most REPORT_MAX_VALUES
+ * @param timestamp time of the reading
+ *
+ * @return true if the reading should be sent
+ */
+boolean ReportPolicy::check(const float *values, uint8_t count, unsigned long timestamp)
+{
+  boolean send;
+
+  if (count > REPORT_MAX_VALUES) {
+    count = REPORT_MAX_VALUES;
+  }
+
+  send = _forced || count != _count;
+  if (!send && _heartbeat > 0 && timestamp - _last_time >= _heartbeat) {
+    send = true;
+  }
+  for (uint8_t i = 0; i < count && !send; ++i) {
+    send = _moved(values[i], _last[i]);
+  }
+
+  if (!send) {
+    if (_suppressed < 0xFFFF) {
+      _suppressed++;
+    }
+    return false;
+  }
+
+  for (uint8_t i = 0; i < count; ++i) {
+    _last[i] = values[i];
+  }
+  _count = count;
+  _last_time = timestamp;
+  _forced = false;
+  if (_sent < 0xFFFF) {
+    _sent++;
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file   report.h
+ * @date   October 14, 2026
+ * @brief  Deadband reporting, so readings that haven't changed aren't sent
+ */
+
+#ifndef ARDUSAT_REPORT_H_
+#define ARDUSAT_REPORT_H_
+
+#include <Arduino.h>
+
+/**
+ * Most values a sensor reading has (x, y and z, or red, green and blue)
+ */
+#define REPORT_MAX_VALUES 3
+
+/**************************************************************************//**
+ * @class ReportPolicy
+ * @ingroup sensor
+ *
+ * @brief Decides which readings of a sensor are worth sending
+ *
+ * A reading is sent when any of its values has moved further than the
+ * deadband from the last reading sent, when nothing has been sent for the
+ * heartbeat period, or when forced with `force()`. The deadband is exceeded
+ * when a value moves more than `absolute`, or more than `relative` times the
+ * last value sent (e.g. 0.01 for 1%); either can be 0 to leave it out, and
+ * with both 0 any change at all is sent. Use one policy per sensor, since it
+ * holds the last values sent.
+ *
+ * Example Usage:
+ * @code
+ *     ReportPolicy tempPolicy(0.25, 0, 60000); // 0.25 C, or once a minute
+ *
+ *     void setup(void) {
+ *       temp.begin();
+ *       temp.setReportPolicy(&tempPolicy);
+ *     }
+ * @endcode
+ *****************************************************************************/
+class ReportPolicy {
+  public:
+    ReportPolicy(float absolute, float relative = 0, unsigned long heartbeat = 0);
+
+    boolean check(const float *values, uint8_t count, unsigned long timestamp);
+    void force(void);
+    void setDeadband(float absolute, float relative = 0);
+    void setHeartbeat(unsigned long heartbeat);
+
+    uint16_t sent(void) { return _sent; }
+    uint16_t suppressed(void) { return _suppressed; }
+
+  private:
+    float _absolute;
+    float _relative;
+    unsigned long _heartbeat;
+    unsigned long _last_time;
+    float _last[REPORT_MAX_VALUES];
+    uint8_t _count;
+    boolean _forced;
+    uint16_t _sent;
+    uint16_t _suppressed;
+
+    boolean _moved(float value, float last);
+};
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file   scheduler.cpp
+ * @date   October 14, 2026
+ * @brief  Cooperative scheduler that samples each sensor at its own rate
+ *         using the split-phase (startRead/poll) sensor reads.
+ */
+
+#include <ArdusatSDK.h>
+#include "scheduler.h"
+
+/**
+ * @brief   Constructs an empty scheduler
+ * @ingroup sensor
+ */
+SensorScheduler::SensorScheduler(void) :
+  count(0)
+{
+}
+
+/*
+ * Finds the entry for a sensor, or NULL if it hasn't been added
+ */
+_scheduler_entry_t * SensorScheduler::find(Sensor & sensor) {
+  for (uint8_t i = 0; i < this->count; ++i) {
+    if (this->entries[i].sensor == &sensor) {
+      return &(this->entries[i]);
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * Orders the entries by mux channel, keeping the order sensors were added in
+ * within each channel, so run() only switches the mux once per channel
+ */
+void SensorScheduler::sort(void) {
+  _scheduler_entry_t entry;
+  uint8_t j;
+
+  for (uint8_t i = 1; i < this->count; ++i) {
+    entry = this->entries[i];
+
+    for (j = i; j > 0 &&
+         this->entries[j - 1].sensor->getBusChannel() > entry.sensor->getBusChannel(); --j) {
+      this->entries[j] = this->entries[j - 1];
+    }
+    this->entries[j] = entry;
+  }
+}
+
+/**
+ * @brief   Adds a sensor to be sampled every `period` ms
+ * @ingroup sensor
+ *
+ * The first reading is started on the next call to `run()`. Adding a sensor
+ * that is already scheduled updates its period and callback. A period of 0
+ * with a sensor using `attachDataReady()` reads every new sample.
+ *
+ * @param   sensor Initialized sensor to sample
+ * @param   period ms between the start of each reading
+ * @param   callback Function called with the sensor when a reading finishes and
+ *                   its report policy (see Sensor::setReportPolicy) lets it through
+ *                   (may be NULL)
+ *
+ * @retval  true  Sensor was added
+ * @retval  false The scheduler is full (see SCHEDULER_MAX_SENSORS)
+ */
+boolean SensorScheduler::add(Sensor & sensor, unsigned long period, sensor_callback_t callback) {
+  _scheduler_entry_t * entry = this->find(sensor);
+
+  if (entry == NULL) {
+    if (this->count >= SCHEDULER_MAX_SENSORS) {
+      return false;
+    }
+    entry = &(this->entries[this->count++]);
+    entry->sensor = &sensor;
+  }
+
+  entry->callback = callback;
+  entry->period = period;
+  entry->due = millis();
+  this->sort();
+  return true;
+}
+
+/**
+ * @brief   Starts every added sensor, detecting the board and scanning the bus
+ *          just once (see beginAll())
+ * @ingroup sensor
+ *
+ * @retval  true  Every sensor initialized
+ * @retval  false At least one sensor failed to initialize
+ */
+boolean SensorScheduler::beginAll(boolean useCache) {
+  boolean ok = true;
+
+  detectBoard(useCache);
+
+  // Channels may have been set since the sensors were added
+  this->sort();
+
+  for (uint8_t i = 0; i < this->count; ++i) {
+    if (!this->entries[i].sensor->begin()) {
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+/**
+ * @brief   Stops sampling a sensor
+ * @ingroup sensor
+ *
+ * @retval  true  Sensor was removed
+ * @retval  false Sensor wasn't scheduled
+ */
+boolean SensorScheduler::remove(Sensor & sensor) {
+  _scheduler_entry_t * entry = this->find(sensor);
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  // Shift the rest down to keep them in channel order
+  this->count--;
+  for (; entry < this->entries + this->count; ++entry) {
+    *entry = *(entry + 1);
+  }
+  return true;
+}
+
+/**
+ * @brief   Changes how often a scheduled sensor is sampled
+ * @ingroup sensor
+ *
+ * @param   sensor Scheduled sensor
+ * @param   period ms between the start of each reading
+ *
+ * @retval  true  Period was changed
+ * @retval  false Sensor wasn't scheduled
+ */
+boolean SensorScheduler::setPeriod(Sensor & sensor, unsigned long period) {
+  _scheduler_entry_t * entry = this->find(sensor);
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  entry->period = period;
+  return true;
+}
+
+/**
+ * @brief   Starts readings that are due and collects readings that have finished
+ * @ingroup sensor
+ *
+ * Never waits on a sensor conversion. If a sensor falls more than a full
+ * period behind (e.g. its conversion takes longer than its period), the
+ * missed samples are skipped rather than taken back to back.
+ */
+void SensorScheduler::run(void) {
+  _scheduler_entry_t * entry;
+  unsigned long now;
+
+  for (uint8_t i = 0; i < this->count; ++i) {
+    entry = &(this->entries[i]);
+    now = millis();
+
+    if (!entry->sensor->isReading() && (long) (now - entry->due) >= 0) {
+      if (!entry->sensor->startRead()) {
+        continue;
+      }
+
+      entry->due += entry->period;
+      if ((long) (now - entry->due) >= 0) {
+        entry->due = now + entry->period;
+      }
+    }
+
+    if (entry->sensor->poll() && entry->callback != NULL && entry->sensor->reportDue()) {
+      entry->callback(*(entry->sensor));
+    }
+  }
+}
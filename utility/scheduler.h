@@ -0,0 +1,88 @@
+/**
+ * @file   scheduler.h
+ * @date   October 14, 2026
+ * @brief  Cooperative scheduler that samples each sensor at its own rate
+ *         using the split-phase (startRead/poll) sensor reads.
+ */
+
+#ifndef ARDUSAT_SCHEDULER_H_
+#define ARDUSAT_SCHEDULER_H_
+
+#include <Arduino.h>
+
+class Sensor;
+
+/**
+ * Maximum number of sensors a single scheduler can hold
+ */
+#ifndef SCHEDULER_MAX_SENSORS
+#define SCHEDULER_MAX_SENSORS 10
+#endif
+
+/**
+ * Called by the scheduler each time the sensor finishes a new reading
+ */
+typedef void (*sensor_callback_t)(Sensor & sensor);
+
+typedef struct {
+  Sensor * sensor;
+  sensor_callback_t callback;
+  unsigned long period;
+  unsigned long due;
+} _scheduler_entry_t;
+
+/**************************************************************************//**
+ * @class SensorScheduler
+ * @ingroup sensor
+ *
+ * @brief Samples each added sensor at its own period without blocking
+ *
+ * Readings are started when they are due and collected when the sensor is
+ * ready, so a slow conversion on one sensor (e.g. a 700 ms RGBLight
+ * integration) doesn't hold up the others. `run()` must be called often,
+ * ideally every time through `loop()`.
+ *
+ * Sensors behind an I2C mux (see Sensor::setBusChannel) are kept in channel
+ * order, so each pass reads all of the sensors due on one channel before
+ * switching to the next, rather than switching the mux for every sensor.
+ * Raise SCHEDULER_MAX_SENSORS for larger arrays of sensors.
+ *
+ * Example Usage:
+ * @code
+ *     SensorScheduler scheduler;
+ *
+ *     void printSample(Sensor & sensor) {
+ *       Serial.println(sensor.toCSV("sample"));
+ *     }
+ *
+ *     void setup(void) {
+ *       gyro.begin();
+ *       press.begin();
+ *       scheduler.add(gyro, 10, printSample);    // 100 Hz
+ *       scheduler.add(press, 1000, printSample); // 1 Hz
+ *     }
+ *
+ *     void loop(void) {
+ *       scheduler.run();
+ *     }
+ * @endcode
+ *****************************************************************************/
+class SensorScheduler {
+  protected:
+    _scheduler_entry_t entries[SCHEDULER_MAX_SENSORS];
+    uint8_t count;
+
+    _scheduler_entry_t * find(Sensor & sensor);
+    void sort(void);
+
+  public:
+    SensorScheduler(void);
+
+    boolean add(Sensor & sensor, unsigned long period, sensor_callback_t callback);
+    boolean beginAll(boolean useCache=false);
+    boolean remove(Sensor & sensor);
+    boolean setPeriod(Sensor & sensor, unsigned long period);
+    void run(void);
+};
+
+#endif /* ARDUSAT_SCHEDULER_H_ */
@@ -0,0 +1,235 @@
+/**
+ * @file   sd_sink.h
+ * @date   October 14, 2026
+ * @brief  Sink that logs to an SD card file a whole 512 byte block at a time
+ *
+ * Writing each record to a File straight away makes the SD library read,
+ * modify and write back a sector, and update the FAT and directory entry, for
+ * every few bytes, with stalls of 100 ms or more. SDBlockSink collects records
+ * in RAM and only writes whole, block aligned sectors, which go straight to
+ * the card. On a preallocated (contiguous) file there are no FAT updates while
+ * logging either, and the directory entry is only updated every few blocks.
+ *
+ * This header isn't included by ArdusatSDK.h so that sketches that don't log
+ * to SD don't need an SD library. It works with the File classes of the SdFat
+ * library (version 2); `preallocate()` and `close()` need SdFat's preAllocate
+ * and truncate.
+ */
+
+#ifndef ARDUSAT_SD_SINK_H_
+#define ARDUSAT_SD_SINK_H_
+
+#include <string.h>
+#include <utility/output_sink.h>
+
+/**
+ * SD cards are written a 512 byte sector at a time
+ */
+#define SD_SINK_BLOCK_SIZE 512
+
+/**
+ * Blocks written between directory entry updates. Records in blocks written
+ * since the last update can be lost on power loss.
+ */
+#ifndef SD_SINK_SYNC_BLOCKS
+#define SD_SINK_SYNC_BLOCKS 8
+#endif
+
+/**************************************************************************//**
+ * @class SDBlockSink
+ * @ingroup sensor
+ *
+ * @brief Sink that buffers records and writes them to a file in whole blocks
+ *
+ * The file must be open for writing and empty, so that every block written is
+ * sector aligned. Uses SD_SINK_BLOCK_SIZE bytes of RAM for the block.
+ *
+ * Example Usage:
+ * @code
+ *     SdFat sd;
+ *     FsFile file;
+ *     SDBlockSink<FsFile> log(file);
+ *
+ *     void setup(void) {
+ *       sd.begin(10);
+ *       file.open("log.csv", O_WRONLY | O_CREAT | O_TRUNC);
+ *       log.preallocate(1048576UL);   // 1 MB, contiguous
+ *       accel.begin();
+ *     }
+ *
+ *     void loop(void) {
+ *       accel.read();
+ *       accel.writeCSV(log, "accel");
+ *     }
+ * @endcode
+ *
+ * Up to a block of records is only held in RAM until the block fills. Call
+ * `close()` to write it out and trim the file to the data logged.
+ *****************************************************************************/
+template <class FileType>
+class SDBlockSink : public OutputSink {
+  protected:
+    FileType & file;
+    uint8_t block[SD_SINK_BLOCK_SIZE];
+    uint16_t length;
+    uint8_t syncInterval;
+    uint8_t unsynced;
+    boolean preallocated;
+    uint32_t blockCount;
+    unsigned int errorCount;
+
+    /*
+     * Writes out the buffered block, complete or not
+     */
+    boolean writeBlock(void) {
+      boolean ok = true;
+
+      if (this->length > 0) {
+        if (this->file.write(this->block, this->length) != this->length) {
+          this->errorCount++;
+          ok = false;
+        }
+        this->length = 0;
+        this->blockCount++;
+        this->unsynced++;
+      }
+      return ok;
+    }
+
+    /*
+     * Writes out a full block, updating the directory entry if it's due
+     */
+    void blockFull(void) {
+      this->writeBlock();
+
+      if (this->unsynced >= this->syncInterval) {
+        this->sync();
+      }
+    }
+
+  public:
+    /**
+     * @param file open, empty file to log to
+     * @param syncInterval blocks written between directory entry updates
+     */
+    SDBlockSink(FileType & file, uint8_t syncInterval = SD_SINK_SYNC_BLOCKS) :
+      file(file),
+      length(0),
+      syncInterval(syncInterval == 0 ? 1 : syncInterval),
+      unsynced(0),
+      preallocated(false),
+      blockCount(0),
+      errorCount(0)
+    {
+    }
+
+    /**
+     * Reserves contiguous space for the file up front, so no clusters have to
+     * be allocated while logging. Logging past the end still works, but
+     * allocates as it goes.
+     *
+     * @param size bytes to reserve
+     *
+     * @return true if the space was reserved
+     */
+    boolean preallocate(uint32_t size) {
+      this->preallocated = this->file.preAllocate(size);
+
+      if (!this->preallocated) {
+        this->errorCount++;
+      }
+      return this->preallocated;
+    }
+
+    size_t write(uint8_t b) {
+      this->block[this->length++] = b;
+
+      if (this->length >= SD_SINK_BLOCK_SIZE) {
+        this->blockFull();
+      }
+      return 1;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) {
+      size_t left = size;
+
+      while (left > 0) {
+        size_t n = SD_SINK_BLOCK_SIZE - this->length;
+
+        if (n > left) {
+          n = left;
+        }
+        memcpy(this->block + this->length, buffer, n);
+        this->length += n;
+        buffer += n;
+        left -= n;
+
+        if (this->length >= SD_SINK_BLOCK_SIZE) {
+          this->blockFull();
+        }
+      }
+      return size;
+    }
+
+    using Print::write;
+
+    /**
+     * Updates the directory entry now. The partly filled block stays in RAM,
+     * so the blocks after it stay aligned.
+     *
+     * @return true if the file was synced
+     */
+    boolean sync(void) {
+      if (this->unsynced == 0) {
+        return true;
+      }
+
+      this->unsynced = 0;
+      if (!this->file.sync()) {
+        this->errorCount++;
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * Writes out the partly filled block, trims a preallocated file to the data
+     * logged, and closes the file. The sink can be used again once the file is
+     * reopened.
+     *
+     * @return true if everything was written
+     */
+    boolean close(void) {
+      boolean ok = this->writeBlock();
+
+      if (this->preallocated && !this->file.truncate()) {
+        this->errorCount++;
+        ok = false;
+      }
+      if (!this->file.close()) {
+        this->errorCount++;
+        ok = false;
+      }
+
+      this->preallocated = false;
+      this->blockCount = 0;
+      this->unsynced = 0;
+      return ok;
+    }
+
+    /**
+     * @return bytes logged since the file was opened, including those still in RAM
+     */
+    uint32_t size(void) {
+      return this->blockCount * SD_SINK_BLOCK_SIZE + this->length;
+    }
+
+    /**
+     * @return failed writes and syncs. The data in a failed block is lost.
+     */
+    unsigned int errors(void) {
+      return this->errorCount;
+    }
+};
+
+#endif /* ARDUSAT_SD_SINK_H_ */
@@ -6,11 +6,16 @@
  *         serial libraries under one interface.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 
 #include <ArdusatSDK.h>
 #include "serial.h"
 
+#if ARDUSAT_STATIC_BUFFERS
+#include <new.h>
+#endif
+
 const char no_software_params_err_msg[] PROGMEM = "You specified a software serial mode but didn't specify transmit/recieve pins!";
 
 #define send_to_serial(function) \
@@ -37,6 +42,7 @@ ArdusatSerial::ArdusatSerial(serialMode mode)
 {
   // If no other arguments (pins) are given, we can't initialize a software serial 
   // connection.
+  _soft_serial = NULL;
   _mode = SERIAL_MODE_HARDWARE;
 }
 
@@ -46,9 +52,15 @@ ArdusatSerial::ArdusatSerial(serialMode mode)
 ArdusatSerial::ArdusatSerial(serialMode mode, unsigned char softwareReceivePin,
                              unsigned char softwareTransmitPin, bool softwareInverseLogic)
 {
+  _soft_serial = NULL;
   if (mode == SERIAL_MODE_SOFTWARE || mode == SERIAL_MODE_HARDWARE_AND_SOFTWARE) {
+#if ARDUSAT_STATIC_BUFFERS
+    _soft_serial = new (_soft_serial_storage) SoftwareSerial(softwareReceivePin, softwareTransmitPin,
+                                                             softwareInverseLogic);
+#else
     _soft_serial = new SoftwareSerial(softwareReceivePin, softwareTransmitPin,
                                       softwareInverseLogic);
+#endif
   }
 
   _mode = mode;
@@ -57,7 +69,11 @@ ArdusatSerial::ArdusatSerial(serialMode mode, unsigned char softwareReceivePin,
 ArdusatSerial::~ArdusatSerial()
 {
   if (_soft_serial != NULL) {
+#if ARDUSAT_STATIC_BUFFERS
+    _soft_serial->~SoftwareSerial();
+#else
     delete _soft_serial;
+#endif
   }
 }
 
@@ -108,6 +124,7 @@ void ArdusatSerial::flush()
 
 size_t ArdusatSerial::write(unsigned char b) {
   size_t ret = 1;
+  TIMING_START(start);
 
   if (_soft_serial != NULL && 
       ( _mode == SERIAL_MODE_SOFTWARE || _mode == SERIAL_MODE_HARDWARE_AND_SOFTWARE)) {
@@ -118,5 +135,135 @@ size_t ArdusatSerial::write(unsigned char b) {
     ret = ret & Serial.write(b);
   }
 
+  TIMING_END(ArdusatTiming.serial, start);
   return ret;
 }
+
+/**
+ * Gets the number of bytes that can be written to every port in use without
+ * blocking.
+ *
+ * Software serial only has a transmit buffer when the SDK is built with
+ * _SS_ASYNC_TX (see SoftwareSerial.h); otherwise every software serial byte
+ * blocks and this returns 0 in the software modes (writeAsync() then writes
+ * one byte at a time).
+ *
+ * @return number of bytes that can be written without blocking
+ */
+int ArdusatSerial::availableForWrite()
+{
+  int ret = INT_MAX;
+
+  if (_mode == SERIAL_MODE_HARDWARE || _mode == SERIAL_MODE_HARDWARE_AND_SOFTWARE) {
+    ret = min(ret, Serial.availableForWrite());
+  }
+
+  if (_mode == SERIAL_MODE_SOFTWARE || _mode == SERIAL_MODE_HARDWARE_AND_SOFTWARE) {
+    ret = _soft_serial != NULL ? min(ret, _soft_serial->availableForWrite()) : 0;
+  }
+
+  return ret;
+}
+
+/**
+ * Writes as much of a buffer as fits in the transmit buffers without blocking.
+ * The rest is transmitted in the background while the sketch keeps running.
+ *
+ * Without _SS_ASYNC_TX, software serial has no transmit buffer, so in the
+ * software modes one byte is written (blocking for one byte time) whenever
+ * nothing would fit, and a retry loop still gets everything sent.
+ *
+ * Example Usage:
+ * @code
+ *     const char *pending = accel.readToJSON("accel");
+ *     size_t sent = 0, len = strlen(pending);
+ *
+ *     void loop() {
+ *       if (sent < len) {
+ *         sent += serialConnection.writeAsync((const uint8_t *) pending + sent, len - sent);
+ *       }
+ *       // ...keep sampling
+ *     }
+ * @endcode
+ *
+ * @param buffer bytes to write
+ * @param size number of bytes in buffer
+ *
+ * @return number of bytes written, the caller should retry the rest later
+ */
+size_t ArdusatSerial::writeAsync(const uint8_t *buffer, size_t size)
+{
+  int room = availableForWrite();
+
+  if (room < 0) {
+    room = 0;
+  }
+#if !_SS_ASYNC_TX
+  if (room == 0 && (_mode == SERIAL_MODE_SOFTWARE || _mode == SERIAL_MODE_HARDWARE_AND_SOFTWARE)) {
+    room = 1;
+  }
+#endif
+  if (size > (size_t) room) {
+    size = room;
+  }
+
+  return write(buffer, size);
+}
+
+/**
+ * Writes as much of a string as fits in the transmit buffers without blocking.
+ *
+ * @param str null terminated string to write
+ *
+ * @return number of characters written, the caller should retry the rest later
+ */
+size_t ArdusatSerial::writeAsync(const char *str)
+{
+  if (str == NULL) {
+    return 0;
+  }
+
+  return writeAsync((const uint8_t *) str, strlen(str));
+}
+
+/**
+ * Gets the number of received bytes that software serial had to drop because
+ * its RX buffer (_SS_MAX_RX_BUFF bytes, see SoftwareSerial.h) was full. Use this
+ * with peakAvailable() to size the RX buffer from real usage.
+ *
+ * @return dropped bytes since the last resetRXStats(), 0 without software serial
+ */
+uint16_t ArdusatSerial::droppedBytes()
+{
+  if (_soft_serial != NULL) {
+    return _soft_serial->droppedBytes();
+  }
+
+  return 0;
+}
+
+/**
+ * Gets the most bytes that have been waiting in the software serial RX buffer
+ * at once. Values close to _SS_MAX_RX_BUFF - 1 mean the buffer is too small or
+ * isn't read often enough.
+ *
+ * @return peak RX buffer level since the last resetRXStats(), 0 without software serial
+ */
+uint8_t ArdusatSerial::peakAvailable()
+{
+  if (_soft_serial != NULL) {
+    return _soft_serial->peakAvailable();
+  }
+
+  return 0;
+}
+
+/**
+ * Resets the counters returned by droppedBytes() and peakAvailable()
+ */
+void ArdusatSerial::resetRXStats()
+{
+  if (_soft_serial != NULL) {
+    _soft_serial->resetRXStats();
+  }
+}
@@ -12,6 +12,7 @@
 #include <inttypes.h>
 #include <Stream.h>
 
+#include <utility/config.h>
 #include "SoftwareSerial.h"
 
 typedef enum {
@@ -25,6 +26,11 @@ class ArdusatSerial : public Stream
   private:
     SoftwareSerial *_soft_serial; 
     serialMode _mode;
+#if ARDUSAT_STATIC_BUFFERS
+    // _soft_serial is constructed in here instead of on the heap
+    uint8_t _soft_serial_storage[sizeof(SoftwareSerial)]
+      __attribute__((aligned(__alignof__(SoftwareSerial))));
+#endif
 
   public:
     ArdusatSerial(serialMode mode);
@@ -41,6 +47,13 @@ class ArdusatSerial : public Stream
     virtual void flush();
 
     virtual size_t write(unsigned char);
+    virtual int availableForWrite();
+    size_t writeAsync(const uint8_t *buffer, size_t size);
+    size_t writeAsync(const char *str);
+
+    uint16_t droppedBytes();
+    uint8_t peakAvailable();
+    void resetRXStats();
     inline size_t write(unsigned long n) { return write((unsigned char)n); }
     inline size_t write(long n) { return write((unsigned char)n); }
     inline size_t write(unsigned int n) { return write((unsigned char)n); }
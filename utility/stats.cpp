@@ -0,0 +1,105 @@
+/**
+ * @file   stats.cpp
+ * @date   October 14, 2026
+ * @brief  Count, min, max, mean and variance of a window of raw samples
+ */
+
+#include <math.h>
+#include "stats.h"
+
+WindowStats::WindowStats(void)
+{
+  reset();
+}
+
+/**
+ * Starts a new window
+ */
+void WindowStats::reset(void)
+{
+  _n = 0;
+  _values = 0;
+  for (uint8_t i = 0; i < STATS_MAX_VALUES; ++i) {
+    _shift[i] = 0;
+    _min[i] = 0;
+    _max[i] = 0;
+    _sum[i] = 0;
+    _sumsq[i] = 0;
+  }
+}
+
+/**
+ * Adds one sample. The first sample of a window sets how many values each
+ * sample has; count is clamped to STATS_MAX_VALUES.
+ *
+ * @return false if the window is already full and the sample was dropped
+ */
+boolean WindowStats::add(const int16_t *values, uint8_t count)
+{
+  if (_n == STATS_MAX_SAMPLES) {
+    return false;
+  }
+
+  if (_n == 0) {
+    _values = count > STATS_MAX_VALUES ? STATS_MAX_VALUES : count;
+    for (uint8_t i = 0; i < _values; ++i) {
+      _shift[i] = values[i];
+      _min[i] = values[i];
+      _max[i] = values[i];
+    }
+  }
+
+  for (uint8_t i = 0; i < _values && i < count; ++i) {
+    int32_t d = (int32_t) values[i] - _shift[i];
+    uint32_t a = d < 0 ? -d : d;  // up to 65535, so its square fits in 32 bits
+
+    if (values[i] < _min[i]) {
+      _min[i] = values[i];
+    } else if (values[i] > _max[i]) {
+      _max[i] = values[i];
+    }
+    _sum[i] += d;
+    _sumsq[i] += a * a;
+  }
+
+  _n++;
+  return true;
+}
+
+/**
+ * @return mean of value i, in counts, or 0 with no samples
+ */
+float WindowStats::mean(uint8_t i)
+{
+  if (_n == 0) {
+    return 0;
+  }
+  return _shift[i] + (float) _sum[i] / _n;
+}
+
+/**
+ * @return sample variance of value i, in counts squared, or 0 with fewer than
+ *         2 samples
+ */
+float WindowStats::variance(uint8_t i)
+{
+  uint64_t sum, sq;
+
+  if (_n < 2) {
+    return 0;
+  }
+
+  // sumsq - sum^2 / n, subtracted before it's rounded to a float. It can't
+  // go negative, and |sum| < 2^32 so its square fits.
+  sum = _sum[i] < 0 ? -_sum[i] : _sum[i];
+  sq = sum * sum;
+  return ((float) (_sumsq[i] - sq / _n) - (float) (sq % _n) / _n) / (_n - 1);
+}
+
+/**
+ * @return sample standard deviation of value i, in counts
+ */
+float WindowStats::stddev(uint8_t i)
+{
+  return sqrt(variance(i));
+}
@@ -0,0 +1,75 @@
+/**
+ * @file   stats.h
+ * @date   October 14, 2026
+ * @brief  Count, min, max, mean and variance of a window of raw samples
+ *
+ * For long experiments a summary of each window of samples is often all that
+ * needs to be sent: sampling fast catches the variability, and only one record
+ * goes out per window. The samples are integer counts, and everything the
+ * window keeps is an exact integer sum, so adding a sample takes no floating
+ * point math at all.
+ */
+
+#ifndef ARDUSAT_STATS_H_
+#define ARDUSAT_STATS_H_
+
+#include <Arduino.h>
+
+/**
+ * Most values per sample (x, y and z, or red, green and blue)
+ */
+#define STATS_MAX_VALUES 3
+
+/**
+ * Most samples in one window; later samples are dropped
+ */
+#define STATS_MAX_SAMPLES 0xFFFF
+
+/**************************************************************************//**
+ * @class WindowStats
+ * @ingroup sensor
+ *
+ * @brief Accumulates summary statistics of up to 3 streams of raw counts
+ *
+ * Each stream keeps its first sample, and the sum and sum of squares of the
+ * samples' differences from it. The 64 bit sums are exact and can't overflow
+ * within a window, and variance() subtracts them in integers before rounding
+ * to a float, so there's no cancellation however far the mean is from zero.
+ *
+ * Example Usage:
+ * @code
+ *     WindowStats stats;
+ *     int16_t counts[3] = {gyro.rawX, gyro.rawY, gyro.rawZ};
+ *
+ *     stats.add(counts, 3);
+ *     ...
+ *     Serial.println(stats.mean(0) * gyro.rawScale());
+ *     stats.reset();
+ * @endcode
+ *****************************************************************************/
+class WindowStats {
+  public:
+    WindowStats(void);
+
+    boolean add(const int16_t *values, uint8_t count);
+    void reset(void);
+
+    uint16_t count(void) { return _n; }
+    uint8_t values(void) { return _values; }
+    int16_t minimum(uint8_t i) { return _min[i]; }
+    int16_t maximum(uint8_t i) { return _max[i]; }
+    float mean(uint8_t i);
+    float variance(uint8_t i);
+    float stddev(uint8_t i);
+
+  private:
+    uint16_t _n;
+    uint8_t _values;
+    int16_t _shift[STATS_MAX_VALUES];
+    int16_t _min[STATS_MAX_VALUES];
+    int16_t _max[STATS_MAX_VALUES];
+    int64_t _sum[STATS_MAX_VALUES];     // of value - _shift
+    uint64_t _sumsq[STATS_MAX_VALUES];  // of (value - _shift)^2
+};
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file   timing.cpp
+ * @date   October 14, 2026
+ * @brief  Optional micros() counters for the read, format and transmit phases
+ */
+
+#include <string.h>
+#include "timing.h"
+
+#if ARDUSAT_TIMING
+
+sdk_timing_t ArdusatTiming;
+
+/**
+ * Adds the time since start to a counter
+ *
+ * @param stat counter to add to
+ * @param start micros() at the start of the call
+ */
+void timingAdd(timing_stat_t *stat, unsigned long start)
+{
+  uint32_t elapsed = micros() - start;
+
+  if (stat->count < 0xFFFF) {
+    stat->count++;
+  }
+  stat->total += elapsed;
+  if (elapsed > stat->max) {
+    stat->max = elapsed;
+  }
+}
+
+/**
+ * Clears the bus and serial counters, e.g. after dumping them
+ */
+void resetTiming(void)
+{
+  memset(&ArdusatTiming, 0, sizeof(ArdusatTiming));
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file   timing.h
+ * @date   October 14, 2026
+ * @brief  Optional micros() counters for the read, format and transmit phases
+ *
+ * Only compiled in when the SDK is built with ARDUSAT_TIMING set to 1 (see
+ * utility/config.h). Otherwise the TIMING_ macros are empty and neither the
+ * counters nor the micros() calls exist.
+ */
+
+#ifndef ARDUSAT_TIMING_H_
+#define ARDUSAT_TIMING_H_
+
+#include <Arduino.h>
+#include <utility/config.h>
+
+/**
+ * Time spent in one kind of call. The total wraps after about 71 minutes, so
+ * dump and reset the counters more often than that.
+ */
+typedef struct {
+  uint16_t count;  /* calls timed */
+  uint32_t total;  /* us spent in them */
+  uint32_t max;    /* us spent in the longest */
+} timing_stat_t;
+
+/**
+ * Timing of one sensor, see Sensor::timing
+ */
+typedef struct {
+  timing_stat_t read;    /* readSensor(), and each step of a split-phase read */
+  timing_stat_t format;  /* toCSV/toJSON/toBinary, through the read/write helpers */
+} sensor_timing_t;
+
+/**
+ * Timing of the shared bus and serial port, see ArdusatTiming. The bytes sent
+ * on the bus are counted by ArdusatBus.byteCount().
+ */
+typedef struct {
+  timing_stat_t bus;     /* readFromRegAddr/writeToRegAddr/runRegOps */
+  timing_stat_t serial;  /* ArdusatSerial::write, one call per byte */
+} sdk_timing_t;
+
+#if ARDUSAT_TIMING
+extern sdk_timing_t ArdusatTiming;
+
+void timingAdd(timing_stat_t *stat, unsigned long start);
+void resetTiming(void);
+
+#define TIMING_START(var) unsigned long var = micros()
+#define TIMING_END(stat, var) timingAdd(&(stat), var)
+#else
+#define TIMING_START(var)
+#define TIMING_END(stat, var)
+#endif
+
+#endif